@@ -0,0 +1,369 @@
+unsigned char spin_bin[] = {
+  0x55, 0x89, 0xe5, 0x83, 0xec, 0x08, 0xc7, 0x05, 0x34, 0x11, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0xc6, 0x05, 0x38, 0x11, 0x00, 0x00, 0x00, 0xe8,
+  0x67, 0x02, 0x00, 0x00, 0x84, 0xc0, 0x74, 0x07, 0xb8, 0x01, 0x00, 0x00,
+  0x00, 0xeb, 0x05, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x83, 0xec, 0x0c, 0x50,
+  0xe8, 0xb4, 0x02, 0x00, 0x00, 0x83, 0xc4, 0x10, 0x83, 0xec, 0x0c, 0x68,
+  0x00, 0x04, 0x00, 0x00, 0xe8, 0x81, 0x01, 0x00, 0x00, 0x83, 0xc4, 0x10,
+  0xa3, 0x2c, 0x11, 0x00, 0x00, 0xa1, 0x2c, 0x11, 0x00, 0x00, 0x85, 0xc0,
+  0x74, 0x07, 0xb8, 0x00, 0x04, 0x00, 0x00, 0xeb, 0x05, 0xb8, 0x00, 0x00,
+  0x00, 0x00, 0xa3, 0x30, 0x11, 0x00, 0x00, 0x83, 0xec, 0x08, 0x6a, 0x00,
+  0x6a, 0x00, 0xe8, 0x4d, 0x00, 0x00, 0x00, 0x83, 0xc4, 0x10, 0x83, 0xec,
+  0x0c, 0x50, 0xe8, 0x0e, 0x01, 0x00, 0x00, 0x83, 0xc4, 0x10, 0x90, 0xc9,
+  0xc3, 0x66, 0x90, 0x66, 0x90, 0x66, 0x90, 0x66, 0x90, 0x66, 0x90, 0x90,
+  0x83, 0xec, 0x24, 0x8d, 0x44, 0x24, 0x10, 0x50, 0x6a, 0x01, 0xe8, 0x60,
+  0x01, 0x00, 0x00, 0xb8, 0x83, 0xde, 0x1b, 0x43, 0xf7, 0x64, 0x24, 0x1c,
+  0x69, 0x4c, 0x24, 0x18, 0xe8, 0x03, 0x00, 0x00, 0x83, 0xc4, 0x2c, 0xc1,
+  0xea, 0x12, 0x8d, 0x04, 0x11, 0xc3, 0x66, 0x90, 0x66, 0x90, 0x66, 0x90,
+  0x8d, 0x4c, 0x24, 0x04, 0x83, 0xe4, 0xf0, 0xff, 0x71, 0xfc, 0x55, 0x89,
+  0xe5, 0x56, 0x53, 0xbb, 0xa2, 0x8c, 0xd6, 0x92, 0x51, 0x83, 0xec, 0x0c,
+  0xe8, 0xb3, 0xff, 0xff, 0xff, 0xb9, 0x80, 0xf0, 0xfa, 0x02, 0x89, 0xc6,
+  0x8d, 0x74, 0x26, 0x00, 0x89, 0xda, 0xc1, 0xe2, 0x0d, 0x31, 0xda, 0x89,
+  0xd0, 0xc1, 0xe8, 0x11, 0x31, 0xd0, 0x89, 0xc3, 0xc1, 0xe3, 0x05, 0x31,
+  0xc3, 0x83, 0xe9, 0x01, 0x75, 0xe6, 0xe8, 0x89, 0xff, 0xff, 0xff, 0x83,
+  0xec, 0x0c, 0x89, 0xc2, 0x53, 0x29, 0xf2, 0x52, 0x50, 0x56, 0x68, 0x10,
+  0x0f, 0x00, 0x00, 0xe8, 0xc7, 0x02, 0x00, 0x00, 0x83, 0xc4, 0x20, 0x8d,
+  0x65, 0xf4, 0x31, 0xc0, 0x59, 0x5b, 0x5e, 0x5d, 0x8d, 0x61, 0xfc, 0xc3,
+  0x55, 0x89, 0xe5, 0x57, 0x56, 0x53, 0x83, 0xec, 0x1c, 0x83, 0x7d, 0x08,
+  0x10, 0x74, 0x0e, 0xa1, 0x34, 0x11, 0x00, 0x00, 0x85, 0xc0, 0x74, 0x05,
+  0xe8, 0xae, 0x01, 0x00, 0x00, 0xa1, 0x28, 0x11, 0x00, 0x00, 0x83, 0xf8,
+  0x01, 0x75, 0x1a, 0x8b, 0x45, 0x08, 0x8b, 0x5d, 0x0c, 0x8b, 0x75, 0x10,
+  0x8b, 0x7d, 0x14, 0x89, 0xe1, 0xba, 0x68, 0x01, 0x00, 0x00, 0x0f, 0x34,
+  0x89, 0x45, 0xe4, 0xeb, 0x15, 0x8b, 0x45, 0x08, 0x8b, 0x55, 0x0c, 0x8b,
+  0x4d, 0x10, 0x8b, 0x7d, 0x14, 0x89, 0xd3, 0x89, 0xce, 0xcd, 0x30, 0x89,
+  0x45, 0xe4, 0x8b, 0x45, 0xe4, 0x83, 0xc4, 0x1c, 0x5b, 0x5e, 0x5f, 0x5d,
+  0xc3, 0x55, 0x89, 0xe5, 0x83, 0xec, 0x18, 0xc7, 0x45, 0xec, 0x00, 0x00,
+  0x00, 0x00, 0xc7, 0x45, 0xf0, 0x00, 0x00, 0x00, 0x00, 0xc7, 0x45, 0xf4,
+  0x00, 0x00, 0x00, 0x00, 0x8b, 0x45, 0x08, 0x89, 0x45, 0xec, 0x8b, 0x4d,
+  0xf4, 0x8b, 0x55, 0xf0, 0x8b, 0x45, 0xec, 0x51, 0x52, 0x50, 0x6a, 0x02,
+  0xe8, 0x6b, 0xff, 0xff, 0xff, 0x83, 0xc4, 0x10, 0xc9, 0xc3, 0x55, 0x89,
+  0xe5, 0x83, 0xec, 0x18, 0xc7, 0x45, 0xec, 0x00, 0x00, 0x00, 0x00, 0xc7,
+  0x45, 0xf0, 0x00, 0x00, 0x00, 0x00, 0xc7, 0x45, 0xf4, 0x00, 0x00, 0x00,
+  0x00, 0x8b, 0x45, 0x08, 0x89, 0x45, 0xec, 0x8b, 0x4d, 0xf4, 0x8b, 0x55,
+  0xf0, 0x8b, 0x45, 0xec, 0x51, 0x52, 0x50, 0x6a, 0x04, 0xe8, 0x32, 0xff,
+  0xff, 0xff, 0x83, 0xc4, 0x10, 0xc9, 0xc3, 0x55, 0x89, 0xe5, 0x83, 0xec,
+  0x18, 0xc7, 0x45, 0xec, 0x00, 0x00, 0x00, 0x00, 0xc7, 0x45, 0xf0, 0x00,
+  0x00, 0x00, 0x00, 0xc7, 0x45, 0xf4, 0x00, 0x00, 0x00, 0x00, 0x8b, 0x45,
+  0x08, 0x89, 0x45, 0xec, 0x8b, 0x45, 0x0c, 0x89, 0x45, 0xf4, 0x8b, 0x4d,
+  0xf4, 0x8b, 0x55, 0xf0, 0x8b, 0x45, 0xec, 0x51, 0x52, 0x50, 0x6a, 0x0c,
+  0xe8, 0xf3, 0xfe, 0xff, 0xff, 0x83, 0xc4, 0x10, 0xc9, 0xc3, 0x55, 0x89,
+  0xe5, 0x83, 0xec, 0x18, 0xc7, 0x45, 0xec, 0x00, 0x00, 0x00, 0x00, 0xc7,
+  0x45, 0xf0, 0x00, 0x00, 0x00, 0x00, 0xc7, 0x45, 0xf4, 0x00, 0x00, 0x00,
+  0x00, 0x8b, 0x45, 0x08, 0x89, 0x45, 0xec, 0x8b, 0x45, 0x0c, 0x89, 0x45,
+  0xf0, 0x8b, 0x45, 0x10, 0x89, 0x45, 0xf4, 0x8b, 0x4d, 0xf4, 0x8b, 0x55,
+  0xf0, 0x8b, 0x45, 0xec, 0x51, 0x52, 0x50, 0x6a, 0x10, 0xe8, 0xae, 0xfe,
+  0xff, 0xff, 0x83, 0xc4, 0x10, 0xc9, 0xc3, 0x55, 0x89, 0xe5, 0x53, 0x83,
+  0xec, 0x10, 0xb8, 0x01, 0x00, 0x00, 0x00, 0x0f, 0xa2, 0x89, 0x45, 0xf8,
+  0x89, 0x5d, 0xf4, 0x89, 0x4d, 0xf0, 0x89, 0x55, 0xec, 0x8b, 0x45, 0xec,
+  0x25, 0x00, 0x08, 0x00, 0x00, 0x85, 0xc0, 0x75, 0x07, 0xb8, 0x00, 0x00,
+  0x00, 0x00, 0xeb, 0x34, 0x8b, 0x45, 0xf8, 0xc1, 0xe8, 0x08, 0x83, 0xe0,
+  0x0f, 0x83, 0xf8, 0x06, 0x75, 0x19, 0x8b, 0x45, 0xf8, 0xc1, 0xe8, 0x04,
+  0x83, 0xe0, 0x0f, 0x83, 0xf8, 0x02, 0x77, 0x0b, 0x8b, 0x45, 0xf8, 0x83,
+  0xe0, 0x0f, 0x83, 0xf8, 0x02, 0x76, 0x07, 0xb8, 0x01, 0x00, 0x00, 0x00,
+  0xeb, 0x05, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x90, 0x8b, 0x5d, 0xfc, 0xc9,
+  0xc3, 0x55, 0x89, 0xe5, 0x8b, 0x45, 0x08, 0xa3, 0x28, 0x11, 0x00, 0x00,
+  0x90, 0x5d, 0xc3, 0x55, 0x89, 0xe5, 0x83, 0xec, 0x08, 0xa1, 0x34, 0x11,
+  0x00, 0x00, 0x85, 0xc0, 0x74, 0x24, 0x8b, 0x15, 0x34, 0x11, 0x00, 0x00,
+  0xa1, 0x2c, 0x11, 0x00, 0x00, 0x83, 0xec, 0x04, 0x52, 0x50, 0x6a, 0x01,
+  0xe8, 0x21, 0xff, 0xff, 0xff, 0x83, 0xc4, 0x10, 0xc7, 0x05, 0x34, 0x11,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc6, 0x05, 0x38, 0x11, 0x00, 0x00,
+  0x00, 0x90, 0xc9, 0xc3, 0x55, 0x89, 0xe5, 0x56, 0x53, 0x83, 0xec, 0x10,
+  0x8b, 0x45, 0x08, 0x89, 0x45, 0xf0, 0x8b, 0x45, 0xf0, 0x8b, 0x40, 0x04,
+  0x85, 0xc0, 0x75, 0x15, 0x83, 0xec, 0x04, 0xff, 0x75, 0x10, 0xff, 0x75,
+  0x0c, 0x6a, 0x01, 0xe8, 0xe2, 0xfe, 0xff, 0xff, 0x83, 0xc4, 0x10, 0xeb,
+  0x7b, 0xc7, 0x45, 0xf4, 0x00, 0x00, 0x00, 0x00, 0xeb, 0x6a, 0x8b, 0x45,
+  0xf0, 0x8b, 0x50, 0x08, 0x8b, 0x45, 0xf0, 0x8b, 0x40, 0x04, 0x39, 0xc2,
+  0x75, 0x05, 0xe8, 0x78, 0xff, 0xff, 0xff, 0x8b, 0x55, 0x0c, 0x8b, 0x45,
+  0xf4, 0x8d, 0x1c, 0x02, 0x8b, 0x45, 0xf0, 0x8b, 0x30, 0x8b, 0x45, 0xf0,
+  0x8b, 0x40, 0x08, 0x8d, 0x48, 0x01, 0x8b, 0x55, 0xf0, 0x89, 0x4a, 0x08,
+  0x8d, 0x14, 0x06, 0x0f, 0xb6, 0x03, 0x88, 0x02, 0x8b, 0x45, 0xf0, 0x0f,
+  0xb6, 0x40, 0x0c, 0x84, 0xc0, 0x75, 0x0f, 0x8b, 0x55, 0x0c, 0x8b, 0x45,
+  0xf4, 0x01, 0xd0, 0x0f, 0xb6, 0x00, 0x3c, 0x0a, 0x75, 0x07, 0xba, 0x01,
+  0x00, 0x00, 0x00, 0xeb, 0x05, 0xba, 0x00, 0x00, 0x00, 0x00, 0x8b, 0x45,
+  0xf0, 0x88, 0x50, 0x0c, 0x83, 0x45, 0xf4, 0x01, 0x8b, 0x45, 0xf4, 0x3b,
+  0x45, 0x10, 0x72, 0x8e, 0x8d, 0x65, 0xf8, 0x5b, 0x5e, 0x5d, 0xc3, 0x55,
+  0x89, 0xe5, 0x83, 0xec, 0x18, 0x8d, 0x45, 0x0c, 0x89, 0x45, 0xf4, 0x8b,
+  0x45, 0xf4, 0x50, 0xff, 0x75, 0x08, 0x68, 0x2c, 0x11, 0x00, 0x00, 0x68,
+  0x34, 0x03, 0x00, 0x00, 0xe8, 0x1a, 0x06, 0x00, 0x00, 0x83, 0xc4, 0x10,
+  0x0f, 0xb6, 0x05, 0x38, 0x11, 0x00, 0x00, 0x84, 0xc0, 0x74, 0x05, 0xe8,
+  0xdf, 0xfe, 0xff, 0xff, 0x90, 0xc9, 0xc3, 0x55, 0x89, 0xe5, 0x8b, 0x45,
+  0x08, 0xc6, 0x00, 0x00, 0x8b, 0x45, 0x08, 0xc6, 0x40, 0x01, 0x00, 0x8b,
+  0x45, 0x08, 0xc6, 0x40, 0x02, 0x00, 0x8b, 0x45, 0x08, 0xc7, 0x40, 0x04,
+  0x00, 0x00, 0x00, 0x00, 0x8b, 0x45, 0x08, 0xc7, 0x40, 0x08, 0xff, 0xff,
+  0xff, 0xff, 0x8b, 0x45, 0x08, 0xc7, 0x40, 0x0c, 0x00, 0x00, 0x00, 0x00,
+  0x83, 0x45, 0x10, 0x01, 0x8b, 0x55, 0x0c, 0x8b, 0x45, 0x10, 0x01, 0xd0,
+  0x0f, 0xb6, 0x00, 0x3c, 0x2d, 0x75, 0x09, 0x8b, 0x45, 0x08, 0xc6, 0x40,
+  0x01, 0x01, 0xeb, 0x16, 0x8b, 0x55, 0x0c, 0x8b, 0x45, 0x10, 0x01, 0xd0,
+  0x0f, 0xb6, 0x00, 0x3c, 0x30, 0x75, 0x0d, 0x8b, 0x45, 0x08, 0xc6, 0x40,
+  0x02, 0x01, 0x83, 0x45, 0x10, 0x01, 0xeb, 0xcc, 0x90, 0xeb, 0x2e, 0x8b,
+  0x45, 0x08, 0x8b, 0x50, 0x04, 0x89, 0xd0, 0xc1, 0xe0, 0x02, 0x01, 0xd0,
+  0x01, 0xc0, 0x89, 0xc1, 0x8b, 0x55, 0x0c, 0x8b, 0x45, 0x10, 0x01, 0xd0,
+  0x0f, 0xb6, 0x00, 0x0f, 0xbe, 0xc0, 0x01, 0xc8, 0x8d, 0x50, 0xd0, 0x8b,
+  0x45, 0x08, 0x89, 0x50, 0x04, 0x83, 0x45, 0x10, 0x01, 0x8b, 0x55, 0x0c,
+  0x8b, 0x45, 0x10, 0x01, 0xd0, 0x0f, 0xb6, 0x00, 0x3c, 0x2f, 0x7e, 0x0f,
+  0x8b, 0x55, 0x0c, 0x8b, 0x45, 0x10, 0x01, 0xd0, 0x0f, 0xb6, 0x00, 0x3c,
+  0x39, 0x7e, 0xb4, 0x8b, 0x55, 0x0c, 0x8b, 0x45, 0x10, 0x01, 0xd0, 0x0f,
+  0xb6, 0x00, 0x3c, 0x2e, 0x75, 0x63, 0x8b, 0x45, 0x08, 0xc7, 0x40, 0x08,
+  0x00, 0x00, 0x00, 0x00, 0x83, 0x45, 0x10, 0x01, 0xeb, 0x2f, 0x8b, 0x45,
+  0x08, 0x8b, 0x50, 0x08, 0x89, 0xd0, 0xc1, 0xe0, 0x02, 0x01, 0xd0, 0x01,
+  0xc0, 0x89, 0xc1, 0x8b, 0x55, 0x0c, 0x8b, 0x45, 0x10, 0x01, 0xd0, 0x0f,
+  0xb6, 0x00, 0x0f, 0xbe, 0xc0, 0x83, 0xe8, 0x30, 0x8d, 0x14, 0x01, 0x8b,
+  0x45, 0x08, 0x89, 0x50, 0x08, 0x83, 0x45, 0x10, 0x01, 0x8b, 0x55, 0x0c,
+  0x8b, 0x45, 0x10, 0x01, 0xd0, 0x0f, 0xb6, 0x00, 0x3c, 0x2f, 0x7e, 0x15,
+  0x8b, 0x55, 0x0c, 0x8b, 0x45, 0x10, 0x01, 0xd0, 0x0f, 0xb6, 0x00, 0x3c,
+  0x39, 0x7e, 0xb3, 0xeb, 0x04, 0x83, 0x45, 0x10, 0x01, 0x8b, 0x55, 0x0c,
+  0x8b, 0x45, 0x10, 0x01, 0xd0, 0x0f, 0xb6, 0x00, 0x3c, 0x6c, 0x74, 0xed,
+  0x8b, 0x55, 0x0c, 0x8b, 0x45, 0x10, 0x01, 0xd0, 0x0f, 0xb6, 0x10, 0x8b,
+  0x45, 0x08, 0x88, 0x10, 0x8b, 0x55, 0x0c, 0x8b, 0x45, 0x10, 0x01, 0xd0,
+  0x0f, 0xb6, 0x00, 0x84, 0xc0, 0x74, 0x08, 0x8b, 0x45, 0x10, 0x83, 0xc0,
+  0x01, 0xeb, 0x03, 0x8b, 0x45, 0x10, 0x8b, 0x55, 0x08, 0x89, 0x42, 0x0c,
+  0x90, 0x8b, 0x45, 0x08, 0x5d, 0xc2, 0x04, 0x00, 0x55, 0x89, 0xe5, 0x83,
+  0xec, 0x14, 0x8b, 0x45, 0x0c, 0x88, 0x45, 0xec, 0x80, 0x7d, 0xec, 0x0a,
+  0x0f, 0x85, 0xaf, 0x00, 0x00, 0x00, 0xeb, 0x59, 0x8b, 0x4d, 0x08, 0xba,
+  0x1f, 0x85, 0xeb, 0x51, 0x89, 0xc8, 0xf7, 0xe2, 0x89, 0xd0, 0xc1, 0xe8,
+  0x05, 0x6b, 0xd0, 0x64, 0x89, 0xc8, 0x29, 0xd0, 0x01, 0xc0, 0x89, 0x45,
+  0xf8, 0x8b, 0x45, 0x08, 0xba, 0x1f, 0x85, 0xeb, 0x51, 0xf7, 0xe2, 0x89,
+  0xd0, 0xc1, 0xe8, 0x05, 0x89, 0x45, 0x08, 0x8b, 0x45, 0xf8, 0x83, 0xc0,
+  0x01, 0x83, 0x6d, 0x10, 0x01, 0x0f, 0xb6, 0x90, 0x00, 0x0c, 0x00, 0x00,
+  0x8b, 0x45, 0x10, 0x88, 0x10, 0x83, 0x6d, 0x10, 0x01, 0x8b, 0x45, 0xf8,
+  0x05, 0x00, 0x0c, 0x00, 0x00, 0x0f, 0xb6, 0x10, 0x8b, 0x45, 0x10, 0x88,
+  0x10, 0x83, 0x7d, 0x08, 0x63, 0x77, 0xa1, 0x83, 0x7d, 0x08, 0x09, 0x76,
+  0x32, 0x8b, 0x45, 0x08, 0x01, 0xc0, 0x83, 0xc0, 0x01, 0x83, 0x6d, 0x10,
+  0x01, 0x0f, 0xb6, 0x90, 0x00, 0x0c, 0x00, 0x00, 0x8b, 0x45, 0x10, 0x88,
+  0x10, 0x8b, 0x45, 0x08, 0x01, 0xc0, 0x83, 0x6d, 0x10, 0x01, 0x0f, 0xb6,
+  0x90, 0x00, 0x0c, 0x00, 0x00, 0x8b, 0x45, 0x10, 0x88, 0x10, 0xe9, 0xde,
+  0x00, 0x00, 0x00, 0x8b, 0x45, 0x08, 0x83, 0xc0, 0x30, 0x83, 0x6d, 0x10,
+  0x01, 0x89, 0xc2, 0x8b, 0x45, 0x10, 0x88, 0x10, 0xe9, 0xc8, 0x00, 0x00,
+  0x00, 0x80, 0x7d, 0xec, 0x10, 0x75, 0x79, 0xeb, 0x39, 0x8b, 0x45, 0x08,
+  0x0f, 0xb6, 0xc0, 0x01, 0xc0, 0x89, 0x45, 0xf8, 0xc1, 0x6d, 0x08, 0x08,
+  0x8b, 0x45, 0xf8, 0x83, 0xc0, 0x01, 0x83, 0x6d, 0x10, 0x01, 0x0f, 0xb6,
+  0x90, 0xe0, 0x0c, 0x00, 0x00, 0x8b, 0x45, 0x10, 0x88, 0x10, 0x83, 0x6d,
+  0x10, 0x01, 0x8b, 0x45, 0xf8, 0x05, 0xe0, 0x0c, 0x00, 0x00, 0x0f, 0xb6,
+  0x10, 0x8b, 0x45, 0x10, 0x88, 0x10, 0x81, 0x7d, 0x08, 0xff, 0x00, 0x00,
+  0x00, 0x77, 0xbe, 0x8b, 0x45, 0x08, 0x01, 0xc0, 0x83, 0xc0, 0x01, 0x83,
+  0x6d, 0x10, 0x01, 0x0f, 0xb6, 0x90, 0xe0, 0x0c, 0x00, 0x00, 0x8b, 0x45,
+  0x10, 0x88, 0x10, 0x83, 0x7d, 0x08, 0x0f, 0x76, 0x60, 0x8b, 0x45, 0x08,
+  0x01, 0xc0, 0x83, 0x6d, 0x10, 0x01, 0x0f, 0xb6, 0x90, 0xe0, 0x0c, 0x00,
+  0x00, 0x8b, 0x45, 0x10, 0x88, 0x10, 0xeb, 0x49, 0x0f, 0xb6, 0x4d, 0xec,
+  0x8b, 0x45, 0x08, 0xba, 0x00, 0x00, 0x00, 0x00, 0xf7, 0xf1, 0x89, 0x55,
+  0xfc, 0x83, 0x7d, 0xfc, 0x09, 0x77, 0x0a, 0x8b, 0x45, 0xfc, 0x83, 0xc0,
+  0x30, 0x89, 0xc2, 0xeb, 0x08, 0x8b, 0x45, 0xfc, 0x83, 0xc0, 0x57, 0x89,
+  0xc2, 0x83, 0x6d, 0x10, 0x01, 0x8b, 0x45, 0x10, 0x88, 0x10, 0x0f, 0xb6,
+  0x4d, 0xec, 0x8b, 0x45, 0x08, 0xba, 0x00, 0x00, 0x00, 0x00, 0xf7, 0xf1,
+  0x89, 0x45, 0x08, 0x83, 0x7d, 0x08, 0x00, 0x75, 0xb7, 0x8b, 0x45, 0x10,
+  0xc9, 0xc3, 0x55, 0x89, 0xe5, 0x83, 0xec, 0x18, 0xeb, 0x2a, 0x8b, 0x45,
+  0x14, 0xba, 0x10, 0x00, 0x00, 0x00, 0x39, 0xd0, 0x0f, 0x47, 0xc2, 0x89,
+  0x45, 0xf4, 0x83, 0xec, 0x04, 0xff, 0x75, 0xf4, 0xff, 0x75, 0x10, 0xff,
+  0x75, 0x0c, 0x8b, 0x45, 0x08, 0xff, 0xd0, 0x83, 0xc4, 0x10, 0x8b, 0x45,
+  0xf4, 0x29, 0x45, 0x14, 0x83, 0x7d, 0x14, 0x00, 0x75, 0xd0, 0x90, 0x90,
+  0xc9, 0xc3, 0x55, 0x89, 0xe5, 0x83, 0xec, 0x28, 0x8b, 0x55, 0x14, 0x8b,
+  0x45, 0x24, 0x88, 0x55, 0xe4, 0x88, 0x45, 0xe0, 0x0f, 0xb6, 0x45, 0xe4,
+  0x84, 0xc0, 0x0f, 0x95, 0xc0, 0x0f, 0xb6, 0xd0, 0x8b, 0x45, 0x18, 0x01,
+  0xc2, 0x8b, 0x45, 0x20, 0x01, 0xd0, 0x89, 0x45, 0xf4, 0x8b, 0x45, 0x10,
+  0x8b, 0x40, 0x04, 0x39, 0x45, 0xf4, 0x73, 0x0b, 0x8b, 0x45, 0x10, 0x8b,
+  0x40, 0x04, 0x2b, 0x45, 0xf4, 0xeb, 0x05, 0xb8, 0x00, 0x00, 0x00, 0x00,
+  0x89, 0x45, 0xf4, 0x80, 0x7d, 0xe0, 0x00, 0x74, 0x26, 0x8b, 0x45, 0x10,
+  0x0f, 0xb6, 0x40, 0x02, 0x84, 0xc0, 0x74, 0x1b, 0x8b, 0x45, 0x10, 0x0f,
+  0xb6, 0x40, 0x01, 0x83, 0xf0, 0x01, 0x84, 0xc0, 0x74, 0x0d, 0x8b, 0x45,
+  0xf4, 0x01, 0x45, 0x18, 0xc7, 0x45, 0xf4, 0x00, 0x00, 0x00, 0x00, 0x8b,
+  0x45, 0x10, 0x0f, 0xb6, 0x40, 0x01, 0x83, 0xf0, 0x01, 0x84, 0xc0, 0x74,
+  0x16, 0xff, 0x75, 0xf4, 0x68, 0xf8, 0x0e, 0x00, 0x00, 0xff, 0x75, 0x0c,
+  0xff, 0x75, 0x08, 0xe8, 0x2e, 0xff, 0xff, 0xff, 0x83, 0xc4, 0x10, 0x0f,
+  0xb6, 0x45, 0xe4, 0x84, 0xc0, 0x74, 0x14, 0x83, 0xec, 0x04, 0x6a, 0x01,
+  0x8d, 0x45, 0xe4, 0x50, 0xff, 0x75, 0x0c, 0x8b, 0x45, 0x08, 0xff, 0xd0,
+  0x83, 0xc4, 0x10, 0xff, 0x75, 0x18, 0x68, 0xe4, 0x0e, 0x00, 0x00, 0xff,
+  0x75, 0x0c, 0xff, 0x75, 0x08, 0xe8, 0xfc, 0xfe, 0xff, 0xff, 0x83, 0xc4,
+  0x10, 0x83, 0xec, 0x04, 0xff, 0x75, 0x20, 0xff, 0x75, 0x1c, 0xff, 0x75,
+  0x0c, 0x8b, 0x45, 0x08, 0xff, 0xd0, 0x83, 0xc4, 0x10, 0x8b, 0x45, 0x10,
+  0x0f, 0xb6, 0x40, 0x01, 0x84, 0xc0, 0x74, 0x16, 0xff, 0x75, 0xf4, 0x68,
+  0xf8, 0x0e, 0x00, 0x00, 0xff, 0x75, 0x0c, 0xff, 0x75, 0x08, 0xe8, 0xc7,
+  0xfe, 0xff, 0xff, 0x83, 0xc4, 0x10, 0x0f, 0xb6, 0x45, 0xe4, 0x84, 0xc0,
+  0x0f, 0x95, 0xc0, 0x0f, 0xb6, 0xd0, 0x8b, 0x45, 0x18, 0x01, 0xc2, 0x8b,
+  0x45, 0x20, 0x01, 0xc2, 0x8b, 0x45, 0xf4, 0x01, 0xd0, 0xc9, 0xc3, 0x55,
+  0x89, 0xe5, 0x83, 0xec, 0x58, 0x8b, 0x45, 0x18, 0x88, 0x45, 0xb4, 0xc7,
+  0x45, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x8b, 0x45, 0x10, 0x0f, 0xb6, 0x00,
+  0x3c, 0x63, 0x75, 0x28, 0x8b, 0x45, 0x14, 0x88, 0x45, 0xc4, 0x6a, 0x00,
+  0x6a, 0x01, 0x8d, 0x45, 0xc4, 0x50, 0x6a, 0x00, 0x6a, 0x00, 0xff, 0x75,
+  0x10, 0xff, 0x75, 0x0c, 0xff, 0x75, 0x08, 0xe8, 0xa6, 0xfe, 0xff, 0xff,
+  0x83, 0xc4, 0x20, 0xe9, 0xf4, 0x00, 0x00, 0x00, 0x8b, 0x45, 0x10, 0x0f,
+  0xb6, 0x00, 0x3c, 0x62, 0x74, 0x22, 0x8b, 0x45, 0x10, 0x0f, 0xb6, 0x00,
+  0x3c, 0x78, 0x74, 0x0a, 0x8b, 0x45, 0x10, 0x0f, 0xb6, 0x00, 0x3c, 0x58,
+  0x75, 0x07, 0xb8, 0x10, 0x00, 0x00, 0x00, 0xeb, 0x0c, 0xb8, 0x0a, 0x00,
+  0x00, 0x00, 0xeb, 0x05, 0xb8, 0x02, 0x00, 0x00, 0x00, 0x88, 0x45, 0xef,
+  0x8d, 0x45, 0xc4, 0x83, 0xc0, 0x20, 0x0f, 0xb6, 0x55, 0xef, 0x83, 0xec,
+  0x04, 0x50, 0x52, 0xff, 0x75, 0x14, 0xe8, 0x85, 0xfc, 0xff, 0xff, 0x83,
+  0xc4, 0x10, 0x89, 0x45, 0xe8, 0x8d, 0x45, 0xc4, 0x83, 0xc0, 0x20, 0x2b,
+  0x45, 0xe8, 0x89, 0x45, 0xe4, 0x8b, 0x45, 0x10, 0x0f, 0xb6, 0x00, 0x3c,
+  0x58, 0x75, 0x31, 0x8b, 0x45, 0xe8, 0x89, 0x45, 0xf4, 0xeb, 0x1e, 0x8b,
+  0x45, 0xf4, 0x0f, 0xb6, 0x00, 0x3c, 0x60, 0x7e, 0x10, 0x8b, 0x45, 0xf4,
+  0x0f, 0xb6, 0x00, 0x83, 0xe8, 0x20, 0x89, 0xc2, 0x8b, 0x45, 0xf4, 0x88,
+  0x10, 0x83, 0x45, 0xf4, 0x01, 0x8d, 0x45, 0xc4, 0x83, 0xc0, 0x20, 0x39,
+  0x45, 0xf4, 0x72, 0xd7, 0x8b, 0x45, 0x10, 0x8b, 0x40, 0x08, 0x85, 0xc0,
+  0x78, 0x17, 0x8b, 0x45, 0x10, 0x8b, 0x40, 0x08, 0x39, 0x45, 0xe4, 0x73,
+  0x0c, 0x8b, 0x45, 0x10, 0x8b, 0x40, 0x08, 0x2b, 0x45, 0xe4, 0x89, 0x45,
+  0xf0, 0x8b, 0x45, 0x10, 0x8b, 0x40, 0x08, 0xc1, 0xe8, 0x1f, 0x0f, 0xb6,
+  0xc0, 0x80, 0x7d, 0xb4, 0x00, 0x74, 0x07, 0xba, 0x2d, 0x00, 0x00, 0x00,
+  0xeb, 0x05, 0xba, 0x00, 0x00, 0x00, 0x00, 0x50, 0xff, 0x75, 0xe4, 0xff,
+  0x75, 0xe8, 0xff, 0x75, 0xf0, 0x52, 0xff, 0x75, 0x10, 0xff, 0x75, 0x0c,
+  0xff, 0x75, 0x08, 0xe8, 0xae, 0xfd, 0xff, 0xff, 0x83, 0xc4, 0x20, 0x90,
+  0xc9, 0xc3, 0x55, 0x89, 0xe5, 0x83, 0xec, 0x18, 0x83, 0x7d, 0x14, 0x00,
+  0x74, 0x05, 0x8b, 0x45, 0x14, 0xeb, 0x05, 0xb8, 0x09, 0x0f, 0x00, 0x00,
+  0x89, 0x45, 0x14, 0xc7, 0x45, 0xf4, 0x00, 0x00, 0x00, 0x00, 0xeb, 0x04,
+  0x83, 0x45, 0xf4, 0x01, 0x8b, 0x55, 0x14, 0x8b, 0x45, 0xf4, 0x01, 0xd0,
+  0x0f, 0xb6, 0x00, 0x84, 0xc0, 0x74, 0x15, 0x8b, 0x45, 0x10, 0x8b, 0x40,
+  0x08, 0x85, 0xc0, 0x78, 0xe3, 0x8b, 0x45, 0x10, 0x8b, 0x40, 0x08, 0x39,
+  0x45, 0xf4, 0x72, 0xd8, 0x6a, 0x00, 0xff, 0x75, 0xf4, 0xff, 0x75, 0x14,
+  0x6a, 0x00, 0x6a, 0x00, 0xff, 0x75, 0x10, 0xff, 0x75, 0x0c, 0xff, 0x75,
+  0x08, 0xe8, 0x44, 0xfd, 0xff, 0xff, 0x83, 0xc4, 0x20, 0xc9, 0xc3, 0x55,
+  0x89, 0xe5, 0x83, 0xec, 0x38, 0xc7, 0x45, 0xf4, 0x00, 0x00, 0x00, 0x00,
+  0xe9, 0xb1, 0x01, 0x00, 0x00, 0x8b, 0x45, 0x10, 0x89, 0x45, 0xf0, 0xeb,
+  0x04, 0x83, 0x45, 0x10, 0x01, 0x8b, 0x45, 0x10, 0x0f, 0xb6, 0x00, 0x84,
+  0xc0, 0x74, 0x0a, 0x8b, 0x45, 0x10, 0x0f, 0xb6, 0x00, 0x3c, 0x25, 0x75,
+  0xe8, 0x8b, 0x45, 0x10, 0x39, 0x45, 0xf0, 0x73, 0x21, 0x8b, 0x45, 0x10,
+  0x2b, 0x45, 0xf0, 0x83, 0xec, 0x04, 0x50, 0xff, 0x75, 0xf0, 0xff, 0x75,
+  0x0c, 0x8b, 0x45, 0x08, 0xff, 0xd0, 0x83, 0xc4, 0x10, 0x8b, 0x45, 0x10,
+  0x2b, 0x45, 0xf0, 0x01, 0x45, 0xf4, 0x8b, 0x45, 0x10, 0x0f, 0xb6, 0x00,
+  0x84, 0xc0, 0x0f, 0x84, 0x6a, 0x01, 0x00, 0x00, 0x8d, 0x45, 0xc8, 0x83,
+  0xec, 0x04, 0x6a, 0x00, 0xff, 0x75, 0x10, 0x50, 0xe8, 0x82, 0xf9, 0xff,
+  0xff, 0x83, 0xc4, 0x0c, 0x8b, 0x45, 0xc8, 0x89, 0x45, 0xdc, 0x8b, 0x45,
+  0xcc, 0x89, 0x45, 0xe0, 0x8b, 0x45, 0xd0, 0x89, 0x45, 0xe4, 0x8b, 0x45,
+  0xd4, 0x89, 0x45, 0xe8, 0x0f, 0xb6, 0x45, 0xdc, 0x0f, 0xbe, 0xc0, 0x83,
+  0xf8, 0x78, 0x0f, 0x8f, 0xf7, 0x00, 0x00, 0x00, 0x83, 0xf8, 0x62, 0x7d,
+  0x16, 0x85, 0xc0, 0x0f, 0x84, 0xe5, 0x00, 0x00, 0x00, 0x83, 0xf8, 0x58,
+  0x0f, 0x84, 0xb4, 0x00, 0x00, 0x00, 0xe9, 0xdc, 0x00, 0x00, 0x00, 0x83,
+  0xe8, 0x62, 0xba, 0x01, 0x00, 0x00, 0x00, 0x89, 0xc1, 0xd3, 0xe2, 0x89,
+  0xd0, 0x89, 0xc2, 0x81, 0xe2, 0x03, 0x00, 0x48, 0x00, 0x85, 0xd2, 0x0f,
+  0x95, 0xc2, 0x84, 0xd2, 0x0f, 0x85, 0x8c, 0x00, 0x00, 0x00, 0x89, 0xc2,
+  0x81, 0xe2, 0x84, 0x00, 0x00, 0x00, 0x85, 0xd2, 0x0f, 0x95, 0xc2, 0x84,
+  0xd2, 0x75, 0x38, 0x25, 0x00, 0x00, 0x02, 0x00, 0x85, 0xc0, 0x0f, 0x95,
+  0xc0, 0x84, 0xc0, 0x0f, 0x84, 0x96, 0x00, 0x00, 0x00, 0x8b, 0x45, 0x14,
+  0x8d, 0x50, 0x04, 0x89, 0x55, 0x14, 0x8b, 0x00, 0x50, 0x8d, 0x45, 0xdc,
+  0x50, 0xff, 0x75, 0x0c, 0xff, 0x75, 0x08, 0xe8, 0x76, 0xfe, 0xff, 0xff,
+  0x83, 0xc4, 0x10, 0x01, 0x45, 0xf4, 0xe9, 0x91, 0x00, 0x00, 0x00, 0x8b,
+  0x45, 0x14, 0x8d, 0x50, 0x04, 0x89, 0x55, 0x14, 0x8b, 0x00, 0x89, 0x45,
+  0xec, 0x8b, 0x45, 0xec, 0xc1, 0xe8, 0x1f, 0x0f, 0xb6, 0xd0, 0x83, 0x7d,
+  0xec, 0x00, 0x79, 0x07, 0x8b, 0x45, 0xec, 0xf7, 0xd8, 0xeb, 0x03, 0x8b,
+  0x45, 0xec, 0x83, 0xec, 0x0c, 0x52, 0x50, 0x8d, 0x45, 0xdc, 0x50, 0xff,
+  0x75, 0x0c, 0xff, 0x75, 0x08, 0xe8, 0xf5, 0xfc, 0xff, 0xff, 0x83, 0xc4,
+  0x20, 0x01, 0x45, 0xf4, 0xeb, 0x4e, 0x8b, 0x45, 0x14, 0x8d, 0x50, 0x04,
+  0x89, 0x55, 0x14, 0x8b, 0x00, 0x83, 0xec, 0x0c, 0x6a, 0x00, 0x50, 0x8d,
+  0x45, 0xdc, 0x50, 0xff, 0x75, 0x0c, 0xff, 0x75, 0x08, 0xe8, 0xcd, 0xfc,
+  0xff, 0xff, 0x83, 0xc4, 0x20, 0x01, 0x45, 0xf4, 0xeb, 0x26, 0x8b, 0x45,
+  0xf4, 0xeb, 0x3b, 0x8b, 0x45, 0xe8, 0x8d, 0x50, 0xff, 0x8b, 0x45, 0x10,
+  0x01, 0xd0, 0x83, 0xec, 0x04, 0x6a, 0x01, 0x50, 0xff, 0x75, 0x0c, 0x8b,
+  0x45, 0x08, 0xff, 0xd0, 0x83, 0xc4, 0x10, 0x83, 0x45, 0xf4, 0x01, 0x90,
+  0x8b, 0x45, 0xe8, 0x01, 0x45, 0x10, 0x8b, 0x45, 0x10, 0x0f, 0xb6, 0x00,
+  0x84, 0xc0, 0x0f, 0x85, 0x41, 0xfe, 0xff, 0xff, 0xeb, 0x01, 0x90, 0x8b,
+  0x45, 0xf4, 0xc9, 0xc3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x30, 0x30, 0x30, 0x31, 0x30, 0x32, 0x30, 0x33, 0x30, 0x34, 0x30, 0x35,
+  0x30, 0x36, 0x30, 0x37, 0x30, 0x38, 0x30, 0x39, 0x31, 0x30, 0x31, 0x31,
+  0x31, 0x32, 0x31, 0x33, 0x31, 0x34, 0x31, 0x35, 0x31, 0x36, 0x31, 0x37,
+  0x31, 0x38, 0x31, 0x39, 0x32, 0x30, 0x32, 0x31, 0x32, 0x32, 0x32, 0x33,
+  0x32, 0x34, 0x32, 0x35, 0x32, 0x36, 0x32, 0x37, 0x32, 0x38, 0x32, 0x39,
+  0x33, 0x30, 0x33, 0x31, 0x33, 0x32, 0x33, 0x33, 0x33, 0x34, 0x33, 0x35,
+  0x33, 0x36, 0x33, 0x37, 0x33, 0x38, 0x33, 0x39, 0x34, 0x30, 0x34, 0x31,
+  0x34, 0x32, 0x34, 0x33, 0x34, 0x34, 0x34, 0x35, 0x34, 0x36, 0x34, 0x37,
+  0x34, 0x38, 0x34, 0x39, 0x35, 0x30, 0x35, 0x31, 0x35, 0x32, 0x35, 0x33,
+  0x35, 0x34, 0x35, 0x35, 0x35, 0x36, 0x35, 0x37, 0x35, 0x38, 0x35, 0x39,
+  0x36, 0x30, 0x36, 0x31, 0x36, 0x32, 0x36, 0x33, 0x36, 0x34, 0x36, 0x35,
+  0x36, 0x36, 0x36, 0x37, 0x36, 0x38, 0x36, 0x39, 0x37, 0x30, 0x37, 0x31,
+  0x37, 0x32, 0x37, 0x33, 0x37, 0x34, 0x37, 0x35, 0x37, 0x36, 0x37, 0x37,
+  0x37, 0x38, 0x37, 0x39, 0x38, 0x30, 0x38, 0x31, 0x38, 0x32, 0x38, 0x33,
+  0x38, 0x34, 0x38, 0x35, 0x38, 0x36, 0x38, 0x37, 0x38, 0x38, 0x38, 0x39,
+  0x39, 0x30, 0x39, 0x31, 0x39, 0x32, 0x39, 0x33, 0x39, 0x34, 0x39, 0x35,
+  0x39, 0x36, 0x39, 0x37, 0x39, 0x38, 0x39, 0x39, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x30, 0x31,
+  0x30, 0x32, 0x30, 0x33, 0x30, 0x34, 0x30, 0x35, 0x30, 0x36, 0x30, 0x37,
+  0x30, 0x38, 0x30, 0x39, 0x30, 0x61, 0x30, 0x62, 0x30, 0x63, 0x30, 0x64,
+  0x30, 0x65, 0x30, 0x66, 0x31, 0x30, 0x31, 0x31, 0x31, 0x32, 0x31, 0x33,
+  0x31, 0x34, 0x31, 0x35, 0x31, 0x36, 0x31, 0x37, 0x31, 0x38, 0x31, 0x39,
+  0x31, 0x61, 0x31, 0x62, 0x31, 0x63, 0x31, 0x64, 0x31, 0x65, 0x31, 0x66,
+  0x32, 0x30, 0x32, 0x31, 0x32, 0x32, 0x32, 0x33, 0x32, 0x34, 0x32, 0x35,
+  0x32, 0x36, 0x32, 0x37, 0x32, 0x38, 0x32, 0x39, 0x32, 0x61, 0x32, 0x62,
+  0x32, 0x63, 0x32, 0x64, 0x32, 0x65, 0x32, 0x66, 0x33, 0x30, 0x33, 0x31,
+  0x33, 0x32, 0x33, 0x33, 0x33, 0x34, 0x33, 0x35, 0x33, 0x36, 0x33, 0x37,
+  0x33, 0x38, 0x33, 0x39, 0x33, 0x61, 0x33, 0x62, 0x33, 0x63, 0x33, 0x64,
+  0x33, 0x65, 0x33, 0x66, 0x34, 0x30, 0x34, 0x31, 0x34, 0x32, 0x34, 0x33,
+  0x34, 0x34, 0x34, 0x35, 0x34, 0x36, 0x34, 0x37, 0x34, 0x38, 0x34, 0x39,
+  0x34, 0x61, 0x34, 0x62, 0x34, 0x63, 0x34, 0x64, 0x34, 0x65, 0x34, 0x66,
+  0x35, 0x30, 0x35, 0x31, 0x35, 0x32, 0x35, 0x33, 0x35, 0x34, 0x35, 0x35,
+  0x35, 0x36, 0x35, 0x37, 0x35, 0x38, 0x35, 0x39, 0x35, 0x61, 0x35, 0x62,
+  0x35, 0x63, 0x35, 0x64, 0x35, 0x65, 0x35, 0x66, 0x36, 0x30, 0x36, 0x31,
+  0x36, 0x32, 0x36, 0x33, 0x36, 0x34, 0x36, 0x35, 0x36, 0x36, 0x36, 0x37,
+  0x36, 0x38, 0x36, 0x39, 0x36, 0x61, 0x36, 0x62, 0x36, 0x63, 0x36, 0x64,
+  0x36, 0x65, 0x36, 0x66, 0x37, 0x30, 0x37, 0x31, 0x37, 0x32, 0x37, 0x33,
+  0x37, 0x34, 0x37, 0x35, 0x37, 0x36, 0x37, 0x37, 0x37, 0x38, 0x37, 0x39,
+  0x37, 0x61, 0x37, 0x62, 0x37, 0x63, 0x37, 0x64, 0x37, 0x65, 0x37, 0x66,
+  0x38, 0x30, 0x38, 0x31, 0x38, 0x32, 0x38, 0x33, 0x38, 0x34, 0x38, 0x35,
+  0x38, 0x36, 0x38, 0x37, 0x38, 0x38, 0x38, 0x39, 0x38, 0x61, 0x38, 0x62,
+  0x38, 0x63, 0x38, 0x64, 0x38, 0x65, 0x38, 0x66, 0x39, 0x30, 0x39, 0x31,
+  0x39, 0x32, 0x39, 0x33, 0x39, 0x34, 0x39, 0x35, 0x39, 0x36, 0x39, 0x37,
+  0x39, 0x38, 0x39, 0x39, 0x39, 0x61, 0x39, 0x62, 0x39, 0x63, 0x39, 0x64,
+  0x39, 0x65, 0x39, 0x66, 0x61, 0x30, 0x61, 0x31, 0x61, 0x32, 0x61, 0x33,
+  0x61, 0x34, 0x61, 0x35, 0x61, 0x36, 0x61, 0x37, 0x61, 0x38, 0x61, 0x39,
+  0x61, 0x61, 0x61, 0x62, 0x61, 0x63, 0x61, 0x64, 0x61, 0x65, 0x61, 0x66,
+  0x62, 0x30, 0x62, 0x31, 0x62, 0x32, 0x62, 0x33, 0x62, 0x34, 0x62, 0x35,
+  0x62, 0x36, 0x62, 0x37, 0x62, 0x38, 0x62, 0x39, 0x62, 0x61, 0x62, 0x62,
+  0x62, 0x63, 0x62, 0x64, 0x62, 0x65, 0x62, 0x66, 0x63, 0x30, 0x63, 0x31,
+  0x63, 0x32, 0x63, 0x33, 0x63, 0x34, 0x63, 0x35, 0x63, 0x36, 0x63, 0x37,
+  0x63, 0x38, 0x63, 0x39, 0x63, 0x61, 0x63, 0x62, 0x63, 0x63, 0x63, 0x64,
+  0x63, 0x65, 0x63, 0x66, 0x64, 0x30, 0x64, 0x31, 0x64, 0x32, 0x64, 0x33,
+  0x64, 0x34, 0x64, 0x35, 0x64, 0x36, 0x64, 0x37, 0x64, 0x38, 0x64, 0x39,
+  0x64, 0x61, 0x64, 0x62, 0x64, 0x63, 0x64, 0x64, 0x64, 0x65, 0x64, 0x66,
+  0x65, 0x30, 0x65, 0x31, 0x65, 0x32, 0x65, 0x33, 0x65, 0x34, 0x65, 0x35,
+  0x65, 0x36, 0x65, 0x37, 0x65, 0x38, 0x65, 0x39, 0x65, 0x61, 0x65, 0x62,
+  0x65, 0x63, 0x65, 0x64, 0x65, 0x65, 0x65, 0x66, 0x66, 0x30, 0x66, 0x31,
+  0x66, 0x32, 0x66, 0x33, 0x66, 0x34, 0x66, 0x35, 0x66, 0x36, 0x66, 0x37,
+  0x66, 0x38, 0x66, 0x39, 0x66, 0x61, 0x66, 0x62, 0x66, 0x63, 0x66, 0x64,
+  0x66, 0x65, 0x66, 0x66, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x30, 0x30,
+  0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+  0x00, 0x00, 0x00, 0x00, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x28, 0x6e, 0x75,
+  0x6c, 0x6c, 0x29, 0x00, 0x73, 0x70, 0x69, 0x6e, 0x3a, 0x20, 0x73, 0x74,
+  0x61, 0x72, 0x74, 0x20, 0x25, 0x64, 0x20, 0x6d, 0x73, 0x2c, 0x20, 0x65,
+  0x6e, 0x64, 0x20, 0x25, 0x64, 0x20, 0x6d, 0x73, 0x2c, 0x20, 0x65, 0x6c,
+  0x61, 0x70, 0x73, 0x65, 0x64, 0x20, 0x25, 0x64, 0x20, 0x6d, 0x73, 0x20,
+  0x28, 0x25, 0x78, 0x29, 0x0a, 0x00, 0x2f, 0x6c, 0x69, 0x62, 0x2f, 0x6c,
+  0x64, 0x2d, 0x6c, 0x69, 0x6e, 0x75, 0x78, 0x2e, 0x73, 0x6f, 0x2e, 0x32,
+  0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00,
+  0x03, 0x00, 0x00, 0x00, 0x47, 0x4e, 0x55, 0x00, 0xd1, 0x4a, 0xcc, 0xcf,
+  0x35, 0xf3, 0xbe, 0xa7, 0x55, 0xed, 0xab, 0x96, 0xb3, 0xd9, 0x88, 0x41,
+  0x86, 0xd3, 0x67, 0x4c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x12, 0x00, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0x49, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0x4e, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x63, 0x00, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0x13, 0x01, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0x3c, 0x01, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x4a, 0x01, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0x62, 0x01, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0xf0, 0x02, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0xfe, 0x02, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0x08, 0x03, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0x0d, 0x03, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x22, 0x03, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0x2c, 0x03, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0xf7, 0x03, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0xfc, 0x03, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0x0b, 0x04, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0xe4, 0x05, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0xf5, 0x05, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0x1c, 0x06, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0x31, 0x06, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x79, 0x06, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0x8a, 0x06, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0xae, 0x06, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0xc9, 0x06, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0xe5, 0x07, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0x17, 0x08, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x4c, 0x08, 0x00, 0x00,
+  0x08, 0x00, 0x00, 0x00, 0xc8, 0x09, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0xf5, 0xfe, 0xff, 0x6f, 0x90, 0x0f, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+  0x8c, 0x0f, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x7c, 0x0f, 0x00, 0x00,
+  0x0a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00,
+  0x10, 0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x11, 0x00, 0x00, 0x00, 0xa8, 0x0f, 0x00, 0x00, 0x12, 0x00, 0x00, 0x00,
+  0xf0, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00,
+  0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1e, 0x00, 0x00, 0x00,
+  0x04, 0x00, 0x00, 0x00, 0xfb, 0xff, 0xff, 0x6f, 0x00, 0x00, 0x00, 0x08,
+  0xfa, 0xff, 0xff, 0x6f, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+const unsigned int spin_bin_len = 4392;
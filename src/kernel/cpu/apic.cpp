@@ -1,13 +1,355 @@
+// stdlibs
+#include "stdlib.h"
 // cpu
 #include "cpuid.h"
+#include "msr.h"
+#include "paging.h"
+#include "idt.h"
+#include "pic.h"
+#include "isr.h"
 #include "apic.h"
+// legacy drivers
+#include "pit.h"
+#include "vga.h"
+// sys
+#include "acpi.h"
+#include "klog.h"
+// process
+#include "scheduler.h"
 
-int apic::install() {
-    if (cpuid::hasApic()) {
-        // Apic is present and can be used
-        
+#define MSR_IA32_APIC_BASE          0x1B        // Local APIC registers address (Bits 31-12) and global enable (Bit 11)
+#define APIC_BASE_ENABLE           0x800        // IA32_APIC_BASE global enable bit
+#define APIC_BASE_ADDRESS_MASK 0xFFFFF000
+
+/**
+ * @brief Local APIC registers, offset from the local APIC address
+ *
+ */
+#define LAPIC_REG_ID               0x020        // Bits 31-24: Local APIC id
+#define LAPIC_REG_TPR              0x080        // Task priority, 0 = every interruption is accepted
+#define LAPIC_REG_EOI              0x0B0        // Write 0 to acknowledge the interruption being serviced
+#define LAPIC_REG_SVR              0x0F0        // Spurious interrupt vector (Bits 7-0) and software enable (Bit 8)
+#define LAPIC_REG_ICR_LOW          0x300        // Interrupt command: vector, delivery mode and level. Writing it sends the IPI
+#define LAPIC_REG_ICR_HIGH         0x310        // Interrupt command: Bits 31-24 destination local APIC id
+#define LAPIC_REG_LVT_TIMER        0x320        // Timer vector, mask and mode
+#define LAPIC_REG_LVT_LINT0        0x350        // LINT0 pin, wired to the 8259 PIC output
+#define LAPIC_REG_LVT_LINT1        0x360        // LINT1 pin, wired to the NMI
+#define LAPIC_REG_TIMER_INITIAL    0x380        // Timer count loaded when the timer starts or reloads. 0 stops the timer
+#define LAPIC_REG_TIMER_CURRENT    0x390        // Timer current count
+#define LAPIC_REG_TIMER_DIVIDE     0x3E0        // Divisor of the bus clock that decrements the timer count
+
+#define LAPIC_SVR_ENABLE           0x100        // Local APIC software enable
+#define LAPIC_LVT_MASKED         0x10000        // Local vector table entry masked
+#define LAPIC_LVT_NMI              0x400        // Delivery mode NMI
+#define LAPIC_TIMER_PERIODIC     0x20000        // Timer mode periodic, the initial count is reloaded when it reaches 0
+#define LAPIC_ICR_INIT             0x500        // Delivery mode INIT
+#define LAPIC_ICR_STARTUP          0x600        // Delivery mode STARTUP, the vector is the start page (address >> 12)
+#define LAPIC_ICR_PENDING         0x1000        // Delivery status, the IPI wasn't accepted yet
+#define LAPIC_ICR_ASSERT          0x4000        // Level assert, required by INIT
+#define LAPIC_TIMER_DIVIDE_16        0x3        // Timer count decremented every 16 bus clocks
+#define LAPIC_CALIBRATE_COUNT      11932        // PIT clocks counted by the local APIC timer to calibrate it (10 ms)
+
+/**
+ * @brief I/O APIC registers
+ *
+ */
+#define IOAPIC_REG_SELECT           0x00        // IOREGSEL - Index of the register accessed through IOWIN
+#define IOAPIC_REG_WINDOW           0x10        // IOWIN - Data of the selected register
+#define IOAPIC_REG_VERSION          0x01        // Bits 23-16: Last redirection entry
+#define IOAPIC_REG_REDIRECTION      0x10        // Redirection entry n: low 32 bits at 0x10 + 2n, high 32 bits at 0x11 + 2n
+
+#define IOAPIC_REDIR_MASKED      0x10000        // Redirection entry masked. Edge triggered, active high and fixed delivery are 0
+#define IOAPIC_REDIR_ACTIVE_LOW   0x2000        // Pin polarity active low
+#define IOAPIC_REDIR_LEVEL        0x8000        // Pin level triggered
+#define IOAPIC_PIT_PIN                 2        // ISA IRQ0 override used without ACPI, the PIT is wired to pin 2
+
+extern "C" void isr_spurious();                 // isr_int.asm
+
+bool apicEnabled;                               // Interruptions are delivered by the APIC
+uint32_t lapicAddress;                          // Local APIC registers address
+uint32_t ioapicAddress;                         // I/O APIC registers address
+uint32_t ioapicGsiBase;                         // Global system interrupt of the first I/O APIC pin
+uint32_t ioapicLastPin;                         // Last I/O APIC redirection entry
+uint8_t irqPins[IOAPIC_ISA_IRQS];               // I/O APIC pin of each legacy IRQ
+uint32_t lapicTimerCount;                       // Local APIC timer count of one scheduler tick
+uint32_t lapicTimerTicks;                       // Scheduler ticks of all the cpus since the timers were started
+
+/**
+ * @brief Read a local APIC register
+ *
+ * @param reg           Register offset
+ * @return uint32_t     Register value
+ */
+uint32_t lapicRead(uint32_t reg) {
+    return *((volatile uint32_t*) (lapicAddress + reg));
+}
+
+/**
+ * @brief Write a local APIC register
+ *
+ * @param reg   Register offset
+ * @param value Register value
+ */
+void lapicWrite(uint32_t reg, uint32_t value) {
+    *((volatile uint32_t*) (lapicAddress + reg)) = value;
+}
+
+/**
+ * @brief Read an I/O APIC register
+ *
+ * @param reg           Register index
+ * @return uint32_t     Register value
+ */
+uint32_t ioapicRead(uint8_t reg) {
+    *((volatile uint32_t*) (ioapicAddress + IOAPIC_REG_SELECT)) = reg;
+    return *((volatile uint32_t*) (ioapicAddress + IOAPIC_REG_WINDOW));
+}
+
+/**
+ * @brief Write an I/O APIC register
+ *
+ * @param reg   Register index
+ * @param value Register value
+ */
+void ioapicWrite(uint8_t reg, uint32_t value) {
+    *((volatile uint32_t*) (ioapicAddress + IOAPIC_REG_SELECT)) = reg;
+    *((volatile uint32_t*) (ioapicAddress + IOAPIC_REG_WINDOW)) = value;
+}
+
+/**
+ * @brief Program the redirection entry of an I/O APIC pin
+ *
+ * @param pin       I/O APIC input pin
+ * @param low       Vector, delivery mode, polarity, trigger mode and mask
+ * @param apicId    Destination local APIC id
+ */
+void ioapicSetEntry(uint8_t pin, uint32_t low, uint8_t apicId) {
+    ioapicWrite(IOAPIC_REG_REDIRECTION + pin * 2, IOAPIC_REDIR_MASKED);  // Masked while the entry is half written
+    ioapicWrite(IOAPIC_REG_REDIRECTION + pin * 2 + 1, (uint32_t) apicId << 24);
+    ioapicWrite(IOAPIC_REG_REDIRECTION + pin * 2, low);
+}
+
+/**
+ * @brief Select the I/O APIC that receives the ISA IRQs, the one whose pins start at the global system interrupt 0
+ *
+ * @return uint32_t GSI of its first pin
+ */
+uint32_t selectIoApic() {
+    const AcpiIoApic* ioapic;
+
+    for (uint8_t i = 0; i < acpi::getIoApicCount(); i++) {
+        ioapic = acpi::getIoApic(i);
+        if (ioapic->gsiBase == 0) {
+            ioapicAddress = ioapic->address;
+            return 0;
+        }
+    }
+    if (acpi::getIoApicCount() > 0) {
+        ioapic = acpi::getIoApic(0);
+        ioapicAddress = ioapic->address;
+        return ioapic->gsiBase;
+    }
+    ioapicAddress = IOAPIC_DEFAULT_ADDRESS;                 // No MADT, PC compatible default
+    return 0;
+}
+
+/**
+ * @brief Get the redirection entry low bits of an ISA IRQ
+ *
+ * @param irq           ISA IRQ
+ * @param gsiBase       GSI of the first pin of the I/O APIC
+ * @return uint32_t     Vector, polarity and trigger mode. The pin is written in irqPins
+ */
+uint32_t routeIsaIrq(uint8_t irq, uint32_t gsiBase) {
+    uint16_t flags = 0;
+    uint32_t low = IRQ0 + irq;
+
+    if (acpi::isAvailable()) {
+        irqPins[irq] = (uint8_t) (acpi::irqToGsi(irq, &flags) - gsiBase);
     } else {
+        irqPins[irq] = irq == 0 ? IOAPIC_PIT_PIN : irq;
+    }
+    if ((flags & ACPI_INTI_POLARITY_MASK) == ACPI_INTI_POLARITY_LOW) {
+        low |= IOAPIC_REDIR_ACTIVE_LOW;
+    }
+    if ((flags & ACPI_INTI_TRIGGER_MASK) == ACPI_INTI_TRIGGER_LEVEL) {
+        low |= IOAPIC_REDIR_LEVEL;
+    }
+    return low;
+}
+
+/**
+ * @brief Write the interrupt command register and wait until the IPI is accepted
+ *
+ * @param apicId    Destination local APIC id
+ * @param low       Vector, delivery mode and level
+ */
+void lapicSendCommand(uint8_t apicId, uint32_t low) {
+    lapicWrite(LAPIC_REG_ICR_HIGH, (uint32_t) apicId << 24);
+    lapicWrite(LAPIC_REG_ICR_LOW, low);
+    while (lapicRead(LAPIC_REG_ICR_LOW) & LAPIC_ICR_PENDING) {
+        asm volatile("pause");
+    }
+}
+
+/**
+ * @brief Configure the local APIC of the running cpu: accept every interruption, mask the 8259 input and enable it
+ *
+ */
+void lapicSetup() {
+    lapicWrite(LAPIC_REG_TPR, 0);
+    lapicWrite(LAPIC_REG_LVT_LINT0, LAPIC_LVT_MASKED);      // The 8259 is disabled
+    lapicWrite(LAPIC_REG_LVT_LINT1, LAPIC_LVT_NMI);
+    lapicWrite(LAPIC_REG_SVR, LAPIC_SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+    lapicWrite(LAPIC_REG_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_16);
+}
+
+/**
+ * @brief Local APIC timer interruption. Scheduler tick of this cpu.
+ *
+ * @param r Registers of the interrupted code
+ */
+void apicTimerHandler(registers_t*) {
+    lapicTimerTicks++;
+    scheduler::tick();
+    klog::scheduleDrain();
+    vga::scheduleFlush();               // The busy cpus update the screen, the PIT ticks stop while the bootstrap processor is idle
+}
+
+int apic::install() {
+    uint32_t flags;
+    uint64_t base;
+    uint32_t elapsed;
+    uint32_t low;
+    int i;
+
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    apicEnabled = false;
+    lapicAddress = 0;
+    ioapicAddress = IOAPIC_DEFAULT_ADDRESS;
+    ioapicGsiBase = 0;
+    ioapicLastPin = 0;
+    lapicTimerCount = 0;
+    lapicTimerTicks = 0;
+
+    if (!cpuid::hasApic()) {
         return APIC_ERROR_NOT_PRESENT;
     }
+
+    base = msr::read(MSR_IA32_APIC_BASE);
+    msr::write(MSR_IA32_APIC_BASE, base | APIC_BASE_ENABLE);
+    if ((msr::read(MSR_IA32_APIC_BASE) & APIC_BASE_ENABLE) == 0) {
+        return APIC_ERROR_DISABLED;
+    }
+    lapicAddress = (uint32_t) base & APIC_BASE_ADDRESS_MASK;
+
+    ioapicGsiBase = selectIoApic();
+
+    paging::mapMmio(lapicAddress);
+    paging::mapMmio(ioapicAddress);
+
+    asm volatile("pushf; pop %0; cli" : /* output */ "=r"(flags));
+
+    // Route the legacy IRQs to the same vectors used by the 8259 PIC, applying the MADT overrides. Every other pin is masked
+    ioapicLastPin = (ioapicRead(IOAPIC_REG_VERSION) >> 16) & 0xFF;
+    for (i = 0; i <= (int) ioapicLastPin; i++) {
+        ioapicWrite(IOAPIC_REG_REDIRECTION + i * 2, IOAPIC_REDIR_MASKED);
+    }
+    for (i = 0; i < IOAPIC_ISA_IRQS; i++) {
+        low = routeIsaIrq(i, ioapicGsiBase);
+        if (i != 2 && irqPins[i] <= ioapicLastPin) {              // IRQ2 is the 8259 cascade, its pin is used by the PIT
+            ioapicSetEntry(irqPins[i], low, apic::getId());
+        }
+    }
+    pic::disable();
+
+    // Local APIC
+    idt::setGate(APIC_SPURIOUS_VECTOR, (uint32_t) isr_spurious, IDT_KERNEL_CS, IDT_GATE_PRESENT, IDT_GATE_DPL_PRIVILEGE_MAX, IDT_GATE_STORAGE_SEG_INT, IDT_GATE_TYPE_X86_INTERRUPT);
+    lapicSetup();
+
+    // Calibrate the timer: count down from the max value while the PIT channel 2 counts 10 ms
+    isr::registerIsrHandler(IRQ_APIC_TIMER, apicTimerHandler);
+    lapicWrite(LAPIC_REG_LVT_TIMER, LAPIC_LVT_MASKED | IRQ_APIC_TIMER);
+    lapicWrite(LAPIC_REG_TIMER_INITIAL, 0xFFFFFFFF);
+    pit::busyWait(LAPIC_CALIBRATE_COUNT);
+    elapsed = 0xFFFFFFFF - lapicRead(LAPIC_REG_TIMER_CURRENT);
+    lapicWrite(LAPIC_REG_TIMER_INITIAL, 0);
+    lapicTimerCount = elapsed * (1000 / APIC_TIMER_HZ) / 10;
+
+    apicEnabled = true;
+    apic::timerStart();
+
+    asm volatile("push %0; popf" : /* output */ : /* input */ "r"(flags));
     return APIC_NO_ERROR;
-}
\ No newline at end of file
+}
+
+void apic::installCpu() {
+    msr::write(MSR_IA32_APIC_BASE, msr::read(MSR_IA32_APIC_BASE) | APIC_BASE_ENABLE);
+    lapicSetup();
+    apic::timerStart();                                     // Same bus clock on every cpu, the count of the bootstrap processor is used
+}
+
+bool apic::isEnabled() {
+    return apicEnabled;
+}
+
+void apic::sendEOI() {
+    lapicWrite(LAPIC_REG_EOI, 0);
+}
+
+uint8_t apic::getId() {
+    return (uint8_t) (lapicRead(LAPIC_REG_ID) >> 24);
+}
+
+void apic::sendIpi(uint8_t apicId, uint8_t vector) {
+    lapicSendCommand(apicId, vector);                       // Fixed delivery mode
+}
+
+void apic::sendInit(uint8_t apicId) {
+    lapicSendCommand(apicId, LAPIC_ICR_INIT | LAPIC_ICR_ASSERT);
+}
+
+void apic::sendStartup(uint8_t apicId, uint32_t address) {
+    lapicSendCommand(apicId, LAPIC_ICR_STARTUP | LAPIC_ICR_ASSERT | (address >> 12));
+}
+
+void apic::setMask(uint8_t irq) {
+    if (irq >= IOAPIC_ISA_IRQS) {
+        return;
+    }
+    uint8_t reg = IOAPIC_REG_REDIRECTION + irqPins[irq] * 2;
+    ioapicWrite(reg, ioapicRead(reg) | IOAPIC_REDIR_MASKED);
+}
+
+void apic::clearMask(uint8_t irq) {
+    if (irq >= IOAPIC_ISA_IRQS) {
+        return;
+    }
+    uint8_t reg = IOAPIC_REG_REDIRECTION + irqPins[irq] * 2;
+    ioapicWrite(reg, ioapicRead(reg) & ~IOAPIC_REDIR_MASKED);
+}
+
+bool apic::routeGsi(uint32_t gsi, uint8_t vector) {
+    if (!apicEnabled || gsi < ioapicGsiBase || gsi - ioapicGsiBase > ioapicLastPin) {
+        return false;
+    }
+    ioapicSetEntry(gsi - ioapicGsiBase, vector, apic::getId());  // Edge triggered, active high
+    return true;
+}
+
+void apic::timerStop() {
+    if (apicEnabled) {
+        lapicWrite(LAPIC_REG_TIMER_INITIAL, 0);
+    }
+}
+
+void apic::timerStart() {
+    if (apicEnabled) {
+        lapicWrite(LAPIC_REG_LVT_TIMER, LAPIC_TIMER_PERIODIC | IRQ_APIC_TIMER);
+        lapicWrite(LAPIC_REG_TIMER_INITIAL, lapicTimerCount);
+    }
+}
+
+uint32_t apic::getTimerTicks() {
+    return lapicTimerTicks;
+}
@@ -2,28 +2,149 @@
 #ifndef _APIC_H_
 #define _APIC_H_
 
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+
 #define APIC_NO_ERROR 0            // No error happend. Same as Success
 #define APIC_ERROR_NOT_PRESENT 1   // Cpu don't have an APIC
+#define APIC_ERROR_DISABLED 2      // The APIC was disabled by the BIOS in IA32_APIC_BASE and can't be enabled
+
+#define APIC_TIMER_HZ 100          // Scheduler ticks per second of the local APIC timer
+#define APIC_SPURIOUS_VECTOR 0xFF  // Vector of the spurious interruptions. Not an IRQ, must not be acknowledged with an EOI
+
+#define IOAPIC_DEFAULT_ADDRESS 0xFEC00000  // Physical address of the first I/O APIC on PC compatible chipsets
+#define IOAPIC_ISA_IRQS 16                 // Legacy IRQs routed to the IRQ0 - IRQ15 vectors
 
 /**
  * @brief APIC - Advanced Programmable Interrupt Controller
- * 
+ *
  * DETECTING_APIC_PRESENCE
- *     - Beginning with the P6 family processors, the presence or absence of an on-chip local 
- *     APIC can be detected using the CPUID instruction. When the CPUID instruction is 
- *     executed with a source operand of 1 in the EAX register, bit 9 of the CPUID feature 
- *     flags returned in the EDX register indicates the presence (set) or absence (clear) of a 
+ *     - Beginning with the P6 family processors, the presence or absence of an on-chip local
+ *     APIC can be detected using the CPUID instruction. When the CPUID instruction is
+ *     executed with a source operand of 1 in the EAX register, bit 9 of the CPUID feature
+ *     flags returned in the EDX register indicates the presence (set) or absence (clear) of a
  *     local APIC.
- * 
- * 
+ *
+ * LOCAL_APIC:
+ *     - One per cpu. Its registers are memory mapped at the address of the IA32_APIC_BASE MSR (0xFEE00000 by default).
+ *     - An interruption is acknowledged writing 0 in the EOI register, a single memory write instead of the 8259 port I/O.
+ *     - Has its own timer, used as the per cpu scheduler tick. It's calibrated against the PIT channel 2 at boot.
+ *     - Sends inter-processor interruptions (IPI) through the interrupt command register: INIT and STARTUP to boot the
+ *       application processors, and fixed vectors to wake up an idle cpu.
+ *
+ * IO_APIC:
+ *     - Receives the device interruptions and sends them to the local APICs. Accessed through an index (IOREGSEL) and a data (IOWIN) register.
+ *     - Each input pin has a 64 bits redirection entry: vector, delivery mode, polarity, trigger mode, mask and destination APIC id.
+ *     - The legacy IRQs are routed to the same vectors used with the 8259 PIC (IRQ0 - IRQ15), so the drivers are unchanged.
+ *     - The I/O APIC address and the ISA interrupt overrides (E.g the PIT wired to pin 2 instead of pin 0) come from the ACPI MADT.
+ *       Without ACPI the PC defaults are used: address 0xFEC00000 and IRQ0 on pin 2. Pin 0 receives the 8259 output and is kept masked.
+ *
+ * When the APIC is enabled the 8259 PIC is disabled through pic::disable.
  */
 namespace apic {
     /**
      * @brief APIC install and configure if present
-     * 
+     *        Enable the local APIC, route the legacy IRQs through the I/O APIC, start the scheduler tick and disable the 8259 PIC.
+     *
      * @return int 0=NO_ERROR, >0=ERROR_CODE
      */
     int install();
+
+    /**
+     * @brief Enable the local APIC of an application processor and start its scheduler tick with the timer count calibrated
+     *        by apic::install on the bootstrap processor
+     *
+     */
+    void installCpu();
+
+    /**
+     * @brief Return whether the interruptions are delivered by the APIC or by the 8259 PIC
+     *
+     * @return true  APIC is enabled
+     * @return false 8259 PIC is used
+     */
+    bool isEnabled();
+
+    /**
+     * @brief End of Interrupt (EOI)
+     *        Acknowledge the interruption being serviced by the local APIC
+     *
+     */
+    void sendEOI();
+
+    /**
+     * @brief Get the local APIC id of the running cpu
+     *
+     * @return uint8_t Local APIC id
+     */
+    uint8_t getId();
+
+    /**
+     * @brief Send a fixed interruption to another cpu
+     *
+     * @param apicId    Local APIC id of the destination cpu
+     * @param vector    Interrupt vector
+     */
+    void sendIpi(uint8_t apicId, uint8_t vector);
+
+    /**
+     * @brief Send an INIT IPI. The destination cpu resets and waits for a STARTUP IPI
+     *
+     * @param apicId Local APIC id of the destination cpu
+     */
+    void sendInit(uint8_t apicId);
+
+    /**
+     * @brief Send a STARTUP IPI. The destination cpu starts in real mode at the given address
+     *
+     * @param apicId    Local APIC id of the destination cpu
+     * @param address   Start address, 4 KiB aligned and below 1 MiB
+     */
+    void sendStartup(uint8_t apicId, uint32_t address);
+
+    /**
+     * @brief Mask a legacy IRQ in the I/O APIC
+     *
+     * @param irq IRQ line (0 - 15)
+     */
+    void setMask(uint8_t irq);
+
+    /**
+     * @brief Unmask a legacy IRQ in the I/O APIC
+     *
+     * @param irq IRQ line (0 - 15)
+     */
+    void clearMask(uint8_t irq);
+
+    /**
+     * @brief Route a global system interrupt of the I/O APIC to the given vector. Edge triggered and active high.
+     *
+     * @param gsi       Global system interrupt, E.g the pin a HPET comparator is wired to
+     * @param vector    Interrupt vector
+     * @return true     Routed and unmasked
+     * @return false    The APIC is disabled or the I/O APIC has no such pin
+     */
+    bool routeGsi(uint32_t gsi, uint8_t vector);
+
+    /**
+     * @brief Stop the local APIC timer. Called by the idle loop so the halted cpu is only woken up by the timers deadline.
+     *
+     */
+    void timerStop();
+
+    /**
+     * @brief Restart the local APIC timer in periodic mode
+     *
+     */
+    void timerStart();
+
+    /**
+     * @brief Get the scheduler ticks of the local APIC timers
+     *
+     * @return uint32_t Ticks of all the cpus since apic::install
+     */
+    uint32_t getTimerTicks();
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -1076,7 +1076,7 @@ void cpuid::printCpuInfo() {
   if (cpuType == CPUID_INTEL) {
     getIntelCpuInfo();
   } else {
-    stdio::kprintf("Unknown x86 CPU detected.\n");
+    KPRINTF("Unknown x86 CPU detected.\n");
   }
 }
 
@@ -1093,7 +1093,7 @@ uint8_t cpuid::detectCpu() {
   // strVendorId[12] = '\0';
 
   // Print vendor id on screen
-  // stdio::kprintf("CPUID - VENDOR_ID (0x%x - 0x%x - 0x%x): %s\n", vendorId[0], vendorId[1], vendorId[2], strVendorId);
+  // KPRINTF("CPUID - VENDOR_ID (0x%x - 0x%x - 0x%x): %s\n", vendorId[0], vendorId[1], vendorId[2], strVendorId);
 
   // Get additional info about the processor using vendor id
   switch(vendorId[0]) {
@@ -1101,21 +1101,65 @@ uint8_t cpuid::detectCpu() {
       // getIntelCpuInfo();
       return CPUID_INTEL;
     default:
-      // stdio::kprintf("Unknown x86 CPU detected.\n");
+      // KPRINTF("Unknown x86 CPU detected.\n");
       return CPUID_UNKNOW_CPU;
   }
 }
 
 bool cpuid::hasApic() {
-  uint8_t cpuType = detectCpu();
-  if (cpuType == CPUID_INTEL) {
-    // Get APIC information from EAX=1 function in EDX register Bit 9
-    uint32_t edx, unused;
-    cpuid(1, unused, unused, unused, edx);
+  // Get APIC information from EAX=1 function in EDX register Bit 9. Same bit on Intel and AMD processors
+  uint32_t edx, unused;
+  cpuid(1, unused, unused, unused, edx);
+
+  return ((edx >> 9) & 0x1) == 1;
+}
+
+bool cpuid::hasSep() {
+  // Get SEP information from EAX=1 function in EDX register Bit 11
+  uint32_t eax, edx, unused;
+  cpuid(1, eax, unused, unused, edx);
 
-    return ((edx >> 9) & 0x1) == 1;
+  if (((edx >> 11) & 0x1) == 0) {
+    return false;
   }
-  return false;
+
+  // Pentium Pro processors (Family 6, Model < 3, Stepping < 3) report SEP but don't support the instructions
+  if (detectCpu() == CPUID_INTEL && ((eax >> 8) & 0xF) == 6 && ((eax >> 4) & 0xF) < 3 && (eax & 0xF) < 3) {
+    return false;
+  }
+  return true;
+}
+
+bool cpuid::hasTsc() {
+  // Get TSC information from EAX=1 function in EDX register Bit 4
+  uint32_t edx, unused;
+  cpuid(1, unused, unused, unused, edx);
+
+  return ((edx >> 4) & 0x1) == 1;
+}
+
+bool cpuid::hasFpu() {
+  // Get FPU information from EAX=1 function in EDX register Bit 0
+  uint32_t edx, unused;
+  cpuid(1, unused, unused, unused, edx);
+
+  return (edx & 0x1) == 1;
+}
+
+bool cpuid::hasFxsr() {
+  // Get FXSR information from EAX=1 function in EDX register Bit 24
+  uint32_t edx, unused;
+  cpuid(1, unused, unused, unused, edx);
+
+  return ((edx >> 24) & 0x1) == 1;
+}
+
+bool cpuid::hasSse() {
+  // Get SSE information from EAX=1 function in EDX register Bit 25
+  uint32_t edx, unused;
+  cpuid(1, unused, unused, unused, edx);
+
+  return ((edx >> 25) & 0x1) == 1;
 }
 
 void getIntelCpuInfo() {
@@ -1199,11 +1243,11 @@ void getIntelCpuInfo() {
     } /* else { If brand is unsupported should use processor signature in conjunction with cache descriptors to identify the processor */
     
     
-    stdio::kprintf("CPUID - BRAND: %s - REVISION: %x", brandStr);
-    stdio::kprintf(" - REVISION: %x\n", steppingId);
-    stdio::kprintf("CPUID - FAMILY: %d - MODEL: %d - ARCH: %s\n", family, model, processorArchStr);
-    stdio::kprintf("CPUID - CACHE: %d bytes - CORES: %d - APIC_ID: %x - TYPE: %s\n", chunks * 8, count, apicId, processorTypeStr);
-    stdio::kprintf("CPUID - FEATURE_FLAGS: ");
+    KPRINTF("CPUID - BRAND: %s", brandStr);
+    KPRINTF(" - REVISION: %x\n", steppingId);
+    KPRINTF("CPUID - FAMILY: %d - MODEL: %d - ARCH: %s\n", family, model, processorArchStr);
+    KPRINTF("CPUID - CACHE: %d bytes - CORES: %d - APIC_ID: %x - TYPE: %s\n", chunks * 8, count, apicId, processorTypeStr);
+    KPRINTF("CPUID - FEATURE_FLAGS: ");
     // Print ECX feature flags
     for (i=0; i<32; i++) {
       if (i == 11 || i == 16) {
@@ -1212,11 +1256,11 @@ void getIntelCpuInfo() {
       }
       if (((ecx >> i) & 0x1) == 1) {
         // If current bit is set print the flag name
-        stdio::kprintf("%s%s", (i > 0 ? ", " : ""), INTEL_FEATURE_FLAGS_LIST[i]);
+        KPRINTF("%s%s", (i > 0 ? ", " : ""), INTEL_FEATURE_FLAGS_LIST[i]);
       }
     }
 
-    stdio::kprintf("\n - CPUID FEATURE_FLAGS2: ");
+    KPRINTF("\n - CPUID FEATURE_FLAGS2: ");
     // Print EDX feature flags
     for (i=0; i<32; i++) {
       if (i == 10 || i == 19 || i == 30) {
@@ -1225,11 +1269,11 @@ void getIntelCpuInfo() {
       }
       if (((edx >> i) & 0x1) == 1) {
         // If current bit is set print the flag name
-        stdio::kprintf("%s%s", (i > 0 ? ", " : ""), INTEL_FEATURE_FLAGS2_LIST[i]);
+        KPRINTF("%s%s", (i > 0 ? ", " : ""), INTEL_FEATURE_FLAGS2_LIST[i]);
       }
     }
 
-    stdio::kprintf("\n");
+    KPRINTF("\n");
 }
 
 void getIntelSignature(uint8_t extendedFamily, uint8_t extendedModel, uint8_t type, uint8_t family, uint8_t model, uint8_t steppingId, IntelSignature* intelSignature) {
@@ -80,6 +80,46 @@ namespace cpuid {
      * @return false APIC is not present and can't be used
      */
     bool hasApic();
+
+    /**
+     * @brief Return whether the SYSENTER and SYSEXIT fast system call instructions are supported or not
+     * 
+     * @return true  SEP is present and can be used
+     * @return false SEP is not present, software interruptions must be used instead
+     */
+    bool hasSep();
+
+    /**
+     * @brief Return whether the RDTSC instruction and the time stamp counter are supported or not
+     * 
+     * @return true  TSC is present and can be read with RDTSC
+     * @return false TSC is not present
+     */
+    bool hasTsc();
+
+    /**
+     * @brief Return whether the x87 FPU is present or not in the processor
+     * 
+     * @return true  FPU is present and can be used
+     * @return false FPU is not present
+     */
+    bool hasFpu();
+
+    /**
+     * @brief Return whether the FXSAVE and FXRSTOR instructions are supported or not
+     * 
+     * @return true  FXSR is present, the FPU and SSE state can be saved with FXSAVE
+     * @return false FXSR is not present, only FSAVE and FRSTOR can be used
+     */
+    bool hasFxsr();
+
+    /**
+     * @brief Return whether the SSE instructions are supported or not
+     * 
+     * @return true  SSE is present and can be used after CR4.OSFXSR is set
+     * @return false SSE is not present
+     */
+    bool hasSse();
 }
 
 #endif
\ No newline at end of file
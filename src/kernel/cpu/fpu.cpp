@@ -0,0 +1,179 @@
+// stdlibs
+#include "stdlib.h"
+// cpu
+#include "isr.h"
+#include "cpuid.h"
+#include "smp.h"
+#include "fpu.h"
+
+bool fpuEnabled;                        // FPU is present and configured
+bool fxsrEnabled;                       // FXSAVE/FXRSTOR are used, otherwise FSAVE/FRSTOR
+bool sseEnabled;                        // SSE instructions enabled, MXCSR must be initialized
+FpuState* fpuOwner[SMP_MAX_CPUS];       // State which registers are loaded in the FPU of each cpu
+FpuState* fpuCurrent[SMP_MAX_CPUS];     // State of the process running on each cpu
+
+uint32_t readCr0() {
+    uint32_t cr0;
+    asm volatile("mov %%cr0, %0" : /* output */ "=r"(cr0));
+    return cr0;
+}
+
+void writeCr0(uint32_t cr0) {
+    asm volatile("mov %0, %%cr0" : /* output */ : /* input */ "r"(cr0));
+}
+
+/**
+ * @brief Get the 16 bytes aligned save area of the given state
+ * 
+ * @param state     FPU state
+ * @return uint8_t* Aligned save area
+ */
+uint8_t* alignedArea(FpuState* state) {
+    return (uint8_t*) (((uint32_t) state->area + FPU_STATE_ALIGN - 1) & ~(FPU_STATE_ALIGN - 1));
+}
+
+void saveState(FpuState* state) {
+    if (fxsrEnabled) {
+        asm volatile("fxsave (%0)" : /* output */ : /* input */ "r"(alignedArea(state)) : "memory");
+    } else {
+        asm volatile("fnsave (%0)" : /* output */ : /* input */ "r"(alignedArea(state)) : "memory");
+    }
+}
+
+void restoreState(FpuState* state) {
+    if (fxsrEnabled) {
+        asm volatile("fxrstor (%0)" : /* output */ : /* input */ "r"(alignedArea(state)) : "memory");
+    } else {
+        asm volatile("frstor (%0)" : /* output */ : /* input */ "r"(alignedArea(state)) : "memory");
+    }
+}
+
+/**
+ * @brief #NM handler. Load the FPU/SSE registers of the running process.
+ * 
+ * @param r Registers pushed by isr_dispatcher
+ */
+void deviceNotAvailableHandler(registers_t*) {
+    uint8_t cpu = smp::getCpuIndex();
+    FpuState* current = fpuCurrent[cpu];
+
+    asm volatile("clts");                           // Allow FPU/SSE instructions again
+    if (fpuOwner[cpu] == current && (current == NULL || current->cpu == cpu)) { // Registers already belong to the running process
+        return;
+    }
+
+    if (fpuOwner[cpu] != NULL && smp::getCpuCount() == 1) { // Save the registers of the last process that used the FPU. Already saved on SMP
+        saveState(fpuOwner[cpu]);
+    }
+
+    fpuOwner[cpu] = current;
+    if (current == NULL) {                          // Kernel context, no state to load
+        return;
+    }
+
+    current->cpu = cpu;
+    if (current->initialized) {
+        restoreState(current);
+    } else {                                        // First FPU/SSE instruction of this process
+        asm volatile("fninit");
+        if (sseEnabled) {
+            uint32_t mxcsr = FPU_MXCSR_DEFAULT;
+            asm volatile("ldmxcsr %0" : /* output */ : /* input */ "m"(mxcsr));
+        }
+        current->initialized = true;
+    }
+}
+
+/**
+ * @brief Enable the FPU of the running cpu, and FXSAVE/SSE when fxsrEnabled
+ * 
+ */
+void configureCpu() {
+    uint32_t cr0;
+    uint32_t cr4;
+
+    cr0 = readCr0();
+    cr0 &= ~CR0_EM;                                 // Execute the FPU instructions instead of raising #NM
+    cr0 |= CR0_MP | CR0_NE;
+    writeCr0(cr0);
+    asm volatile("fninit");
+
+    if (fxsrEnabled) {
+        asm volatile("mov %%cr4, %0" : /* output */ "=r"(cr4));
+        cr4 |= CR4_OSFXSR;
+        if (sseEnabled) {
+            cr4 |= CR4_OSXMMEXCPT;
+        }
+        asm volatile("mov %0, %%cr4" : /* output */ : /* input */ "r"(cr4));
+    }
+
+    writeCr0(readCr0() | CR0_TS);                   // Nobody owns the FPU yet
+}
+
+uint8_t fpu::install() {
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    fpuEnabled = false;
+    fxsrEnabled = false;
+    sseEnabled = false;
+    for (int i = 0; i < SMP_MAX_CPUS; i++) {
+        fpuOwner[i] = NULL;
+        fpuCurrent[i] = NULL;
+    }
+
+    if (!cpuid::hasFpu()) {
+        return FPU_ERROR_NOT_PRESENT;
+    }
+
+    fxsrEnabled = cpuid::hasFxsr();
+    sseEnabled = fxsrEnabled && cpuid::hasSse();
+    configureCpu();
+
+    isr::registerIsrHandler(FPU_ISR_NM, deviceNotAvailableHandler);
+    fpuEnabled = true;
+
+    return sseEnabled ? FPU_NO_ERROR : FPU_ERROR_SSE_NOT_PRESENT;
+}
+
+void fpu::installCpu() {
+    if (fpuEnabled) {
+        configureCpu();
+    }
+}
+
+void fpu::initState(FpuState* state) {
+    state->initialized = false;
+    state->cpu = 0;
+}
+
+void fpu::switchTo(FpuState* state) {
+    uint8_t cpu = smp::getCpuIndex();
+    FpuState* prev = fpuCurrent[cpu];
+
+    fpuCurrent[cpu] = state;
+    if (!fpuEnabled) {
+        return;
+    }
+
+    // The process being switched out can be switched in by another cpu, save its registers while they are reachable.
+    // CR0.TS is clear since the registers loaded in this cpu belong to the running process.
+    if (prev != NULL && prev == fpuOwner[cpu] && prev->cpu == cpu && smp::getCpuCount() > 1) {
+        saveState(prev);
+        if (!fxsrEnabled) {
+            fpuOwner[cpu] = NULL;                   // FNSAVE reinitializes the FPU, the registers aren't kept
+        }
+    }
+
+    if (state != NULL && state == fpuOwner[cpu] && state->cpu == cpu) {
+        asm volatile("clts");                       // Registers are still loaded, no #NM needed
+    } else {
+        writeCr0(readCr0() | CR0_TS);               // Trap the next FPU/SSE instruction
+    }
+}
+
+void fpu::releaseState(FpuState* state) {
+    for (int i = 0; i < SMP_MAX_CPUS; i++) {
+        if (fpuOwner[i] == state) {
+            fpuOwner[i] = NULL;
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#ifndef _FPU_H_
+#define _FPU_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FPU_NO_ERROR 0                  // No error happend. Same as Success
+#define FPU_ERROR_NOT_PRESENT 1         // Cpu don't have a FPU, floating point instructions can't be used
+#define FPU_ERROR_SSE_NOT_PRESENT 2     // FPU enabled, but FXSAVE or SSE are not supported. Only x87 instructions can be used
+
+#define FPU_ISR_NM 7                    // (NM) Device not available exception. Raised by FPU/SSE instructions while CR0.TS is set
+
+#define FPU_STATE_SIZE 512              // FXSAVE area size. FSAVE only uses the first 108 bytes
+#define FPU_STATE_ALIGN 16              // FXSAVE and FXRSTOR require a 16 bytes aligned area
+#define FPU_MXCSR_DEFAULT 0x1F80        // All SIMD exceptions masked, round to nearest
+
+#define CR0_MP (1 << 1)                 // Monitor coprocessor. WAIT/FWAIT also raise #NM when TS is set
+#define CR0_EM (1 << 2)                 // Emulation. When set every FPU instruction raises #NM
+#define CR0_TS (1 << 3)                 // Task switched. Next FPU/SSE instruction raises #NM
+#define CR0_NE (1 << 5)                 // Numeric error. FPU errors are reported with #MF instead of IRQ13
+#define CR4_OSFXSR (1 << 9)             // OS supports FXSAVE/FXRSTOR. Enables the SSE instructions
+#define CR4_OSXMMEXCPT (1 << 10)        // OS handles the SIMD floating point exception #XM
+
+/**
+ * @brief FPU/SSE registers of one process
+ * 
+ */
+typedef struct {
+    uint8_t area[FPU_STATE_SIZE + FPU_STATE_ALIGN];    // Saved registers, the FXSAVE area is aligned inside it
+    bool initialized;                                   // False until the process executes its first FPU/SSE instruction
+    uint8_t cpu;                                        // Cpu whose FPU registers were last loaded with this state
+} FpuState;
+
+/**
+ * @brief FPU - Floating Point Unit and SSE state management
+ * 
+ * LAZY_SWITCHING:
+ *    - The FPU/SSE registers are not saved on every context switch. CR0.TS is set instead.
+ *    - The first FPU/SSE instruction executed by the next process raises #NM (ISR 7).
+ *    - The #NM handler clears CR0.TS, saves the registers in the state of the last process that used them and restores the state
+ *      of the running process. Or initializes them if the process never used the FPU.
+ *    - Processes that never execute FPU/SSE instructions never pay the save and restore cost.
+ *
+ * SMP:
+ *    - Each cpu has its own FPU registers, owner and running state.
+ *    - A process can be switched in by another cpu, where its registers can't be saved from. When more than one cpu is online
+ *      the registers are saved when the owner is switched out, and kept loaded: the next switch in on the same cpu
+ *      still skips the restore, unless the process was loaded by another cpu meanwhile.
+ */
+namespace fpu {
+    /**
+     * @brief Enable the FPU and if supported the SSE instructions with CR4.OSFXSR.
+     *        Register the #NM handler. Must be called after isr::install.
+     * 
+     * @return uint8_t 0=FPU_NO_ERROR, 1=FPU_ERROR_NOT_PRESENT, 2=FPU_ERROR_SSE_NOT_PRESENT
+     */
+    uint8_t install();
+
+    /**
+     * @brief Enable the FPU and SSE instructions of an application processor with the configuration of fpu::install
+     * 
+     */
+    void installCpu();
+
+    /**
+     * @brief Initialize the FPU state of a new process. Its registers are initialized on its first FPU/SSE instruction.
+     * 
+     * @param state FPU state of the process
+     */
+    void initState(FpuState* state);
+
+    /**
+     * @brief Called on every context switch. Set CR0.TS unless the state of the next process is the one loaded in the FPU.
+     * 
+     * @param state FPU state of the next process or NULL for the kernel idle context
+     */
+    void switchTo(FpuState* state);
+
+    /**
+     * @brief Forget the given state if it's loaded in the FPU. Called when the process is terminated.
+     * 
+     * @param state FPU state of the terminated process
+     */
+    void releaseState(FpuState* state);
+}
+
+#endif
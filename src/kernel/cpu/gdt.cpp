@@ -1,7 +1,12 @@
+// memory
+#include "memutils.h"
+// cpu
+#include "paging.h"
 #include "gdt.h"
 
 gdt_entry_t gdt_entries[MAX_GDT_ENTRIES];
 gdt_ptr_t gdt_ptr;
+tss_entry_t tss[GDT_TSS_COUNT];
 
 /**
  * @brief Set GDT entry parameters. Since they aren't linear we need to perform bitwise operations in 32, 16 and 8 bits variables
@@ -44,7 +49,33 @@ void gdt::install(void)
 	gdt_set_gate(2, 0, 0xffffffff, 0x92, 0xcf); 		// Kernel          - 0x10 - Data segment 		- (0x92 = 10010010) (0xcf = 11001111)
 	gdt_set_gate(3, 0, 0xffffffff, 0xfa, 0xcf); 		// User            - 0x18 - Code segment 	    - (0xfa = 11111010) (0xcf = 11001111)
 	gdt_set_gate(4, 0, 0xffffffff, 0xf2, 0xcf); 		// User            - 0x20 - Data segment 		- (0xf2 = 11110010) (0xcf = 11001111)
-	// gdt_set_gate(5, &tss, sizeof(tss), 0xf2, 0xcf); 	// TSS             - 0x28 - Task state segment
+	for (int i = 0; i < GDT_TSS_COUNT; i++) {
+		gdt_set_gate(5 + i, (uint32_t) &tss[i], sizeof(tss_entry_t) - 1, 0x89, 0x00); // TSS - 0x28 + cpu * 8 - Task state segment - (0x89 = 10001001) (0x00 = 00000000)
 
+		// Since tss is in .bss section it must be initialized before use
+		memutils::memset(&tss[i], 0, sizeof(tss_entry_t));
+		tss[i].ss0 = GDT_KERNEL_DATA_SEL;							// Kernel data segment used as stack when entering ring 0
+		tss[i].esp0 = KERNEL_STACK_END_ADDR;						// Top of the kernel stack, replaced by the process kernel stack
+		tss[i].iomap_base = sizeof(tss_entry_t);					// No I/O permission bitmap, user mode can't access I/O ports
+	}
+
+	gdt_flush((uint32_t) &gdt_ptr);
+
+	// Load the TSS selector into the task register
+	asm volatile("ltr %%ax" : /* output */ : /* input */ "a"(GDT_TSS_SEL));
+}
+
+void gdt::installCpu(uint8_t cpu) {
 	gdt_flush((uint32_t) &gdt_ptr);
+
+	// Each cpu loads its own TSS, ltr marks its descriptor as busy
+	asm volatile("ltr %%ax" : /* output */ : /* input */ "a"(GDT_TSS_SEL + cpu * 8));
+}
+
+void gdt::setKernelStack(uint8_t cpu, uint32_t esp0) {
+	tss[cpu].esp0 = esp0;
+}
+
+tss_entry_t* gdt::getTss(uint8_t cpu) {
+	return &tss[cpu];
 }
\ No newline at end of file
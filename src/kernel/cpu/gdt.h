@@ -4,7 +4,15 @@
 
 #include <stdint.h>
 
-#define MAX_GDT_ENTRIES 5
+#define GDT_TSS_COUNT 8             // One task state segment per cpu
+#define MAX_GDT_ENTRIES (5 + GDT_TSS_COUNT)
+
+// GDT segment selectors (entry offset | requested privilege level)
+#define GDT_KERNEL_CODE_SEL 0x08    // Kernel code segment - RPL 0
+#define GDT_KERNEL_DATA_SEL 0x10    // Kernel data segment - RPL 0
+#define GDT_USER_CODE_SEL   0x1B    // User code segment   - 0x18 | RPL 3
+#define GDT_USER_DATA_SEL   0x23    // User data segment   - 0x20 | RPL 3
+#define GDT_TSS_SEL         0x28    // Task state segment  - RPL 0. Of the cpu 0, the cpu n uses GDT_TSS_SEL + n * 8
 
 /** 
  * GDT - Global Descriptor Table - Intel x86 and x86_64
@@ -155,6 +163,30 @@ struct gdt_entry {
 
 typedef struct gdt_entry gdt_entry_t;
 
+/**
+ * @brief TSS - Task State Segment
+ * 
+ * We don't use hardware task switching. The only fields read by the CPU are ss0:esp0, that are loaded
+ * into SS:ESP when an interruption or exception moves the CPU from ring 3 to ring 0.
+ * The iomap_base points beyond the segment limit so no I/O permission bitmap is present.
+ * Each cpu runs a different process, so each cpu loads its own TSS in the task register.
+ */
+struct tss_entry {
+	uint32_t prev_tss;		// Previous TSS when hardware task switching is used
+	uint32_t esp0;			// Stack pointer loaded when changing to kernel mode
+	uint32_t ss0;			// Stack segment loaded when changing to kernel mode
+	uint32_t esp1, ss1;		// Ring 1 stack - Unused
+	uint32_t esp2, ss2;		// Ring 2 stack - Unused
+	uint32_t cr3;
+	uint32_t eip, eflags, eax, ecx, edx, ebx, esp, ebp, esi, edi;
+	uint32_t es, cs, ss, ds, fs, gs;
+	uint32_t ldt;
+	uint16_t trap;
+	uint16_t iomap_base;
+} __attribute__((packed));
+
+typedef struct tss_entry tss_entry_t;
+
 /**
  * @brief Reload GDT into CPU system
  * This will performed by executing instruction lgdt [gdtr] in Intel CPU
@@ -165,10 +197,33 @@ extern "C" void gdt_flush(uint32_t gdtr);
 
 namespace gdt {
 	/**
-	 * @brief Install a new GDT into CPU system
+	 * @brief Install a new GDT into CPU system. Load the TSS of the cpu 0, the bootstrap processor
 	 * 
 	 */
 	void install(void);
+
+	/**
+	 * @brief Load the GDT installed by gdt::install and the TSS of an application processor
+	 * 
+	 * @param cpu Cpu index, 1 to GDT_TSS_COUNT - 1
+	 */
+	void installCpu(uint8_t cpu);
+
+	/**
+	 * @brief Set the kernel stack pointer loaded by the CPU when an interruption happens in user mode (TSS esp0)
+	 * 
+	 * @param cpu  Cpu index
+	 * @param esp0 Top address of the kernel stack
+	 */
+	void setKernelStack(uint8_t cpu, uint32_t esp0);
+
+	/**
+	 * @brief Get the TSS of a cpu
+	 * 
+	 * @param cpu 			 Cpu index
+	 * @return tss_entry_t*  Task state segment
+	 */
+	tss_entry_t* getTss(uint8_t cpu);
 }
 
 #endif
\ No newline at end of file
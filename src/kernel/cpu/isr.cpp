@@ -3,21 +3,51 @@
 // cpu
 #include "idt.h"
 #include "pic.h"
+#include "apic.h"
+#include "smp.h"
+#include "tsc.h"
 #include "isr.h"
+// legacy drivers
+#include "vga.h"
+#include "serial.h"
+// memory
+#include "memutils.h"
 // stdlibs
-#include "stdio.h"      // Debug only
+#include "stdio.h"
 #include "stdlib.h"
 // sys
 #include "syscalls.h"
+#include "softirq.h"
 // process
 #include "scheduler.h"
 
-extern "C" unsigned int kernelESP; // Imported from scheduler.cpp
 
 #define IDT_MESSAGES_LEN 32
 #define INTERRUPT_HANDLERS_SIZE 256
 
+/**
+ * @brief Counters of one IRQ line. Updated by irq_handler with the kernel lock held, before the interruptions are enabled.
+ * 
+ */
+typedef struct {
+    uint32_t count;                         // Interruptions received, spurious ones included
+    uint32_t printedCount;                  // count when the stats were printed the last time, shows the storms
+    uint32_t spurious;                      // Spurious IRQ7/IRQ15 filtered with the PIC In-Service Register
+    uint64_t totalCycles;                   // Cycles spent in the handler
+    uint32_t maxCycles;                     // Slowest handler run
+    uint32_t histogram[ISR_HISTOGRAM_BUCKETS];  // Handler runs by duration, bucket i counts runs under 2^(ISR_HISTOGRAM_FIRST_SHIFT + i) cycles
+} IrqStats;
+
 isr_t interruptHandlers[IDT_ENTRIES];
+uint32_t irqOffMaxCycles[SMP_MAX_CPUS];     // Longest time from the kernel entry to the end of the top half, with the interruptions disabled
+IrqStats irqStats[ISR_IRQ_COUNT];
+uint32_t apicSpuriousCount;                 // Incremented by isr_spurious, the APIC spurious vector has no C handler
+
+const char* irqNames[ISR_IRQ_COUNT] = {
+    "pit", "keyboard", "cascade", "com2", "com1", "lpt2", "floppy", "lpt1",
+    "rtc", "acpi", "irq10", "irq11", "mouse", "fpu", "ide0", "ide1",
+    "apic timer", "hpet", "reschedule"
+};
 
 const char* idtMessages[IDT_MESSAGES_LEN] {                        // 627 length
     "Fault - (DE) Divide Error",                                    // 25 length
@@ -57,27 +87,95 @@ const char* idtMessages[IDT_MESSAGES_LEN] {                        // 627 length
 extern "C" void* isr_stub_table[];  // Reference to ISR function pointers
 
 extern "C" void isr_handler(registers_t* r) { // INTEL - ISR Handler
+    if (interruptHandlers[r->int_no] != 0) {
+        interruptHandlers[r->int_no](r); // Exception handled by a driver, like #NM by the FPU. Resume the interrupted code
+        return;
+    }
+
     // Print the interruption cause
-    stdio::kprintf("ISR(%d) - ERR_CODE(%d) - %s\n", r->int_no, r->err_code, IFNULL(r->int_no < IDT_MESSAGES_LEN ? idtMessages[r->int_no] : "User - (UI) User interruption", "Reserved - (IR) Intel Reserved"));
-    stdio::kprintf("CPU - eip: %x - cs: %x - ss: %x - ebp: %x - esp: %x\n", r->eip, r->cs, r->ss, r->ebp, r->esp);
+    KPRINTF("ISR(%d) - ERR_CODE(%d) - %s\n", r->int_no, r->err_code, IFNULL(r->int_no < IDT_MESSAGES_LEN ? idtMessages[r->int_no] : "User - (UI) User interruption", "Reserved - (IR) Intel Reserved"));
+    KPRINTF("CPU - eip: %x - cs: %x - ss: %x - ebp: %x - esp: %x\n", r->eip, r->cs, r->ss, r->ebp, r->esp);
+    vga::flush();                   // The flush tasklet won't run anymore
+    serial::flush();                // Nor the serial interruption
     __asm__ volatile ("cli; hlt");  // Halt the cpu Completely hangs the computer
     return;
 }
 
+/**
+ * @brief Add the duration of a handler run to the IRQ counters
+ * 
+ * @param stats     Counters of the IRQ line
+ * @param cycles    TSC cycles spent in the handler
+ */
+void isrRecordHandlerCycles(IrqStats* stats, uint32_t cycles) {
+    uint32_t bucket = 0;
+    uint32_t shifted = cycles >> ISR_HISTOGRAM_FIRST_SHIFT;
+
+    while (shifted != 0 && bucket < ISR_HISTOGRAM_BUCKETS - 1) {    // log2 buckets, the last one has no upper bound
+        shifted >>= 1;
+        bucket++;
+    }
+    stats->histogram[bucket]++;
+    stats->totalCycles += cycles;
+    if (cycles > stats->maxCycles) {
+        stats->maxCycles = cycles;
+    }
+}
+
 extern "C" void irq_handler(registers_t* r) { // PIC - IRQs Handler
-    // stdio::kprintf("IRQ(%d) - IRQ_CODE(%d)\n", r->int_no, r->err_code);
-    
+    uint64_t entryTsc = tsc::read();
+    uint64_t handlerTsc;
+    uint32_t cycles;
+    uint8_t cpu;
+    uint8_t irq = r->err_code & 0xFF;
+    IrqStats* stats = &irqStats[irq];
+
+    // KPRINTF("IRQ(%d) - IRQ_CODE(%d)\n", r->int_no, r->err_code);
+    smp::lockKernel();
+    softirq::irqEnter();
+    stats->count++;
+
+    if (!apic::isEnabled() && pic::isSpurious(irq)) {
+        stats->spurious++;
+        if (irq == PIC_SPURIOUS_SLAVE_IRQ) {
+            pic::sendEOI(PIC_CASCADE_IRQ);  // The master PIC saw a real request on the cascade line, only the slave one went away
+        }
+        softirq::irqExit();
+        smp::unlockKernel();                // Nothing in service, no handler and no EOI
+        return;
+    }
+
     if (interruptHandlers[r->int_no] != 0) {
+        handlerTsc = tsc::read();
         interruptHandlers[r->int_no](r); // If the handler is not null notify the handler about the interruption
+        isrRecordHandlerCycles(stats, (uint32_t) (tsc::read() - handlerTsc));
     }
 
-    pic::sendEOI(r->err_code & 0xFF); // Send the EOI End Of Interruption signal to the PIC IRQ line that was triggered
+    if (apic::isEnabled()) {
+        apic::sendEOI();                  // A single write to the local APIC EOI register
+    } else {
+        pic::sendEOI(irq);                // Send the EOI End Of Interruption signal to the PIC IRQ line that was triggered
+    }
+
+    cpu = smp::getCpuIndex();
+    cycles = (uint32_t) (tsc::read() - entryTsc);
+    if (cycles > irqOffMaxCycles[cpu]) {
+        irqOffMaxCycles[cpu] = cycles;
+    }
+    softirq::run();                       // Bottom halves, with the interruptions enabled
+    softirq::irqExit();                   // Before a process switch, the next process may not return through an interruption
+
+    if ((r->cs & 0x3) == 0x3) {           // Returning to user mode, switch process if its time slice is over
+        scheduler::preempt();
+    }
+    smp::unlockKernel();                  // Released by the cpu that returns, the process may have been switched in by another cpu
     return;
 }
 
-extern "C" void isr48_handler(IntRegisters r) { // USER - ISR Handler
-    asm("mov %0, %%esp" : : "r" (kernelESP)); // Change context to the kernel stack pointer
-    syscalls::syscallHandler(&r);
+extern "C" void isr48_handler(IntRegisters* r) { // USER - ISR Handler, also called by sysenter_entry
+    smp::lockKernel();
+    syscalls::syscallHandler(r);
+    smp::unlockKernel();
 }
 
 void isr::install() {
@@ -87,6 +185,13 @@ void isr::install() {
     for(i=0; i<IDT_ENTRIES; i++) {
         registerIsrHandler(i, 0); // Not present
     }
+    for (i=0; i<SMP_MAX_CPUS; i++) {
+        irqOffMaxCycles[i] = 0;
+    }
+    for (i=0; i<ISR_IRQ_COUNT; i++) {
+        memutils::memset(&irqStats[i], 0, sizeof(IrqStats));
+    }
+    apicSpuriousCount = 0;
 
     // Setup the isr interrupt functions that was created in isr_int.asm
     for (i=0; i<32; i++) {
@@ -103,7 +208,13 @@ void isr::install() {
     }
     
     // Setup the user interrupt functions that was created in isr_int.asm
+    // DPL 3 is required to allow the int instruction to be executed from user mode
     for (; i<49; i++) {
+        idt::setGate(i, (uint32_t) isr_stub_table[i], IDT_KERNEL_CS, IDT_GATE_PRESENT, IDT_GATE_DPL_PRIVILEGE_LOW, IDT_GATE_STORAGE_SEG_INT, IDT_GATE_TYPE_X86_INTERRUPT);
+    }
+
+    // Setup the local APIC timer, HPET and reschedule IPI interruptions that were created in isr_int.asm
+    for (; i<52; i++) {
         idt::setGate(i, (uint32_t) isr_stub_table[i], IDT_KERNEL_CS, IDT_GATE_PRESENT, IDT_GATE_DPL_PRIVILEGE_MAX, IDT_GATE_STORAGE_SEG_INT, IDT_GATE_TYPE_X86_INTERRUPT);
     }
 
@@ -120,4 +231,44 @@ void isr::install() {
 
 void isr::registerIsrHandler(uint16_t isrIndex, isr_t handler) {
     interruptHandlers[isrIndex] = handler;
+}
+
+void isr::printIrqStats() {
+    uint32_t i;
+    uint32_t j;
+    uint32_t handled;
+    IrqStats* stats;
+
+    KPRINTF("------------ IRQs ------------\n");
+    for (i = 0; i < ISR_IRQ_COUNT; i++) {
+        stats = &irqStats[i];
+        if (stats->count == 0) {
+            continue;
+        }
+        handled = stats->count - stats->spurious;
+        KPRINTF("IRQ %d %s: %d (+%d), spurious %d", i, irqNames[i], stats->count, stats->count - stats->printedCount, stats->spurious);
+        if (handled > 0) {
+            KPRINTF(", cycles avg %d max %d", (uint32_t) stdlib::udiv64(stats->totalCycles, handled, NULL), stats->maxCycles);
+        }
+        KPRINTF("\n   ");
+        for (j = 0; j < ISR_HISTOGRAM_BUCKETS; j++) {  // Bucket limits in KiB cycles: <1K, <2K ... <256K, >=256K
+            if (j < ISR_HISTOGRAM_BUCKETS - 1) {
+                KPRINTF(" <%dK:%d", 1 << j, stats->histogram[j]);
+            } else {
+                KPRINTF(" >=%dK:%d", 1 << (j - 1), stats->histogram[j]);
+            }
+        }
+        KPRINTF("\n");
+        stats->printedCount = stats->count;
+    }
+    if (apic::isEnabled()) {
+        KPRINTF("APIC spurious: %d\n", apicSpuriousCount);
+    }
+    if (serial::getDroppedBytes() > 0) {
+        KPRINTF("COM1 output dropped: %d bytes\n", serial::getDroppedBytes());
+    }
+    for (i = 0; i < smp::getCpuCount(); i++) {
+        KPRINTF("CPU %d: longest irqs off %d cycles\n", i, irqOffMaxCycles[i]);
+    }
+    KPRINTF("-----------------------------");
 }
\ No newline at end of file
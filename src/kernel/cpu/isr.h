@@ -21,6 +21,13 @@
 #define IRQ13 45 	// Co-processador matemático
 #define IRQ14 46	// Drives IDE primários
 #define IRQ15 47	// Drives IDE secundários
+#define IRQ_APIC_TIMER 49	// Local APIC timer, scheduler tick (48 is the syscall interruption)
+#define IRQ_HPET 50			// HPET comparator 0, one-shot event of the idle cpu
+#define IRQ_RESCHEDULE 51	// Inter-processor interruption that wakes up an idle cpu when a process is ready
+
+#define ISR_IRQ_COUNT 19				// IRQ indexes dispatched by irq_handler: the 16 legacy lines, APIC timer, HPET and reschedule IPI
+#define ISR_HISTOGRAM_BUCKETS 10		// Handler duration buckets of each IRQ
+#define ISR_HISTOGRAM_FIRST_SHIFT 10	// The first bucket counts the handler runs under 2^10 = 1024 cycles, each next one doubles
 
 /**
  * @brief ISR - Interrupt Service Routine
@@ -53,7 +60,7 @@ typedef struct registers {
 typedef struct
 {
     unsigned int edi, esi, ebp, esp, ebx, edx, ecx, eax;
-    unsigned int eip, cs, eflags;
+    unsigned int eip, cs, eflags, useresp, ss;
 } IntRegisters;
 
 /**
@@ -77,6 +84,14 @@ namespace isr {
 	 * @param handler 	callback handler
 	 */
 	void registerIsrHandler(uint16_t isrIndex, isr_t handler);
+
+	/**
+	 * @brief Print the counters of each IRQ received: interruptions, the ones since the last print (storms), spurious ones,
+	 *        handler cycles and their histogram. Also the longest time an IRQ kept the interruptions disabled on each cpu,
+	 *        from the kernel entry to the EOI. The tasklets run after it with the interruptions enabled.
+	 * 
+	 */
+	void printIrqStats();
 }
 
 #endif
\ No newline at end of file
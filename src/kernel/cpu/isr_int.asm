@@ -10,6 +10,9 @@
 [extern irq_handler]        ; Reference irq_handler exported function from isr.cpp file
 [extern isr48_handler]      ; Reference isr48_handler exported function from isr.cpp file
 [global isr_stub_table]     ; Export isr_stub_table vector to be used in isr.cpp file
+[global sysenter_entry]     ; Export sysenter_entry to be written in the SYSENTER_EIP MSR in syscalls.cpp file
+[global isr_spurious]       ; Export isr_spurious to be set as the APIC spurious interruption gate in apic.cpp file
+[extern apicSpuriousCount]  ; Reference apicSpuriousCount variable from isr.cpp file
 
 ; NASM - Macros
 ;
@@ -136,7 +139,7 @@ irq_dispatcher:
     mov ax, ds              ; lower 16 bits is in the ds register
 	push eax                ; Save the segment descriptor onto stack
 
-	mov ax, 0x10            ; Load the kernel segment descriptor
+	mov ax, 0x23            ; Load the flat data segment shared by the kernel and the processes, the irq can switch process
 	mov ds, ax              ; Set the segment register's
 	mov es, ax              ; Set the segment register's
 	mov fs, ax              ; Set the segment register's
@@ -145,7 +148,7 @@ irq_dispatcher:
 	push esp                ; Push the old stack frame to the new kernel stack frame since we changed to kernel code segment
 	cld                     ; Clear the direction flag
     
-    call irq_handler        ; C function to handle ISR's
+    call irq_handler        ; C function to handle ISR's. May switch process before returning to user mode
     
     pop ebx                 ; Pop ebx that was pushed earlier when we push esp
 	pop ebx                 ; Pop the segment descriptor from the stack
@@ -165,7 +168,7 @@ irq_dispatcher:
 ; =============================
 isr_stub_table:
 %assign i 0
-%rep    49
+%rep    52
     dd isr_stub_%+i ; use DQ instead if targeting 64-bit
 %assign i i+1
 %endrep
@@ -234,25 +237,54 @@ irq_stub 44, 12
 irq_stub 45, 13
 irq_stub 46, 14
 irq_stub 47, 15
+irq_stub 49, 16             ; Local APIC timer, dispatched as irq 16
+irq_stub 50, 17             ; HPET comparator 0, dispatched as irq 17
+irq_stub 51, 18             ; Reschedule IPI, dispatched as irq 18
+
+; =============================
+; APIC SPURIOUS INTERRUPTION:
+; Raised by the local APIC when an interruption goes away before it's accepted.
+; It's not in service, so it must return without EOI.
+; =============================
+isr_spurious:
+    lock inc dword [apicSpuriousCount]                  ; Shown by isr::printIrqStats
+    iret
 
 isr_stub_48:
-    cli
+    pusha                   ; The cpu pushed the user SS, ESP, EFLAGS, CS and EIP on the process kernel stack. Completes IntRegisters
+    push esp                ; IntRegisters* argument
+    cld                     ; Clear the direction flag
+
+    call isr48_handler      ; C function to handle the syscall. Returns when the process is scheduled again
+
+    add esp, 4              ; Clean up the IntRegisters* argument
+    popa
+    iret                    ; Restore the user EFLAGS (interrupts enabled) and return to ring 3
+
+; =============================
+; SYSENTER ENTRY:
+; Fast system call entry point. SYSENTER loads CS, SS, ESP and EIP from the SYSENTER MSRs and clears IF,
+; but don't save anything. The user code gives its stack pointer in ecx and its return address in edx.
+; SYSEXIT returns to ring 3 with CS = SYSENTER_CS + 16, SS = SYSENTER_CS + 24, EIP = edx and ESP = ecx.
+; =============================
+sysenter_entry:
+    mov esp, [esp+4]        ; The SYSENTER_ESP MSR holds the address of the cpu TSS. Switch to the running process kernel stack (TSS esp0)
+
+    push dword 0x23         ; Build the same IntRegisters frame as int 0x30: user SS
+    push ecx                ; User stack pointer
+    push dword 0x202        ; EFLAGS, interrupts enabled. SYSENTER don't save the flags
+    push dword 0x1B         ; User CS
+    push edx                ; User return address
     pusha
-    mov ax, 0x10
-    mov ds, ax
-    mov es, ax
-    mov gs, ax
-    mov fs, ax
-    mov ss, ax
-    
-    call isr48_handler
-    
-    mov eax, 0x10
-    mov ss, ax
-    mov ds, ax
-    mov es, ax
-    mov fs, ax
-    mov gs, ax
+
+    push esp                ; IntRegisters* argument
+    cld                     ; Clear the direction flag
+
+    call isr48_handler      ; C function to handle the syscall. Returns when the process is scheduled again
+
+    add esp, 4              ; Clean up the IntRegisters* argument
     popa
-    sti
-    iret 
\ No newline at end of file
+    mov edx, [esp]          ; SYSEXIT loads EIP from edx
+    mov ecx, [esp+12]       ; SYSEXIT loads ESP from ecx
+    sti                     ; Interrupts are only enabled after the next instruction, so SYSEXIT is executed first
+    sysexit
@@ -0,0 +1,12 @@
+// cpu
+#include "msr.h"
+
+uint64_t msr::read(uint32_t msr) {
+    uint32_t low, high;
+    asm volatile("rdmsr" : /* output */ "=a"(low), "=d"(high) : /* input */ "c"(msr));
+    return ((uint64_t) high << 32) | low;
+}
+
+void msr::write(uint32_t msr, uint64_t value) {
+    asm volatile("wrmsr" : /* output */ : /* input */ "c"(msr), "a"((uint32_t) value), "d"((uint32_t) (value >> 32)));
+}
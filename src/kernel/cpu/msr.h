@@ -0,0 +1,40 @@
+#pragma once
+#ifndef _MSR_H_
+#define _MSR_H_
+
+// libc
+#include <stdint.h>
+
+#define MSR_IA32_SYSENTER_CS  0x174     // Kernel code segment loaded by SYSENTER. SS = CS + 8, user CS = CS + 16, user SS = CS + 24
+#define MSR_IA32_SYSENTER_ESP 0x175     // Kernel stack pointer loaded by SYSENTER
+#define MSR_IA32_SYSENTER_EIP 0x176     // Kernel entry point address jumped by SYSENTER
+
+/**
+ * @brief MSR - Model Specific Registers
+ * 
+ * Registers used to control cpu features that are not part of the x86 architecture registers.
+ * Each register is 64 bits long and is identified by a 32 bits address.
+ *    - RDMSR: Reads the register given in ECX into EDX:EAX.
+ *    - WRMSR: Writes EDX:EAX into the register given in ECX.
+ * 
+ * Both instructions can only be executed in ring 0. The presence of MSRs is reported by CPUID EAX=1 in EDX register Bit 5.
+ */
+namespace msr {
+    /**
+     * @brief Read a model specific register
+     * 
+     * @param msr       Register address
+     * @return uint64_t Register value
+     */
+    uint64_t read(uint32_t msr);
+
+    /**
+     * @brief Write a model specific register
+     * 
+     * @param msr   Register address
+     * @param value Value to write
+     */
+    void write(uint32_t msr, uint64_t value);
+}
+
+#endif
@@ -1,14 +1,18 @@
 // stdlibs
 #include "stdio.h"
+#include "stdlib.h"
 // drivers - legacy
 #include "paging.h"
 #include "vga.h"
+// sys
+#include "spinlock.h"
 
 // frames list control the frames that are in use and free
 // Each frame is one bit
 // If the bit is set the frame is in use
 // If the bit is unset the frame is free
 unsigned char frames[FRAMES_COUNT];
+Spinlock framesLock;    // Frames are allocated and released by all cpus
 
 /**
  * @brief Pointer to the start of kernel Paging entry structure 
@@ -17,11 +21,69 @@ unsigned char frames[FRAMES_COUNT];
  */
 PageDirectory* pageDirectory;
 
+PageDirectory* cpuDirectories[PAGING_MAX_CPU_DIRECTORIES];  // Page directories of the application processors
+unsigned int cpuDirectoryCount;
+
+/**
+ * @brief Get the page directory loaded in cr3 by the running cpu
+ * 
+ * @return PageDirectory* Page directory
+ */
+PageDirectory* currentDirectory() {
+    uint32_t cr3;
+
+    asm volatile("mov %%cr3, %0" : /* output */ "=r"(cr3));
+    return (PageDirectory*) cr3;
+}
+
+/**
+ * @brief Get the page table of a directory entry. Every directory uses the same kernel page table for a given entry,
+ *        except the first entry of the application processors directories.
+ * 
+ * @param pageDir       Page directory
+ * @param pageTableNr   Directory entry
+ * @return PageTable*   Page table
+ */
+PageTable* getPageTable(PageDirectory* pageDir, int pageTableNr) {
+    if (pageDir->entry[pageTableNr].present) {
+        return (PageTable*) (pageDir->entry[pageTableNr].frameAddress << 12);
+    }
+    return (PageTable*) paging::frameAddress(PAGE_TABLES_START + pageTableNr);
+}
+
+/**
+ * @brief Copy a directory entry set by mapPage into the kernel directory and the application processors directories.
+ *        The kernel page tables are shared, so a page table made present by one cpu (E.g mapMmio after the APs boot)
+ *        must be present in every directory. The first entry is private to each cpu and isn't copied.
+ * 
+ * @param pageDir       Page directory where the entry was set
+ * @param pageTableNr   Directory entry
+ */
+void shareDirectoryEntry(PageDirectory* pageDir, int pageTableNr) {
+    unsigned int i;
+
+    if (pageTableNr == 0) {
+        return;
+    }
+
+    if (pageDir != pageDirectory) {
+        pageDirectory->entry[pageTableNr] = pageDir->entry[pageTableNr];
+    }
+    for (i = 0; i < cpuDirectoryCount; i++) {   // Not present entries aren't cached by the TLB, no flush is needed
+        if (cpuDirectories[i] != pageDir) {
+            cpuDirectories[i]->entry[pageTableNr] = pageDir->entry[pageTableNr];
+        }
+    }
+}
+
 // ====================================================================================================
 
 void paging::install() {
     int i;
 
+    cpuDirectoryCount = 0;
+    spinlock::init(&framesLock, "frames");
+
     // Initialize the frames to 0=UNUSED, because frames is located in .bss section and must be initialized.
     for (i = 0; i < FRAMES_COUNT; i++) { 
         frames[i] = 0; // unused
@@ -59,12 +121,14 @@ void paging::install() {
         mapPage(pageDirectory, KERNEL_STACK_START_ADDR + i * FRAME_SIZE, KERNEL_STACK_START_ADDR + i * FRAME_SIZE);
     }
 
-    // Mapping virtual video memory
-    // from (0x6506000 - 0x6507000) = 0x1000 = 4kb
-    mapPage(pageDirectory, VIDEO_MEM_START, 0xB8000); 
+    // Mapping virtual video memory, the whole text memory is the scroll ring of the vga driver
+    // from (0x6506000 - 0x650E000) = 0x8000 = 32kb
+    for (i=0; i<VIDEO_MEM_SIZE; i++) {
+        mapPage(pageDirectory, VIDEO_MEM_START + i * FRAME_SIZE, 0xB8000 + i * FRAME_SIZE);
+    }
 
     // Mapping kernel heap where virtual addr = physical addr
-    // from (0x6507000 - 0x7107000) = 0xC00000 = 12 Mb
+    // from (0x650E000 - 0x710E000) = 0xC00000 = 12 Mb
     for (i=0; i<KERNEL_HEAP_SIZE; i++) {
         mapPage(pageDirectory, KERNEL_HEAP_START_ADDR + i * FRAME_SIZE, KERNEL_HEAP_START_ADDR + i * FRAME_SIZE);
     }
@@ -83,7 +147,7 @@ void paging::install() {
     // Set the new vga address to the new virtual address
     vga::setVgaAddress(VIDEO_MEM_START);
 
-    // stdio::kprintf("");
+    // KPRINTF("");
 
     // __asm__ volatile ("cli; hlt");  // Halt the cpu Completely hangs the computer
 }
@@ -103,9 +167,9 @@ void paging::test() {
     // pageNr = (virtualAddr >> 12) & 1023;
     // PageTable* pageTable = (PageTable*) frameAddress(PAGE_TABLES_START + pageTableNr);
 
-    // stdio::kprintf("pageTableNr: %d\n", pageTableNr);
-    // stdio::kprintf("pageNr: %d\n", pageNr);
-    // stdio::kprintf("pageTable: %x\n", (uint32_t) pageTable);
+    // KPRINTF("pageTableNr: %d\n", pageTableNr);
+    // KPRINTF("pageNr: %d\n", pageNr);
+    // KPRINTF("pageTable: %x\n", (uint32_t) pageTable);
 
     // ===========================================================
 
@@ -124,16 +188,39 @@ void paging::test() {
     // if (usage == 0)
     //     frames[byteNr] = frames[byteNr] & ~mask;
 
-    // stdio::kprintf("byteNr: %d\n", byteNr);
-    // stdio::kprintf("bitNr: %d\n", bitNr);
-    // stdio::kprintf("mask: %d\n", mask);
-    // stdio::kprintf("~mask %d\n", ~mask);
+    // KPRINTF("byteNr: %d\n", byteNr);
+    // KPRINTF("bitNr: %d\n", bitNr);
+    // KPRINTF("mask: %d\n", mask);
+    // KPRINTF("~mask %d\n", ~mask);
+}
+
+/**
+ * @brief Set the bit of a frame in the frames list. Called with framesLock held.
+ * 
+ * @param frameNr   The number of the frame being modified
+ * @param usage     1=in_use, 0=free
+ */
+void frameSetBit(unsigned int frameNr, int usage) {
+    unsigned int byteNr; // byte number location where frameNr is located in frames buffer
+    unsigned int bitNr;  // bit number of the byte that is where the frame usage stored
+    unsigned char mask;  // the mask that will be used to change bit value of the frame to 1(in_use) or 0(free)
+
+    byteNr = frameNr / 8;
+    bitNr = frameNr % 8;
+    mask = 1 << bitNr;
+    if (usage == 1) {
+        frames[byteNr] = frames[byteNr] | mask; // Perform a OR operation to set the bit to 1 and keep the others bits untouched
+    }
+    if (usage == 0) {
+        frames[byteNr] = frames[byteNr] & ~mask; // Perform a NOT operation in mask to inverse the value (128d = 100000000 becomes -129d = 011111111)
+    }                                            // Then performs a AND operation to set the bit to zero and keep the others bits untouched
 }
 
 unsigned int paging::frameAlloc() {
     int i, j;
     unsigned char temp;   // bit number in byte
     unsigned int frameNr; // frame number
+    uint32_t flags = spinlock::acquireIrqSave(&framesLock);
 
     for (i=0; i<FRAMES_COUNT; i++) { // For each frame
         if (frames[i] != 0xFF) {         // Check if the byte of the frame has at least one frame (bit) = 0 if so the value will be different of 0xFF (255 = 11111111)
@@ -142,7 +229,8 @@ unsigned int paging::frameAlloc() {
             for (j = 0; j < 8; j++) {           // For each frame in current byte
                 if ((temp & 1) == 0) {          // Check if current frame (bit) of the current byte is free. Use an AND(& 1) operation in the bit if equals 0 it is free.
                     frameNr = i * 8 + j;        // Since the frame is free we need to get this frame number. So multiply byte(i) * 8 frames(bit) + curByteFrameIndex (j)bits.
-                    frameSetUsage(frameNr, 1); // Since we are allocating this frame set in_use
+                    frameSetBit(frameNr, 1);    // Since we are allocating this frame set in_use
+                    spinlock::releaseIrqRestore(&framesLock, flags);
                     return frameNr;             // Return this new allocated frame
                 }
                 temp >>= 1; // Shift the bits to the left of the temp(byte) by one position for each bit being verified until last bit reached or free frame found.
@@ -150,6 +238,8 @@ unsigned int paging::frameAlloc() {
         }
     }
 
+    spinlock::releaseIrqRestore(&framesLock, flags);
+
     // TODO: this is wrong. Error should be returned. But currently there's
     // not way to do this.
     return 0;
@@ -160,19 +250,9 @@ void paging::frameFree(unsigned int frameNr) {
 }
 
 void paging::frameSetUsage(unsigned int frameNr, int usage) {
-    unsigned int byteNr; // byte number location where frameNr is located in frames buffer
-    unsigned int bitNr;  // bit number of the byte that is where the frame usage stored
-    unsigned char mask;  // the mask that will be used to change bit value of the frame to 1(in_use) or 0(free)
-
-    byteNr = frameNr / 8;
-    bitNr = frameNr % 8;
-    mask = 1 << bitNr;
-    if (usage == 1) {
-        frames[byteNr] = frames[byteNr] | mask; // Perform a OR operation to set the bit to 1 and keep the others bits untouched
-    }
-    if (usage == 0) {
-        frames[byteNr] = frames[byteNr] & ~mask; // Perform a NOT operation in mask to inverse the value (128d = 100000000 becomes -129d = 011111111)
-    }                                            // Then performs a AND operation to set the bit to zero and keep the others bits untouched
+    uint32_t flags = spinlock::acquireIrqSave(&framesLock);
+    frameSetBit(frameNr, usage);
+    spinlock::releaseIrqRestore(&framesLock, flags);
 }
 
 unsigned int paging::frameAddress(unsigned int frameNr) {
@@ -209,7 +289,8 @@ void paging::setPageTableEntry(PageTableEntry* tableEntry, unsigned int frameAdd
     tableEntry->userMode     = userMode;      // 0=Supervisor privilege,            1=User privilege
 
     tableEntry->dirty        = 0;             // 0=No changes,                      1=Page changed and need to be updated in secondary memory
-    tableEntry->reserved1    = 0;
+    tableEntry->writeThrough = 0;             // 0=Write-back caching,              1=Write-through caching
+    tableEntry->cacheDisable = 0;             // 0=Page is cached,                  1=Page is not cached
     tableEntry->reserved2    = 0;
     tableEntry->accessed     = 0;             // 0=No access performed by CPU       1=Read or Write in this page performed by the cpu
     tableEntry->unused       = 0;
@@ -257,8 +338,9 @@ void paging::setPageDirectory(PageDirectory* pageDirectory) {
  * @param pageDir       The root structure that holds all PageTables and All Frames
  * @param virtualAddr   The virtual address that will be assigned a physical address
  * @param physicalAddr  The physical address that will be assigned to a virtual address
+ * @param userMode      0=Supervisor page, 1=Page accessible by user mode (ring 3)
  */
-void paging::mapPage(PageDirectory* pageDir, unsigned int virtualAddr, unsigned int physicalAddr) {
+void paging::mapPage(PageDirectory* pageDir, unsigned int virtualAddr, unsigned int physicalAddr, unsigned int userMode) {
     int pageTableNr;       // Page table number inside page directory (The main directory holds 1024 PageTable)
     int pageNr;            // Page number inside page table (A PageTable holds 1024 PageEntries)
     PageTable* pageTable;
@@ -272,19 +354,21 @@ void paging::mapPage(PageDirectory* pageDir, unsigned int virtualAddr, unsigned
     // OFFSET     (Has 4096 frame size)  - Bits: 0-11  = 12 bits = 4096 addresses
     pageTableNr = virtualAddr >> 22;     // Since the OFFSET + PAGE_TABLE = 22 bits. Shift those bits right to extract pageTableNr (PAGE_DIR entry).
     pageNr = (virtualAddr >> 12) & 1023; // Since the OFFSET = 12 bits. Shift those bits right to extract pageNr (PAGE_TABLE entry).
-    pageTable = (PageTable*) frameAddress(PAGE_TABLES_START + pageTableNr); // Retrieve the location of this page in physical RAM memory and convert to PageTable
+    pageTable = getPageTable(pageDir, pageTableNr); // Retrieve the location of this page in physical RAM memory and convert to PageTable
 
     // int mPageTable = (int) pageTable >> 12;
     // int mPageTableAddr = (int) pageDir | mPageTable << 12;
     
-    setPageTableEntry(&pageDir->entry[pageTableNr], (int) pageTable >> 12, 1, 1, 0);
-    setPageTableEntry(&pageTable->entry[pageNr], physicalAddr >> 12, 1, 1, 0);
+    // Once a page table holds a user page the directory entry keeps the user bit, the page entries still protect the supervisor pages
+    setPageTableEntry(&pageDir->entry[pageTableNr], (int) pageTable >> 12, 1, 1, userMode | pageDir->entry[pageTableNr].userMode);
+    setPageTableEntry(&pageTable->entry[pageNr], physicalAddr >> 12, 1, 1, userMode);
+    shareDirectoryEntry(pageDir, pageTableNr);
 
     frameSetUsage(frameNumber(physicalAddr), 1);
 
     // unsigned int framePhysicalAddress = framePhysicalAddress(pageDir, pageTableNr, pageNr, 1);
 
-    // stdio::kprintf("pageTableNr: %d - pageNr: %d - virtualAddress: %x - physicalAddress: %x - physicalAddress2: %x\n", pageTableNr, pageNr, virtualAddr, physicalAddr, framePhysicalAddress);
+    // KPRINTF("pageTableNr: %d - pageNr: %d - virtualAddress: %x - physicalAddress: %x - physicalAddress2: %x\n", pageTableNr, pageNr, virtualAddr, physicalAddr, framePhysicalAddress);
 
     // __asm__ volatile ("cli; hlt");  // Halt the cpu Completely hangs the computer
 }
@@ -297,14 +381,71 @@ void paging::unmapPage(unsigned int virtualAddr) {
     pageTableNr = virtualAddr >> 22;
     pageNr = (virtualAddr >> 12) & 1023;
 
-    pageTable = (PageTable*) frameAddress(PAGE_TABLES_START + pageTableNr);
+    pageTable = getPageTable(currentDirectory(), pageTableNr);
     setPageTableEntry(&pageTable->entry[pageNr], 0, 0, 0, 0);
 }
 
-void paging::remoteMapPage(unsigned int virtualAddr, unsigned int physicalAddr) {
-    mapPage(pageDirectory, virtualAddr, physicalAddr);
+void paging::remoteMapPage(unsigned int virtualAddr, unsigned int physicalAddr, unsigned int userMode) {
+    mapPage(currentDirectory(), virtualAddr, physicalAddr, userMode);
+}
+
+void paging::mapMmio(unsigned int physicalAddr) {
+    PageTable* pageTable;
+    PageTableEntry* entry;
+
+    mapPage(pageDirectory, physicalAddr, physicalAddr);
+
+    pageTable = (PageTable*) frameAddress(PAGE_TABLES_START + (physicalAddr >> 22));
+    entry = &pageTable->entry[(physicalAddr >> 12) & 1023];
+    entry->writeThrough = 1;
+    entry->cacheDisable = 1;
+
+    pagesRefresh(); // Flush the TLB
+}
+
+void paging::mapFramebuffer(unsigned int physicalAddr, unsigned int size) {
+    PageTable* pageTable;
+    unsigned int address;
+    unsigned int i;
+
+    for (i = 0; i < sizeInFrames(size); i++) {
+        address = physicalAddr + i * FRAME_SIZE;
+        mapPage(pageDirectory, address, address);
+        pageTable = (PageTable*) frameAddress(PAGE_TABLES_START + (address >> 22));
+        pageTable->entry[(address >> 12) & 1023].writeThrough = 1;
+    }
+
+    pagesRefresh(); // Flush the TLB once for the whole framebuffer
 }
 
 void paging::pagesRefresh() {
-    setPageDirectory(pageDirectory);
+    setPageDirectory(currentDirectory());
+}
+
+PageDirectory* paging::createCpuDirectory() {
+    PageDirectory* dir;
+    PageTable* table;
+    PageTable* kernelTable;
+    int i;
+
+    if (cpuDirectoryCount >= PAGING_MAX_CPU_DIRECTORIES) {
+        return NULL;
+    }
+
+    dir = (PageDirectory*) frameAddress(frameAlloc());
+    table = (PageTable*) frameAddress(frameAlloc());
+    remoteMapPage((unsigned int) dir, (unsigned int) dir);
+    remoteMapPage((unsigned int) table, (unsigned int) table);
+    pagesRefresh();
+
+    // Same kernel page tables, and a private copy of the first one
+    kernelTable = getPageTable(pageDirectory, 0);
+    for (i = 0; i < 1024; i++) {
+        dir->entry[i] = pageDirectory->entry[i];
+        table->entry[i] = kernelTable->entry[i];
+    }
+    setPageTableEntry(&dir->entry[0], (unsigned int) table >> 12, 1, 1, pageDirectory->entry[0].userMode);
+
+    cpuDirectories[cpuDirectoryCount++] = dir;
+    return dir;
 }
\ No newline at end of file
@@ -33,8 +33,8 @@
  * | 0x0101000  | 0x0500000   | 0x3FF000 ( 4 Mb)   | O.S. Page Table 1024 entries                                         |
  * | 0x6400000  | 0x6500000   | 0x100000 ( 1 Mb)   | O.S. Kernel source memory                                            |
  * | 0x6501000  | 0x6505000   | 0x004000 (16 kb)   | O.S. Kernel stack memory                                             |
- * | 0x6506000  | 0x6507000   | 0x001000 ( 4 kb)   | O.S. VGA (0xB8000) video memory                                      |
- * | 0x6507000  | 0x7107000   | 0xC00000 (12 Mb)   | O.S. Kernel heap memory                                              |
+ * | 0x6506000  | 0x650E000   | 0x008000 (32 kb)   | O.S. VGA (0xB8000 - 0xBFFFF) video memory, text mode scroll ring     |
+ * | 0x650E000  | 0x710E000   | 0xC00000 (12 Mb)   | O.S. Kernel heap memory                                              |
  * | 
  */
 
@@ -48,15 +48,18 @@
 #define PAGE_TABLE_COUNT 1024
 
 #define USER_PAGES_START PAGE_TABLES_START + PAGE_TABLE_COUNT // frame number where user pages start
+#define PAGING_MAX_CPU_DIRECTORIES 8 // Page directories of the application processors created by paging::createCpuDirectory
 #define BOOT_START_ADDR 0x7C00      // 31 KB
 #define KERNEL_START_ADDR 0x6400000 // 100 MB
 #define KERNEL_SOURCE_SIZE 256 // 1 MB = 256 frames
 #define KERNEL_STACK_START_ADDR KERNEL_START_ADDR + (KERNEL_SOURCE_SIZE * FRAME_SIZE) + FRAME_SIZE // kernel + 1MB + 4kB
 #define KERNEL_STACK_SIZE 4  // 16 kb = 4 frames
+#define KERNEL_STACK_END_ADDR (KERNEL_STACK_START_ADDR + KERNEL_STACK_SIZE * FRAME_SIZE) // kernel stack top, first byte after the kernel stack
 
 #define VIDEO_MEM_START KERNEL_STACK_START_ADDR + (KERNEL_STACK_SIZE + 1) * FRAME_SIZE // kernel stack + kernel stack size + 4kB
+#define VIDEO_MEM_SIZE 8 // 32 kB = 8 frames, the whole color text memory
 
-#define KERNEL_HEAP_START_ADDR VIDEO_MEM_START + FRAME_SIZE // video mem + 4kB
+#define KERNEL_HEAP_START_ADDR VIDEO_MEM_START + VIDEO_MEM_SIZE * FRAME_SIZE // video mem + 32kB
 #define KERNEL_HEAP_SIZE 1024 * 3 // 1024 * 3 frames = 12 MB
 
 /**
@@ -336,7 +339,8 @@ typedef struct {
     unsigned int present        : 1;
     unsigned int rw             : 1;    // set - r/w, unset - read-only
     unsigned int userMode       : 1;    // set - user mode, unset - kernel mode
-    unsigned int reserved1      : 2;
+    unsigned int writeThrough   : 1;    // set - write-through caching, unset - write-back
+    unsigned int cacheDisable   : 1;    // set - page is not cached. Required by memory mapped device registers
     unsigned int accessed       : 1;
     unsigned int dirty          : 1;    // Set if the page has been written to (dirty)
     unsigned int reserved2      : 2;
@@ -476,33 +480,62 @@ namespace paging {
      * @param pageDir       The root structure that holds all PageTables and All Frames
      * @param virtualAddr   The virtual address that will be assigned a physical address
      * @param physicalAddr  The physical address that will be assigned to a virtual address
+     * @param userMode      0=Supervisor page, 1=Page accessible by user mode (ring 3)
      */
-    void mapPage(PageDirectory* pageDir, unsigned int virtualAddr, unsigned int physicalAddr);
+    void mapPage(PageDirectory* pageDir, unsigned int virtualAddr, unsigned int physicalAddr, unsigned int userMode = 0);
 
 
     /**
      * @brief Reset the page to unused, usually when the page is not in memory anymore,
-     * release it to be allocated by another process.
+     * release it to be allocated by another process. The page is unmapped from the page directory of the running cpu.
      * 
      * @param virtualAddr   Virtual address where the page is located
      */
     void unmapPage(unsigned int virtualAddr);
 
     /**
-     * @brief The same as the mapPage function but without the need of provide the PageDirectory ptr
+     * @brief The same as the mapPage function but using the page directory of the running cpu (cr3)
      * 
      * @param virtualAddr   Virtual address offset of the frame
      * @param physicalAddr  Physical address offset of the frame
+     * @param userMode      0=Supervisor page, 1=Page accessible by user mode (ring 3)
      */
-    void remoteMapPage(unsigned int virtualAddr, unsigned int physicalAddr);
+    void remoteMapPage(unsigned int virtualAddr, unsigned int physicalAddr, unsigned int userMode = 0);
+
+    /**
+     * @brief Map the registers page of a memory mapped device where virtual addr = physical addr.
+     *        The page is not cached, so every read and write reaches the device.
+     * 
+     * @param physicalAddr  Physical address of the device registers, 0x1000 aligned
+     */
+    void mapMmio(unsigned int physicalAddr);
+
+    /**
+     * @brief Map a linear framebuffer where virtual addr = physical addr.
+     *        The pages are write-through instead of uncached like mapMmio, every write still reaches the screen.
+     *        Must be called before the application processors are started.
+     * 
+     * @param physicalAddr  Physical address of the framebuffer, 0x1000 aligned
+     * @param size          Bytes of the framebuffer
+     */
+    void mapFramebuffer(unsigned int physicalAddr, unsigned int size);
 
     /**
      * @brief Flush page table cache.
-     * Call the setPageDirectory to set the PageDirectory* in cr3 register 
-     * that points to current PageDirectory
+     * Reload the PageDirectory* of the running cpu in cr3 register
      * 
      */
     void pagesRefresh();
+
+    /**
+     * @brief Create the page directory of an application processor.
+     *        The kernel page tables are shared with the other cpus, except the first one (0 - 4 MiB) where each cpu maps
+     *        the memory of the process it runs. The directory entries set later by mapPage outside the first one are
+     *        copied into every cpu directory, the page tables behind them are already shared.
+     * 
+     * @return PageDirectory*   New page directory, NULL if PAGING_MAX_CPU_DIRECTORIES were already created
+     */
+    PageDirectory* createCpuDirectory();
 }
 
 #endif
\ No newline at end of file
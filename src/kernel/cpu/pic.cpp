@@ -119,6 +119,15 @@ void pic::sendEOI(uint8_t irq) {
 	io::outb(PIC1_COMMAND, PIC_EOI); // Reset the In Service (IS) bit for the Master PIC
 }
 
+bool pic::isSpurious(uint8_t irq) {
+    // The lowest priority line of each PIC is reported when the request goes away before the INTA cycle. Then the line
+    // isn't in service
+    if (irq != PIC_SPURIOUS_MASTER_IRQ && irq != PIC_SPURIOUS_SLAVE_IRQ) {
+        return false;
+    }
+    return (getIsr() & (1 << irq)) == 0;
+}
+
 uint16_t getIrqReg(int ocw3) {
     /* OCW3 to PIC CMD to get the register values.  PIC2 is chained, and
      * represents IRQs 8-15.  PIC1 is IRQs 0-7, with 2 being the chain */
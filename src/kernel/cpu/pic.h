@@ -42,6 +42,10 @@
  *     continues normal operation. Note that setting the mask on a higher request line will not affect a lower line. 
  *     Masking IRQ2 will cause the Slave PIC to stop raising IRQs.
  */
+#define PIC_CASCADE_IRQ 2              // Master line of the slave PIC
+#define PIC_SPURIOUS_MASTER_IRQ 7      // Lowest priority line of the master PIC, reported for its spurious interruptions
+#define PIC_SPURIOUS_SLAVE_IRQ 15      // Lowest priority line of the slave PIC, reported for its spurious interruptions
+
 namespace pic {
     /**
      * @brief Remps the PIC vectors offsets to a new given offset
@@ -80,6 +84,17 @@ namespace pic {
      * @param irq 
      */
     void sendEOI(uint8_t irq);
+
+    /**
+     * @brief Check if an IRQ7 or IRQ15 is spurious reading the In-Service Register (ISR).
+     *        A spurious IRQ7 must not be acknowledged. A spurious IRQ15 is only acknowledged in the master PIC, that
+     *        doesn't know the slave request went away.
+     * 
+     * @param irq       Irq line
+     * @return true     Spurious, the line isn't in service
+     * @return false    Real interruption or another line
+     */
+    bool isSpurious(uint8_t irq);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,208 @@
+// cpu
+#include "gdt.h"
+#include "idt.h"
+#include "fpu.h"
+#include "apic.h"
+#include "paging.h"
+#include "smp.h"
+// memory
+#include "heap.h"
+#include "memutils.h"
+// legacy drivers
+#include "pit.h"
+// stdlibs
+#include "stdlib.h"
+// sys
+#include "acpi.h"
+#include "spinlock.h"
+#include "syscalls.h"
+// process
+#include "scheduler.h"
+
+Cpu cpus[SMP_MAX_CPUS];
+uint8_t cpuCount;                       // Online cpus
+uint8_t bootingCpu;                     // Index of the application processor being started
+volatile bool apsReleased;              // Set by the scheduler of the bootstrap processor
+Spinlock kernelLock;                    // Serializes the kernel code between the cpus
+volatile uint8_t kernelLockOwner;       // Cpu holding the kernel lock, SMP_NO_CPU when free
+uint32_t kernelLockDepth;               // Nested entries of the owner, an interruption received while the bottom halves run
+
+uint32_t apPageDirectory;               // Page directory loaded in CR3 by smp_ap_start
+uint32_t apStack;                       // Stack top loaded in ESP by smp_ap_start
+
+/**
+ * @brief Reschedule IPI handler. The interruption only wakes up the halted cpu, its idle loop reads the ready queues.
+ *
+ * @param r Registers of the interrupted code
+ */
+void smpRescheduleHandler(registers_t*) {
+}
+
+/**
+ * @brief C entry point of the application processors. Called by smp_ap_start with paging enabled and the cpu stack loaded.
+ *
+ */
+extern "C" void smp_ap_main() {
+    Cpu* cpu = &cpus[bootingCpu];
+
+    gdt::installCpu(cpu->index);        // Kernel segments and the TSS of this cpu
+    idt::install();                     // Same IDT of the bootstrap processor
+    fpu::installCpu();
+    syscalls::installCpu(cpu->index);
+    apic::installCpu();
+
+    cpu->online = true;
+    while (!apsReleased) {              // Processes are only scheduled when every cpu is online
+        asm volatile("pause");
+    }
+
+    scheduler::start();                 // Idle loop of this cpu, takes the kernel lock
+}
+
+/**
+ * @brief Start one application processor with the INIT - STARTUP - STARTUP sequence and wait until it's online
+ *
+ * @param cpu       Cpu to start, its page directory and stack must be set
+ * @return true     The cpu is online
+ * @return false    The cpu didn't answer
+ */
+bool startCpu(Cpu* cpu) {
+    int i;
+
+    bootingCpu = cpu->index;
+    apPageDirectory = (uint32_t) cpu->pageDirectory;
+    apStack = (uint32_t) cpu->stack + SMP_AP_STACK_SIZE;
+
+    apic::sendInit(cpu->apicId);
+    pit::busyWait(11932);               // 10 ms
+    apic::sendStartup(cpu->apicId, SMP_TRAMPOLINE_ADDR);
+    pit::busyWait(239);                 // 200 us
+    if (!cpu->online) {
+        apic::sendStartup(cpu->apicId, SMP_TRAMPOLINE_ADDR);  // The second STARTUP is ignored by a cpu that already started
+    }
+
+    for (i = 0; i < SMP_AP_TIMEOUT_MS && !cpu->online; i++) {
+        pit::busyWait(1193);            // 1 ms
+    }
+    return cpu->online;
+}
+
+void smp::init() {
+    int i;
+
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    for (i = 0; i < SMP_MAX_CPUS; i++) {
+        cpus[i].index = i;
+        cpus[i].apicId = 0;
+        cpus[i].online = false;
+        cpus[i].pageDirectory = NULL;
+        cpus[i].stack = NULL;
+    }
+    cpus[0].online = true;
+    cpuCount = 1;
+    bootingCpu = 0;
+    apsReleased = false;
+    apPageDirectory = 0;
+    apStack = 0;
+    spinlock::init(&kernelLock, "kernel");
+    kernelLockOwner = SMP_NO_CPU;
+    kernelLockDepth = 0;
+}
+
+uint8_t smp::install() {
+    const AcpiCpu* acpiCpu;
+    Cpu* cpu;
+    uint8_t bspId;
+    uint8_t i;
+
+    if (!apic::isEnabled()) {
+        return SMP_ERROR_NO_APIC;
+    }
+    if (acpi::getCpuCount() < 2) {
+        return SMP_ERROR_SINGLE_CPU;
+    }
+
+    bspId = apic::getId();
+    cpus[0].apicId = bspId;
+    isr::registerIsrHandler(IRQ_RESCHEDULE, smpRescheduleHandler);
+
+    // The trampoline runs in real mode, below 1 MiB. The page is only mapped while it's copied, the cpus start with paging disabled
+    paging::remoteMapPage(SMP_TRAMPOLINE_ADDR, SMP_TRAMPOLINE_ADDR);
+    paging::pagesRefresh();
+    memutils::memcpy((void*) SMP_TRAMPOLINE_ADDR, (void*) smp_trampoline_start, (uint32_t) smp_trampoline_end - (uint32_t) smp_trampoline_start);
+    paging::unmapPage(SMP_TRAMPOLINE_ADDR);
+    paging::pagesRefresh();
+
+    for (i = 0; i < acpi::getCpuCount() && cpuCount < SMP_MAX_CPUS; i++) {
+        acpiCpu = acpi::getCpu(i);
+        if (acpiCpu->apicId == bspId) {
+            continue;
+        }
+
+        cpu = &cpus[cpuCount];
+        cpu->apicId = acpiCpu->apicId;
+        if (cpu->pageDirectory == NULL) {                       // Kept for the next processor when this one doesn't answer
+            cpu->pageDirectory = paging::createCpuDirectory();
+        }
+        if (cpu->stack == NULL) {
+            cpu->stack = (uint8_t*) heap::kmalloc(SMP_AP_STACK_SIZE);
+        }
+        if (cpu->pageDirectory == NULL || cpu->stack == NULL) {
+            break;
+        }
+
+        if (startCpu(cpu)) {
+            cpuCount++;
+        }
+    }
+
+    return SMP_NO_ERROR;
+}
+
+void smp::releaseAps() {
+    apsReleased = true;
+}
+
+uint8_t smp::getCpuCount() {
+    return cpuCount;
+}
+
+uint8_t smp::getCpuIndex() {
+    uint16_t tr;
+
+    asm volatile("str %0" : /* output */ "=r"(tr));
+    if (tr < GDT_TSS_SEL) {             // Before gdt::install
+        return 0;
+    }
+    return (tr - GDT_TSS_SEL) >> 3;
+}
+
+Cpu* smp::getCpu(uint8_t index) {
+    return &cpus[index];
+}
+
+void smp::lockKernel() {
+    uint8_t cpu = getCpuIndex();
+
+    if (kernelLockOwner == cpu) {           // Only the owner reads its own index here, no other cpu can change it meanwhile
+        kernelLockDepth++;
+        return;
+    }
+    spinlock::acquire(&kernelLock);
+    kernelLockOwner = cpu;
+    kernelLockDepth = 1;
+}
+
+void smp::unlockKernel() {
+    if (--kernelLockDepth > 0) {
+        return;
+    }
+    kernelLockOwner = SMP_NO_CPU;
+    spinlock::release(&kernelLock);
+}
+
+void smp::sendReschedule(uint8_t index) {
+    if (index != getCpuIndex() && cpus[index].online) {
+        apic::sendIpi(cpus[index].apicId, IRQ_RESCHEDULE);
+    }
+}
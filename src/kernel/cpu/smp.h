@@ -0,0 +1,129 @@
+#pragma once
+#ifndef _SMP_H_
+#define _SMP_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+// cpu
+#include "gdt.h"
+#include "paging.h"
+
+#define SMP_NO_ERROR 0                          // No error happend. Same as Success
+#define SMP_ERROR_NO_APIC 1                     // The application processors are started with IPIs, the APIC is required
+#define SMP_ERROR_SINGLE_CPU 2                  // The MADT reports only the bootstrap processor, or no MADT was found
+
+#define SMP_MAX_CPUS GDT_TSS_COUNT              // Each cpu loads its own TSS
+#define SMP_TRAMPOLINE_ADDR 0x8000              // Real mode start address of the application processors, STARTUP IPI vector 0x08
+#define SMP_AP_STACK_SIZE 8192                  // Stack of the idle context of each application processor
+#define SMP_AP_TIMEOUT_MS 100                   // Time waited for an application processor to come online
+#define SMP_NO_CPU 0xFF                         // Cpu index of a free kernel lock
+
+/**
+ * @brief Per cpu data
+ *
+ */
+typedef struct {
+    uint8_t index;                              // Position in the cpus list, 0 is the bootstrap processor. Also its TSS
+    uint8_t apicId;                             // Local APIC id, destination of the IPIs
+    volatile bool online;                       // Set by the cpu when it's ready to run processes
+    PageDirectory* pageDirectory;               // Loaded by the application processor. NULL for the bootstrap processor, it uses the kernel directory
+    uint8_t* stack;                             // Stack of the idle context. NULL for the bootstrap processor, it uses the boot stack
+} Cpu;
+
+/**
+ * @brief Bootstrap of the application processors imported from smp_trampoline.asm
+ *
+ */
+extern "C" void smp_trampoline_start();
+extern "C" void smp_trampoline_end();
+
+/**
+ * @brief SMP - Symmetric multiprocessing
+ *
+ * AP_BRING_UP:
+ *    - The processors listed in the ACPI MADT, other than the bootstrap processor (BSP), are the application processors (AP).
+ *    - The trampoline is copied to SMP_TRAMPOLINE_ADDR. Each AP is started with INIT, then STARTUP IPIs with the trampoline page.
+ *    - The AP starts in real mode at the trampoline, enters protected mode with a temporary GDT, then jumps to the kernel,
+ *      enables paging with its own page directory, loads its stack and calls smp_ap_main.
+ *    - smp_ap_main loads the kernel GDT with the TSS of the cpu, the IDT, the FPU, SYSENTER and local APIC configuration,
+ *      then the AP is online and waits to be released by the scheduler of the BSP.
+ *    - The APs are started one at a time, so the trampoline, apPageDirectory and apStack are shared.
+ *
+ * CPU_INDEX:
+ *    - Each cpu loads its own TSS descriptor, so the running cpu index is read from the task register (STR) without memory access.
+ *
+ * KERNEL_LOCK:
+ *    - The kernel code still expects to be the only code running in ring 0, with the interruptions disabled.
+ *    - Every entry in the kernel (syscalls, interruptions and the idle loop) takes the kernel lock, and releases it before
+ *      returning to user mode or halting the cpu. User code runs on every cpu at the same time.
+ *    - A context switch happens with the lock held, the switched in context releases it. So a process blocked on a cpu can be
+ *      continued by another one.
+ *    - The lock is recursive on the cpu that holds it. The bottom halves (tasklets and worker threads) run with the interruptions
+ *      enabled, an interruption received meanwhile enters the kernel again on the same cpu.
+ */
+namespace smp {
+    /**
+     * @brief Initialize the bootstrap processor data and the kernel lock. Must be called before the interruptions are enabled.
+     *
+     */
+    void init();
+
+    /**
+     * @brief Start the application processors listed in the MADT. Requires the APIC, the kernel heap and the scheduler.
+     *        The started processors wait until the scheduler of the bootstrap processor calls smp::releaseAps.
+     *
+     * @return uint8_t Error code: SMP_NO_ERROR, SMP_ERROR_NO_APIC or SMP_ERROR_SINGLE_CPU
+     */
+    uint8_t install();
+
+    /**
+     * @brief Let the application processors enter their idle loop and run processes
+     *
+     */
+    void releaseAps();
+
+    /**
+     * @brief Get the online cpus count
+     *
+     * @return uint8_t Cpus, at least 1
+     */
+    uint8_t getCpuCount();
+
+    /**
+     * @brief Get the index of the running cpu
+     *
+     * @return uint8_t 0 to SMP_MAX_CPUS - 1, 0 is the bootstrap processor
+     */
+    uint8_t getCpuIndex();
+
+    /**
+     * @brief Get the data of a cpu
+     *
+     * @param index     Cpu index
+     * @return Cpu*     Per cpu data
+     */
+    Cpu* getCpu(uint8_t index);
+
+    /**
+     * @brief Take the kernel lock. Called when the kernel is entered, with the interruptions disabled.
+     *        Nested entries of the cpu that holds it are counted.
+     *
+     */
+    void lockKernel();
+
+    /**
+     * @brief Release the kernel lock. Called before returning to user mode or halting the cpu.
+     *
+     */
+    void unlockKernel();
+
+    /**
+     * @brief Wake up an idle cpu with the reschedule IPI
+     *
+     * @param index Cpu index
+     */
+    void sendReschedule(uint8_t index);
+}
+
+#endif
@@ -0,0 +1,71 @@
+; ============================================
+; Application processors bootstrap.
+; ============================================
+
+SMP_TRAMPOLINE_ADDR equ 0x8000  ; Same as smp.h, the STARTUP IPI starts the cpu at 0x0800:0000
+
+[section .text]
+
+[extern smp_ap_main]        ; Reference smp_ap_main exported function from smp.cpp file
+[extern apPageDirectory]    ; Reference apPageDirectory variable from smp.cpp file
+[extern apStack]            ; Reference apStack variable from smp.cpp file
+[global smp_trampoline_start]   ; Export smp_trampoline_start to be copied in smp.cpp file
+[global smp_trampoline_end]     ; Export smp_trampoline_end to be copied in smp.cpp file
+
+; =============================
+; TRAMPOLINE:
+; Copied to SMP_TRAMPOLINE_ADDR by smp::install. The application processor starts here in real mode, with CS = 0x0800 and IP = 0.
+; The code doesn't run at the address it's linked, so the trampoline labels are used as offsets from smp_trampoline_start.
+; =============================
+[bits 16]
+smp_trampoline_start:
+    cli
+    cld
+    mov ax, cs
+    mov ds, ax                                          ; Trampoline page, the offsets below are relative to it
+    lgdt [trampoline_gdtr - smp_trampoline_start]       ; Temporary flat GDT, the kernel GDT is above 1 MiB
+
+    mov eax, cr0
+    or eax, 1                                           ; Protected mode enable
+    mov cr0, eax
+    jmp dword 0x08:(SMP_TRAMPOLINE_ADDR + trampoline_protected - smp_trampoline_start)
+
+[bits 32]
+trampoline_protected:
+    mov ax, 0x10                                        ; Same code (0x08) and data (0x10) selectors of the kernel GDT
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+    mov eax, smp_ap_start                               ; Absolute address, the kernel is identity mapped
+    jmp eax
+
+align 8
+trampoline_gdt:
+    dq 0x0000000000000000                               ; Null Descriptor
+    dq 0x00CF9A000000FFFF                               ; Code segment, base 0, limit 4 GiB
+    dq 0x00CF92000000FFFF                               ; Data segment, base 0, limit 4 GiB
+trampoline_gdtr:
+    dw trampoline_gdtr - trampoline_gdt - 1
+    dd SMP_TRAMPOLINE_ADDR + trampoline_gdt - smp_trampoline_start
+smp_trampoline_end:
+
+; =============================
+; KERNEL ENTRY:
+; Runs at the kernel address, paging still disabled. The kernel code is identity mapped, so the next instruction after
+; paging is enabled is at the same address.
+; =============================
+smp_ap_start:
+    mov eax, [apPageDirectory]                          ; Page directory of this cpu
+    mov cr3, eax
+    mov eax, cr0
+    or eax, 0x80000000                                  ; Paging enable
+    mov cr0, eax
+
+    mov esp, [apStack]                                  ; Stack of the idle context of this cpu
+    call smp_ap_main                                    ; Never returns
+.halt:
+    cli
+    hlt
+    jmp .halt
@@ -0,0 +1,8 @@
+// cpu
+#include "tsc.h"
+
+uint64_t tsc::read() {
+    uint32_t low, high;
+    asm volatile("rdtsc" : /* output */ "=a"(low), "=d"(high));
+    return ((uint64_t) high << 32) | low;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#ifndef _TSC_H_
+#define _TSC_H_
+
+// libc
+#include <stdint.h>
+
+/**
+ * @brief TSC - Time Stamp Counter
+ * 
+ * 64 bits counter incremented by the cpu on every clock cycle (or at a constant rate on newer processors).
+ * Read with the RDTSC instruction into EDX:EAX. The presence of the TSC is reported by CPUID EAX=1 in EDX register Bit 4.
+ * 
+ * Used to measure short code paths in cycles.
+ */
+namespace tsc {
+    /**
+     * @brief Read the time stamp counter
+     * 
+     * @return uint64_t Cycles elapsed since the cpu reset
+     */
+    uint64_t read();
+}
+
+#endif
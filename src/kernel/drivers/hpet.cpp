@@ -0,0 +1,153 @@
+// stdlibs
+#include "stdlib.h"
+// cpu
+#include "paging.h"
+#include "apic.h"
+#include "isr.h"
+// sys
+#include "acpi.h"
+// drivers
+#include "hpet.h"
+
+#define HPET_REG_CAPABILITIES          0x000    // Bits 63-32: counter period in femtoseconds, Bit 13: 64 bits counter, Bits 12-8: last comparator
+#define HPET_REG_CONFIG                0x010    // Bit 0: counter enable, Bit 1: legacy replacement route
+#define HPET_REG_COUNTER               0x0F0    // Main counter
+#define HPET_REG_TIMER_CONFIG(n)       (0x100 + 0x20 * (n))    // Bits 63-32: I/O APIC pins the comparator can be routed to
+#define HPET_REG_TIMER_COMPARATOR(n)   (0x108 + 0x20 * (n))
+
+#define HPET_CONFIG_ENABLE               0x1    // Main counter runs
+#define HPET_CONFIG_LEGACY_ROUTE         0x2    // Comparators 0 and 1 replace the PIT and RTC interruptions. Not used
+#define HPET_TIMER_INT_ENABLE            0x4    // Comparator raises its interruption
+#define HPET_TIMER_32BITS              0x100    // Comparator compares the low 32 bits of the counter
+#define HPET_TIMER_ROUTE_SHIFT             9    // Bits 13-9: I/O APIC pin of the comparator
+
+#define HPET_MAX_PERIOD_FS         100000000    // The specification requires at least 10 MHz
+#define HPET_FS_PER_NS               1000000
+#define HPET_FIRST_FREE_GSI               16    // GSIs below are used by the ISA IRQs
+#define HPET_ONE_SHOT_TIMER                0    // Comparator used as the one-shot event
+
+bool hpetEnabled;                               // One-shot event can be used
+uint32_t hpetAddress;                           // HPET registers address
+uint32_t hpetPeriodFs;                          // Femtoseconds per counter increment
+uint32_t hpetFrequency;                         // Counter increments per second
+uint32_t hpetArmedCounter;                      // Counter when the one-shot was armed
+
+/**
+ * @brief Read a 32 bits HPET register
+ * 
+ * @param reg           Register offset
+ * @return uint32_t     Register value
+ */
+uint32_t hpetRead(uint32_t reg) {
+    return *((volatile uint32_t*) (hpetAddress + reg));
+}
+
+/**
+ * @brief Write a 32 bits HPET register
+ * 
+ * @param reg   Register offset
+ * @param value Register value
+ */
+void hpetWrite(uint32_t reg, uint32_t value) {
+    *((volatile uint32_t*) (hpetAddress + reg)) = value;
+}
+
+/**
+ * @brief Comparator interruption. The cpu is only woken up, the idle loop accounts the elapsed ticks.
+ * 
+ * @param r Registers of the interrupted code
+ */
+void hpetInterruptHandler(registers_t*) {
+    hpet::oneShotStop();
+}
+
+uint8_t hpet::install() {
+    uint32_t routeCap;
+    uint32_t gsi;
+
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    hpetEnabled = false;
+    hpetAddress = 0;
+    hpetPeriodFs = 0;
+    hpetFrequency = 0;
+    hpetArmedCounter = 0;
+
+    if (!acpi::hasHpet()) {
+        return HPET_ERROR_NOT_PRESENT;
+    }
+    hpetAddress = acpi::getHpetAddress();
+    paging::mapMmio(hpetAddress);
+
+    hpetPeriodFs = hpetRead(HPET_REG_CAPABILITIES + 4);
+    if (hpetPeriodFs == 0 || hpetPeriodFs > HPET_MAX_PERIOD_FS) {
+        hpetAddress = 0;
+        return HPET_ERROR_NOT_PRESENT;
+    }
+    hpetFrequency = (uint32_t) stdlib::udiv64(1000000000000000ULL, hpetPeriodFs, NULL);
+
+    // Restart the main counter from 0 without the legacy replacement route, the PIT keeps its interruption
+    hpetWrite(HPET_REG_CONFIG, hpetRead(HPET_REG_CONFIG) & ~(HPET_CONFIG_ENABLE | HPET_CONFIG_LEGACY_ROUTE));
+    hpetWrite(HPET_REG_COUNTER, 0);
+    hpetWrite(HPET_REG_COUNTER + 4, 0);
+    hpetWrite(HPET_REG_CONFIG, hpetRead(HPET_REG_CONFIG) | HPET_CONFIG_ENABLE);
+
+    // Route comparator 0 to the first free pin it can be wired to
+    routeCap = hpetRead(HPET_REG_TIMER_CONFIG(HPET_ONE_SHOT_TIMER) + 4);
+    for (gsi = HPET_FIRST_FREE_GSI; gsi < 32; gsi++) {
+        if ((routeCap & (1u << gsi)) && apic::routeGsi(gsi, IRQ_HPET)) {
+            break;
+        }
+    }
+    if (gsi == 32) {
+        return HPET_ERROR_NO_INTERRUPT;
+    }
+
+    isr::registerIsrHandler(IRQ_HPET, hpetInterruptHandler);
+    hpetWrite(HPET_REG_TIMER_CONFIG(HPET_ONE_SHOT_TIMER), (gsi << HPET_TIMER_ROUTE_SHIFT) | HPET_TIMER_32BITS); // Edge triggered, one-shot, disarmed
+    hpetEnabled = true;
+    return HPET_NO_ERROR;
+}
+
+bool hpet::isEnabled() {
+    return hpetEnabled;
+}
+
+uint32_t hpet::readCounter() {
+    return hpetRead(HPET_REG_COUNTER);
+}
+
+uint32_t hpet::getFrequency() {
+    return hpetFrequency;
+}
+
+bool hpet::oneShotStart(uint32_t ns) {
+    uint32_t count;
+    uint32_t target;
+
+    if (!hpetEnabled) {
+        return false;
+    }
+
+    count = (uint32_t) stdlib::udiv64((uint64_t) ns * HPET_FS_PER_NS, hpetPeriodFs, NULL);
+    hpetArmedCounter = hpet::readCounter();
+    target = hpetArmedCounter + count;
+
+    hpetWrite(HPET_REG_TIMER_COMPARATOR(HPET_ONE_SHOT_TIMER), target);
+    hpetWrite(HPET_REG_TIMER_CONFIG(HPET_ONE_SHOT_TIMER), hpetRead(HPET_REG_TIMER_CONFIG(HPET_ONE_SHOT_TIMER)) | HPET_TIMER_INT_ENABLE);
+
+    if ((int32_t) (target - hpet::readCounter()) <= 0) {    // The comparator only fires on a match, a passed deadline would never fire
+        hpet::oneShotStop();
+        return false;
+    }
+    return true;
+}
+
+void hpet::oneShotStop() {
+    hpetWrite(HPET_REG_TIMER_CONFIG(HPET_ONE_SHOT_TIMER), hpetRead(HPET_REG_TIMER_CONFIG(HPET_ONE_SHOT_TIMER)) & ~HPET_TIMER_INT_ENABLE);
+}
+
+uint32_t hpet::oneShotElapsedNs() {
+    uint64_t ns = stdlib::udiv64((uint64_t) (hpet::readCounter() - hpetArmedCounter) * hpetPeriodFs, HPET_FS_PER_NS, NULL);
+
+    return ns > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t) ns;
+}
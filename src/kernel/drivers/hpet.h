@@ -0,0 +1,82 @@
+#pragma once
+#ifndef _HPET_H_
+#define _HPET_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HPET_NO_ERROR 0
+#define HPET_ERROR_NOT_PRESENT 1        // No ACPI HPET table or invalid counter period
+#define HPET_ERROR_NO_INTERRUPT 2       // The counter runs, but comparator 0 can't be routed to an I/O APIC pin
+
+/**
+ * @brief HPET - High Precision Event Timer
+ * 
+ * REGISTERS:
+ *    - Memory mapped at the address given by the ACPI HPET table.
+ *    - General capabilities: period of the main counter in femtoseconds (at least 10 MHz), comparators count and counter size.
+ *    - Main counter: up counter incremented at a fixed frequency, independent of the cpu clock.
+ *    - Comparators: each one raises an interruption when the main counter matches its value. One-shot or periodic.
+ * 
+ * ONE_SHOT_EVENT:
+ *    - Comparator 0 is used in 32 bits mode and routed to an I/O APIC pin (GSI 16 or above when possible) on vector IRQ_HPET.
+ *    - The idle cpu masks the periodic PIT and arms the comparator at the next kernel timer deadline.
+ *      Unlike the PIT one-shot there is no 16 bits divisor limit, so longer idle periods need a single interruption.
+ * 
+ * Requires the APIC, the comparator interruptions are delivered by the I/O APIC.
+ */
+namespace hpet {
+    /**
+     * @brief Start the main counter and route comparator 0. Must be called after apic::install.
+     * 
+     * @return uint8_t Error code: HPET_NO_ERROR, HPET_ERROR_NOT_PRESENT or HPET_ERROR_NO_INTERRUPT
+     */
+    uint8_t install();
+
+    /**
+     * @brief Return whether the one-shot event can be used or not
+     * 
+     * @return true  Counter running and comparator 0 routed
+     * @return false No HPET or no interruption
+     */
+    bool isEnabled();
+
+    /**
+     * @brief Read the low 32 bits of the main counter
+     * 
+     * @return uint32_t Counter value
+     */
+    uint32_t readCounter();
+
+    /**
+     * @brief Get the main counter frequency
+     * 
+     * @return uint32_t Frequency in hz, 0 if there is no HPET
+     */
+    uint32_t getFrequency();
+
+    /**
+     * @brief Raise the IRQ_HPET interruption after the given time
+     * 
+     * @param ns        Nanoseconds from now
+     * @return true     One-shot armed
+     * @return false    HPET disabled, or the deadline passed while it was programmed
+     */
+    bool oneShotStart(uint32_t ns);
+
+    /**
+     * @brief Disarm the one-shot. Nothing happens if it already expired.
+     * 
+     */
+    void oneShotStop();
+
+    /**
+     * @brief Get the time elapsed since the last hpet::oneShotStart
+     * 
+     * @return uint32_t Nanoseconds
+     */
+    uint32_t oneShotElapsedNs();
+}
+
+#endif
@@ -2,31 +2,64 @@
 #include <stdint.h>
 // stdlibs
 #include "stdlib.h"
+#include "string.h"
 // drivers
 #include "ps2.h"
 // stdlibs
 #include "stdio.h"
 // process
+#include "queue.h"
 #include "scheduler.h"
+#include "spinlock.h"
+#include "mutex.h"
+#include "softirq.h"
+#include "workqueue.h"
+// drivers
+#include "vga.h"
 #include "keyboard.h"
 
 #define CMD_GET_SET_SCANCODE_SET 0xF0    // Get/set current scan code set
 #define CMD_DATA_GET_SCANCODE_SET 0x0    // Get current scan code set
 
 #define KBD_KEY_BUFFER_SIZE 256
+#define KBD_RING_SIZE 256                // Scan codes and chars rings, indexed with uint8_t so they wrap around by themselves
+#define KBD_SCROLL_LINES 12              // Lines scrolled back by Shift+PageUp, half a screen
+#define KBD_READER_NAME_SIZE 12          // "kbdreader" and the console index digit, the name of its reader mutex in lockstat
 
 static uint8_t lastKey;                  // Last key pressed
 
 bool _capslock;
 bool _shift;
 bool _ctrl;
+bool _alt;
 
 const char* _qwertyuiop = "qwertyuiop";
 const char* _asdfghjkl = "asdfghjkl";
 const char* _zxcvbnm = "zxcvbnm";
 
-char keyboardBuffer[KBD_KEY_BUFFER_SIZE];
-unsigned char keyboardBufferPos;
+// Each virtual console has its own line, the keys go to the active console
+char keyboardBuffer[VGA_CONSOLES][KBD_KEY_BUFFER_SIZE];
+unsigned char keyboardBufferPos[VGA_CONSOLES];
+
+char keyboardLine[VGA_CONSOLES][KBD_KEY_BUFFER_SIZE];   // Last line typed, kept until a process reads it
+bool keyboardLineReady[VGA_CONSOLES];    // A line was typed and wasn't read yet
+Queue keyboardLineWaitQueue[VGA_CONSOLES];  // Processes blocked in kbd::readLine
+Spinlock keyboardLock;                   // Protects the keyboard buffers, lines and rings, taken by the interruption handler
+Mutex keyboardReaderMutex[VGA_CONSOLES]; // One process waits for the next line at a time, the others sleep in order
+char keyboardReaderNames[VGA_CONSOLES][KBD_READER_NAME_SIZE];   // kbdreader0, kbdreader1, ... lockstat keeps the pointers
+
+uint8_t keyboardScanCodes[KBD_RING_SIZE];   // Scan codes stored by the interruption handler, decoded by the tasklet
+uint8_t keyboardScanCodesHead;
+uint8_t keyboardScanCodesTail;
+unsigned char keyboardChars[KBD_RING_SIZE]; // Chars decoded by the tasklet, added to the line by the worker
+uint8_t keyboardCharsConsole[KBD_RING_SIZE];  // Console active when each char was typed
+uint8_t keyboardCharsHead;
+uint8_t keyboardCharsTail;
+Tasklet keyboardTasklet;
+Work keyboardLineWork;
+
+void keyboardScanCodesTasklet(void*);
+void keyboardLineWorker(void*);
 
 typedef enum SCS1_en {
     KEY_NULL = 0x00,
@@ -37,31 +70,63 @@ typedef enum SCS1_en {
     KEY_CAPSLOCK = 0x3A, KEY_A          = 0x1E, KEY_S    = 0x1F, KEY_D     = 0x20, KEY_F  = 0x21, KEY_G  = 0x22, KEY_H  = 0x23, KEY_J  = 0x24, KEY_K  = 0x25, KEY_L     = 0x26, KEY_SEMICOLON = 0x27, KEY_S_QUOTE   = 0x28, KEY_GRAVE     = 0x29,
     KEY_LSHIFT   = 0x2A, KEY_BACKSLASH  = 0x2B, KEY_Z    = 0x2C, KEY_X     = 0x2D, KEY_C  = 0x2E, KEY_V  = 0x2F, KEY_B  = 0x30, KEY_N  = 0x31, KEY_M  = 0x32, KEY_COMMA = 0x33, KEY_PERIOD    = 0x34, KEY_SLASH     = 0x35, KEY_RSHIFT    = 0x36, 
     KEY_LCTRL    = 0x1D, /*LGUI = 0xE0, 0x5B*/  KEY_LALT = 0x38, KEY_SPACE = 0x39, /*KEY_RALT=0xE0, 0x38*/
+    KEY_PAGE_UP  = 0x49, KEY_PAGE_DOWN  = 0x51, /* Also sent by the keypad 9 and 3, the 0xE0 prefix is ignored */
 } SCS1_en;
 
 uint8_t kbd::install() {
+    int i;
+
     // Zero fill .bss unitialized data. Must be initialized.
     lastKey = 0;
     _capslock = false;
     _shift = false;
     _ctrl = false;
-    keyboardBufferPos = 0;
+    _alt = false;
+    for (i = 0; i < VGA_CONSOLES; i++) {
+        keyboardBufferPos[i] = 0;
+        keyboardLineReady[i] = false;
+        queue::init(&keyboardLineWaitQueue[i]);
+        string::strcpy(keyboardReaderNames[i], "kbdreader");
+        keyboardReaderNames[i][9] = '0' + i;
+        keyboardReaderNames[i][10] = 0;
+        mutex::init(&keyboardReaderMutex[i], keyboardReaderNames[i]);
+    }
+    spinlock::init(&keyboardLock, "keyboard");
+    keyboardScanCodesHead = 0;
+    keyboardScanCodesTail = 0;
+    keyboardCharsHead = 0;
+    keyboardCharsTail = 0;
+    softirq::initTasklet(&keyboardTasklet, keyboardScanCodesTasklet, NULL);
+    workqueue::initWork(&keyboardLineWork, keyboardLineWorker, NULL);
 
-    stdio::kprintf("KBD - install\n");
+    KPRINTF("KBD - install\n");
 
     return PS2_NO_ERROR;
 }
 
-void kbd::keyboardIntHandler(registers_t* r) {
-    uint8_t curKey;
+/**
+ * @brief Translate a scan code of the scan code set 1 to ASCII, updating the shift, alt and caps lock state.
+ *        Alt+F1..F4 switch the active console and Shift+PageUp/PageDown scroll it, they have no char.
+ *
+ * @param curKey            Scan code
+ * @return unsigned char    ASCII char, 0 when the key has no char or was released
+ */
+unsigned char keyboardDecode(uint8_t curKey) {
     unsigned char asciiKey = 0;
-    ps2::readData(&curKey); // Read the data returned by the keyboard in PS/2 Controller data
 
     if (curKey >= 0x81 && curKey <= 0xD8) { // Key released
         curKey -= 0x80;                     // Transform the released key code in a pressed key code
         if (curKey == KEY_LSHIFT || curKey == KEY_RSHIFT) {
             _shift = false;
+        } else if (curKey == KEY_LALT) {
+            _alt = false;
         }
+    } else if (_alt && curKey >= KEY_F1 && curKey <= KEY_F4) {
+        vga::setActiveConsole(curKey - KEY_F1);
+    } else if (_shift && curKey == KEY_PAGE_UP) {
+        vga::scrollView(KBD_SCROLL_LINES);
+    } else if (_shift && curKey == KEY_PAGE_DOWN) {
+        vga::scrollView(-KBD_SCROLL_LINES);
     } else if (curKey >= KEY_1 && curKey <= KEY_9) { // Is numeric
         asciiKey = curKey + 47;           // Offset in ascii table to the first numeric 1 char. Since numbers are in sequence resolve them
     } else if (curKey == KEY_0) {             // Since number isn't the last number in ascii we need to write its value manually
@@ -82,6 +147,8 @@ void kbd::keyboardIntHandler(registers_t* r) {
         asciiKey = ' ';
     } else if (curKey == KEY_LSHIFT || curKey == KEY_RSHIFT) {
         _shift = true;
+    } else if (curKey == KEY_LALT) {
+        _alt = true;
     } else if (curKey == KEY_CAPSLOCK) {
         _capslock = !_capslock;
     }
@@ -90,31 +157,133 @@ void kbd::keyboardIntHandler(registers_t* r) {
         asciiKey -= 0x20; // subtract from ASCII minor case to ASCII upper case equivalent.
     }
 
-    if (
-        asciiKey != 0 && ( // Ascii key received
-            (asciiKey == '\b' && keyboardBufferPos > 0) || // Is a backspace char and first item of buffer not reached.
-            (asciiKey != '\b' && keyboardBufferPos < KBD_KEY_BUFFER_SIZE - 1) // Is a new char and end of buffer not reached.
-        )
-    ) {
-        keyboardBuffer[keyboardBufferPos] = asciiKey == '\b' ? 0 : asciiKey; // If is a new char add char to buffer, If is a backspace add zero to current buffer position.
-        if (asciiKey != '\b') { // Is a new char increment keyboard buffer
-            keyboardBufferPos++;
-        } else {                // Is a backspace decrement keyboard buffer
-            keyboardBufferPos--;
+    return asciiKey;
+}
+
+/**
+ * @brief Keyboard tasklet. Decode the scan codes received by the interruption handler and pass the chars to the line work.
+ *
+ * @param data Unused
+ */
+void keyboardScanCodesTasklet(void*) {
+    uint32_t flags;
+    uint8_t curKey;
+    unsigned char asciiKey;
+    bool queued = false;
+
+    flags = spinlock::acquireIrqSave(&keyboardLock);
+    while (keyboardScanCodesTail != keyboardScanCodesHead) {
+        curKey = keyboardScanCodes[keyboardScanCodesTail++];
+        spinlock::releaseIrqRestore(&keyboardLock, flags);
+
+        asciiKey = keyboardDecode(curKey);      // Tasklets don't run on two cpus at the same time, the modifiers need no lock
+        lastKey = curKey;
+        // KPRINTF("KBD - lastKey %02x - curKey: %02x - asciiKey: %c\n", lastKey, curKey, (asciiKey != 0 ? asciiKey : ' '));
+
+        flags = spinlock::acquireIrqSave(&keyboardLock);
+        if (asciiKey != 0 && (uint8_t) (keyboardCharsHead + 1) != keyboardCharsTail) {   // Dropped when the worker is late a whole buffer
+            keyboardCharsConsole[keyboardCharsHead] = vga::getActiveConsole();
+            keyboardChars[keyboardCharsHead++] = asciiKey;
+            queued = true;
+        }
+    }
+    spinlock::releaseIrqRestore(&keyboardLock, flags);
+
+    if (queued) {
+        workqueue::queue(&keyboardLineWork);
+    }
+}
+
+/**
+ * @brief Keyboard line work. Edit the line with the typed chars and echo them on screen, then wake up the readers when a
+ *        line is complete. Runs in a worker thread, the screen output doesn't delay the interruptions.
+ *
+ * @param data Unused
+ */
+void keyboardLineWorker(void*) {
+    uint32_t flags;
+    unsigned char asciiKey;
+    uint8_t console;
+    char echo[2];
+
+    flags = spinlock::acquireIrqSave(&keyboardLock);
+    while (keyboardCharsTail != keyboardCharsHead) {
+        console = keyboardCharsConsole[keyboardCharsTail];
+        asciiKey = keyboardChars[keyboardCharsTail++];
+        if (
+            (asciiKey == '\b' && keyboardBufferPos[console] > 0) || // Is a backspace char and first item of buffer not reached.
+            (asciiKey != '\b' && keyboardBufferPos[console] < KBD_KEY_BUFFER_SIZE - 1) // Is a new char and end of buffer not reached.
+        ) {
+            keyboardBuffer[console][keyboardBufferPos[console]] = asciiKey == '\b' ? 0 : asciiKey; // If is a new char add char to buffer, If is a backspace add zero to current buffer position.
+            if (asciiKey != '\b') { // Is a new char increment keyboard buffer
+                keyboardBufferPos[console]++;
+            } else {                // Is a backspace decrement keyboard buffer
+                keyboardBufferPos[console]--;
+            }
+
+            spinlock::releaseIrqRestore(&keyboardLock, flags);
+            echo[0] = asciiKey;
+            echo[1] = 0;
+            vga::printStr(console, VGA_DEF_FORECOLOR, VGA_DEF_BGCOLOR, echo); // Write char on the console or perform the backspace. Echoed before the readers are woken up
+            flags = spinlock::acquireIrqSave(&keyboardLock);
+        }
+
+        if (asciiKey == '\n') {
+            keyboardBuffer[console][(keyboardBufferPos[console] > 0 ? keyboardBufferPos[console] - 1 : 0)] = 0;  // Add EOF in buffer in the same place of the \n to allow strlen measurement and remove \n from buffer.
+            string::strcpy(keyboardLine[console], keyboardBuffer[console]);  // Keep the line until a process reads it. The copy to the process memory is done in its own context.
+            keyboardLineReady[console] = true;
+            scheduler::wakeUp(&keyboardLineWaitQueue[console]);  // Wake up the processes of the console waiting for a keyboard line.
+            keyboardBufferPos[console] = 0;                     // Reset buffer offset to receive a new input line.
         }
-        
-        stdio::kprintf("%c", asciiKey); // Write char on screen or perform the backspace.
     }
+    spinlock::releaseIrqRestore(&keyboardLock, flags);
+}
+
+void kbd::keyboardIntHandler(registers_t* r) {
+    uint8_t curKey;
+    ps2::readData(&curKey); // Read the data returned by the keyboard in PS/2 Controller data
+
+    // Top half: only the scan code is stored, it's decoded by the tasklet with the interruptions enabled
+    spinlock::acquire(&keyboardLock);       // Interruptions are already disabled in the handler
+    if ((uint8_t) (keyboardScanCodesHead + 1) != keyboardScanCodesTail) {
+        keyboardScanCodes[keyboardScanCodesHead++] = curKey;
+    }
+    spinlock::release(&keyboardLock);
+
+    softirq::schedule(&keyboardTasklet);
+}
+
+void kbd::inputChar(uint8_t console, unsigned char asciiKey) {
+    uint32_t flags;
+    bool queued = false;
+
+    flags = spinlock::acquireIrqSave(&keyboardLock);
+    if ((uint8_t) (keyboardCharsHead + 1) != keyboardCharsTail) {   // Dropped when the worker is late a whole buffer
+        keyboardCharsConsole[keyboardCharsHead] = console;
+        keyboardChars[keyboardCharsHead++] = asciiKey;
+        queued = true;
+    }
+    spinlock::releaseIrqRestore(&keyboardLock, flags);
 
-    if (asciiKey == '\n') {
-        keyboardBuffer[(keyboardBufferPos > 0 ? keyboardBufferPos - 1 : 0)] = 0;      // Add EOF in buffer in the same place of the \n to allow strlen measurement and remove \n from buffer.
-        scheduler::kbdCreateResource(keyboardBuffer);   // Pass this resource to next keyboard process waiting for a keyboard resource.
-        keyboardBufferPos = 0;                          // Reset buffer offset to receive a new input line.
+    if (queued) {
+        workqueue::queue(&keyboardLineWork);
     }
+}
 
-    lastKey = curKey;
+void kbd::readLine(uint8_t console, char* dest) {
+    uint32_t flags;
+
+    mutex::lock(&keyboardReaderMutex[console]);         // Held while waiting, a spinlock can't be held by a blocked process
+    flags = spinlock::acquireIrqSave(&keyboardLock);
+    while (!keyboardLineReady[console]) {
+        scheduler::block(&keyboardLineWaitQueue[console], PROC_STATE_WAITING, &keyboardLock);  // Sleep until the keyboard worker receives a \n
+        spinlock::acquire(&keyboardLock);
+    }
 
-    // stdio::kprintf("KBD - lastKey %02x - curKey: %02x - asciiKey: %c - validation: %d\n", lastKey, curKey, (asciiKey != 0 ? asciiKey : ' '), keyboardBufferPos);
+    string::strcpy(dest, keyboardLine[console]);
+    keyboardLineReady[console] = false;                 // Each line is read by only one process
+    spinlock::releaseIrqRestore(&keyboardLock, flags);
+    mutex::unlock(&keyboardReaderMutex[console]);
 }
 
 uint8_t kbd::getCurrentScanCodeSet(uint8_t* scanCodeSet) {
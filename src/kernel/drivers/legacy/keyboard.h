@@ -2,6 +2,8 @@
 #ifndef _KEYBOARD_H_
 #define _KEYBOARD_H_
 
+// libc
+#include <stdint.h>
 // cpu
 #include "isr.h"
 
@@ -165,12 +167,32 @@ namespace kbd {
 
     /**
      * @brief Keyboard interruption handler, each time a key is pressed this interruption will be dispatched.
-     *        Then we need to read the data from ps2 controller data port
+     *        Then we need to read the data from ps2 controller data port.
+     *        Only the scan code is stored, a tasklet decodes it and a worker thread edits the line and echoes it.
      * 
      * @param r Pushed register of the given interruption
      */
     void keyboardIntHandler(registers_t* r);
 
+    /**
+     * @brief Add a char typed on another input device to the line of a console, edited and echoed like a key.
+     *        E.g the serial port. Called from a tasklet.
+     *
+     * @param console   Virtual console
+     * @param asciiKey  ASCII char, \n completes the line and \b erases the last char
+     */
+    void inputChar(uint8_t console, unsigned char asciiKey);
+
+    /**
+     * @brief Copy the next line typed in the keyboard to dest, without the \n.
+     *        The running process is blocked until a line is typed. Must be called from a syscall.
+     *        Each virtual console has its own line, the keys go to the console shown on the screen (Alt+F1..F4).
+     * 
+     * @param console   Virtual console of the running process
+     * @param dest      Buffer with at least 256 bytes, in the running process memory
+     */
+    void readLine(uint8_t console, char* dest);
+
     /**
      * @brief Get the Current Scan Code of the keyboard device. This communicates with keyboard. 
      * 
@@ -1,14 +1,24 @@
 // cpu
 #include "pic.h"
+#include "apic.h"
 #include "isr.h"
+#include "tsc.h"
 // stdlib
 #include "stdio.h"
 #include "stdlib.h"
+// process
+#include "queue.h"
+#include "scheduler.h"
+// sys
+#include "timer.h"
+#include "klog.h"
+// drivers
+#include "hpet.h"
+#include "vga.h"
 // sys
 #include "io.h"
 #include "pit.h"
 
-#define PIT_CRYSTAL_FREQUENCY 1193182       // The PIT contains a crystal oscillator which emits a signal 1193182 hz.
 #define MIN_FREQ_DIVISOR            1       // 1 is the min, because 0 is interpreted as 65536
 #define MAX_FREQ_DIVISOR        65535       // 65535 is the max because the divisor is 16 bits long and the MAX 16 bit value is 65535.
 
@@ -17,6 +27,7 @@
 #define IO_CHANNEL_2             0x42       // Channel 2 (Read/Write) Connected to PC Speaker. So the frequency of the output determines the frequency of the sound produced by the speaker. Controlled by software (via bit 0 of I/O port 0x61). Output (a high or low voltage) can be read by software (via bit 5 of I/O port 0x61)
 
 #define IO_CR                    0x43       // Mode/Command register (write only, a read is ignored)
+#define IO_CHANNEL_2_GATE        0x61       // Bit 0: channel 2 gate, Bit 1: speaker enable, Bit 5: channel 2 output (read only)
 
 /**
  * @brief Select channel (Bits 7-6)
@@ -56,32 +67,128 @@
 #define CMD_BCD_16_BIT                   0x0       // 16 Bit (Min=0, Max=65535)
 #define CMD_BCD_4_DIGIT                  0x1       // 4 decimal digits (Min=0, Max=9999)
 
-#define TIMER_BLOCK_BUF_SIZE 2                     // Amount of countdown timers available to user and driver threads
-
 uint32_t channel0Divisor;
 
-struct TimerBlock {
-    uint8_t id;
-    uint32_t countdown;
-} timerBlocks[TIMER_BLOCK_BUF_SIZE];
+#define CMD_LATCH_CHANNEL_0              0x00      // Latch count value command of channel 0. The count is read from IO_CHANNEL_0 lobyte then hibyte
+#define TICKLESS_MAX_TICKS               256       // Max ticks skipped by one PIT one-shot. The 16 bits count limits it to 65 ticks at 1000 Hz
+#define TICKLESS_MAX_TICKS_HPET         2048       // Max ticks skipped by one HPET one-shot, limited by the timer wheel scan
+#define TICKLESS_IDLE                    true      // false keeps the periodic tick while idle, to compare the idle wakeups of both modes
 
 uint32_t kCountdownTimer; // Kernel countdown timer
+Queue sleepingProcesses;  // Processes blocked in pit::sleep
+uint32_t ticklessTicks;   // Ticks programmed in the one-shot while the cpu is idle. 0 when the timer is periodic
+uint32_t ticklessCount;   // PIT count programmed in the one-shot
+bool ticklessHpet;        // The one-shot is the HPET comparator, the PIT interruption is masked
+
+/**
+ * @brief Program the channel 0 mode and reload value. Reload value of 0 is interpreted as 65536.
+ * 
+ * @param opMode    CMD_OPMODE_INT_ON_TERM_COUNT (one-shot) or CMD_OPMODE_SQUARE_WAVE (periodic)
+ * @param count     Reload value
+ */
+void programChannel0(uint8_t opMode, uint16_t count) {
+    uint8_t command = (CMD_CHANNEL_0 << 6) | (CMD_AM_LO_HI_BYTE << 4) | ((opMode & 0x7) << 1) | CMD_BCD_16_BIT;
+
+    io::outb(IO_CR, command);
+    io::outb(IO_CHANNEL_0, (uint8_t) (count & 0xFF));
+    io::outb(IO_CHANNEL_0, (uint8_t) ((count >> 8) & 0xFF));
+}
+
+/**
+ * @brief Read the current count of channel 0
+ * 
+ * @return uint16_t Count
+ */
+uint16_t readChannel0Count() {
+    uint8_t low, high;
+
+    io::outb(IO_CR, CMD_LATCH_CHANNEL_0);
+    low = io::inb(IO_CHANNEL_0);
+    high = io::inb(IO_CHANNEL_0);
+    return ((uint16_t) high << 8) | low;
+}
+
+/**
+ * @brief Convert milliseconds to channel 0 ticks, rounded up. A tick is channel0Divisor PIT clocks of 838.095 ns,
+ *        channel0Divisor is the reload count and not the tick rate.
+ *
+ * @param millis        Milliseconds
+ * @return uint32_t     Ticks, limited to half the tick counter range so the timer wheel sees them in the future
+ */
+uint32_t millisToTicks(uint32_t millis) {
+    uint32_t periodNs = pit::getTickPeriodNs();
+    uint64_t ticks = stdlib::udiv64((uint64_t) millis * 1000000 + periodNs - 1, periodNs, NULL);
+
+    return ticks < 0x7FFFFFFF ? (uint32_t) ticks : 0x7FFFFFFF;
+}
+
+/**
+ * @brief Account the given elapsed ticks
+ * 
+ * @param elapsed Ticks elapsed since the last accounted tick
+ */
+void advanceTicks(uint32_t elapsed) {
+    while (elapsed-- > 0) {
+        if (kCountdownTimer > 0) {  // Decrement kernel countdown timer until reaches 0.
+            kCountdownTimer--;
+        }
+
+        timer::tick();              // Run the expired kernel timers
+    }
+}
+
+/**
+ * @brief Leave the one-shot mode and restore the periodic timer
+ * 
+ * @return uint32_t Ticks elapsed since the one-shot was programmed
+ */
+uint32_t leaveOneShot() {
+    uint32_t remaining;
+    uint32_t elapsed;
+
+    remaining = readChannel0Count();
+    if (remaining == 0 || remaining > ticklessCount) { // Terminal count reached, the count wrapped around
+        elapsed = ticklessTicks;
+    } else {                                           // Woken up before the one-shot expired
+        elapsed = (ticklessCount - remaining) / channel0Divisor;
+    }
+
+    ticklessTicks = 0;
+    programChannel0(CMD_OPMODE_SQUARE_WAVE, channel0Divisor);
+    return elapsed;
+}
 
 void timerInterruptHandler(registers_t* r) {
-    // On each tick exchange the user process
-    // In case of one countdown timer finishes change to this process instead
-    if (kCountdownTimer > 0) {  // Decrement kernel countdown timer until reaches 0.
-        kCountdownTimer--;
+    uint32_t elapsed = 1;
+
+    if (ticklessTicks > 0 && !ticklessHpet) { // One-shot expired, or a periodic tick was pending when it was programmed
+        elapsed = leaveOneShot();
+        if (elapsed == 0) {
+            elapsed = 1;
+        }
     }
+
+    advanceTicks(elapsed);
+    klog::scheduleDrain();                    // Kernel log records added by the interruption handlers
+    vga::scheduleFlush();                     // At most one screen update per tick, after the handler
+}
+
+/**
+ * @brief Sleep timer callback. Move the sleeping process back to the ready queue.
+ * 
+ * @param data PID = PCB* of the sleeping process
+ */
+void sleepTimerExpired(void* data) {
+    scheduler::wakeUpProcess(&sleepingProcesses, (PID) data);
 }
 
 void pit::install() {
-    uint8_t i;
     // Zero fill .bss unitialized data. Must be initialized.
-    for (i=0; i<TIMER_BLOCK_BUF_SIZE; i++) {
-        timerBlocks[i].id = 0;
-        timerBlocks[i].id = 0;
-    }
+    kCountdownTimer = 0;
+    ticklessTicks = 0;
+    ticklessCount = 0;
+    ticklessHpet = false;
+    queue::init(&sleepingProcesses);
 
     // Setup the handler
     isr::registerIsrHandler(IRQ0, timerInterruptHandler);
@@ -91,11 +198,19 @@ void pit::install() {
 }
 
 void pit::enable() {
-    pic::clearMask(0); // 0 = IRQ0
+    if (apic::isEnabled()) {
+        apic::clearMask(0);
+    } else {
+        pic::clearMask(0); // 0 = IRQ0
+    }
 }
 
 void pit::disable() {
-    pic::setMask(0);   // 0 = IRQ0
+    if (apic::isEnabled()) {
+        apic::setMask(0);
+    } else {
+        pic::setMask(0);   // 0 = IRQ0
+    }
 }
 
 void pit::configureChannel(uint16_t channel, uint8_t accessMode, uint8_t opMode, uint8_t bcdBinMode, uint16_t divisor) {
@@ -118,7 +233,7 @@ void pit::configureChannel(uint16_t channel, uint8_t accessMode, uint8_t opMode,
     command = (command << 3) | (opMode & 0x7);
     command = (command << 1) | (bcdBinMode & 0x1);
     
-    stdio::kprintf("");
+    KPRINTF("");
 
     // Issue the commands
     io::outb(IO_CR, command);
@@ -126,35 +241,127 @@ void pit::configureChannel(uint16_t channel, uint8_t accessMode, uint8_t opMode,
 	io::outb(channel, high);
 }
 
-TimerBlock* findTimerBlock() {
-    int i;
-    for (i=0; i<TIMER_BLOCK_BUF_SIZE; i++) {
-        if (timerBlocks[i].id == NULL) {
-            timerBlocks->id = i + 1;    // Id - index of this timer
-            return &timerBlocks[i];
+void pit::idleEnter() {
+    uint32_t maxTicks = 0xFFFF / channel0Divisor;  // One-shot count is 16 bits long
+    uint32_t ticks;
+
+    if (!TICKLESS_IDLE) {
+        return;
+    }
+    if (maxTicks > TICKLESS_MAX_TICKS) {
+        maxTicks = TICKLESS_MAX_TICKS;
+    }
+    if (hpet::isEnabled()) {
+        maxTicks = TICKLESS_MAX_TICKS_HPET;
+    }
+
+    ticks = timer::ticksToNextTimer(maxTicks);
+    if (ticks <= 1) {                               // Next tick is needed anyway, keep the periodic timer
+        return;
+    }
+
+    if (hpet::isEnabled()) {                        // The HPET comparator wakes the cpu, the periodic PIT keeps counting masked
+        if (hpet::oneShotStart(ticks * pit::getTickPeriodNs())) {
+            pit::disable();
+            ticklessTicks = ticks;
+            ticklessHpet = true;
         }
+        return;
     }
-    return NULL;
+
+    ticklessTicks = ticks;
+    ticklessCount = ticks * channel0Divisor;
+    programChannel0(CMD_OPMODE_INT_ON_TERM_COUNT, ticklessCount);
 }
 
-void pit::sleep(uint32_t millis) {
-    struct TimerBlock* t;
-    if ((t = findTimerBlock()) == NULL) { // All timer blocks in use by the processes
+void pit::idleExit() {
+    if (ticklessTicks == 0) {                       // Periodic timer or the one-shot already expired
+        return;
+    }
+
+    if (ticklessHpet) {
+        hpet::oneShotStop();
+        pit::enable();
+        ticklessTicks = 0;
+        ticklessHpet = false;
+        advanceTicks(hpet::oneShotElapsedNs() / pit::getTickPeriodNs());
         return;
     }
 
-    // We need to perform a rule of 3 to know how many ticks are necessary to decrement a given amount of milliseconds.
-    // channel0Divisor ----> 1000 millis
-    // kCountdownTimer ----> millis
-    t->countdown = millis * channel0Divisor / 1000;
+    // Woken up by another interruption before the one-shot expired. Account only the ticks that really elapsed.
+    advanceTicks(leaveOneShot());
+}
+
+/**
+ * @brief Start a count down of channel 2 in interrupt on terminal count mode. The speaker is kept disabled.
+ * 
+ * @param count         PIT clocks to count
+ * @return uint8_t      Previous value of the channel 2 gate port, restored by channel2Stop
+ */
+uint8_t channel2Start(uint16_t count) {
+    uint8_t gate = io::inb(IO_CHANNEL_2_GATE);
+
+    io::outb(IO_CHANNEL_2_GATE, (gate & ~0x02) | 0x01);             // Gate high to count, speaker disabled
+    io::outb(IO_CR, (CMD_CHANNEL_2 << 6) | (CMD_AM_LO_HI_BYTE << 4) | (CMD_OPMODE_INT_ON_TERM_COUNT << 1) | CMD_BCD_16_BIT);
+    io::outb(IO_CHANNEL_2, (uint8_t) (count & 0xFF));
+    io::outb(IO_CHANNEL_2, (uint8_t) ((count >> 8) & 0xFF));        // Counting starts after the hibyte is written
+    return gate;
+}
+
+/**
+ * @brief Wait until the channel 2 count down reaches the terminal count
+ * 
+ */
+void channel2Wait() {
+    while ((io::inb(IO_CHANNEL_2_GATE) & 0x20) == 0) {}             // Output goes high on the terminal count
+}
+
+uint32_t pit::measureTsc(uint16_t count) {
+    uint32_t flags;
+    uint8_t gate;
+    uint64_t start;
+    uint64_t end;
+
+    asm volatile("pushf; pop %0; cli" : /* output */ "=r"(flags));  // No interruption can delay the measurement
+
+    gate = channel2Start(count);
+    start = tsc::read();
+    channel2Wait();
+    end = tsc::read();
+
+    io::outb(IO_CHANNEL_2_GATE, gate);
+    asm volatile("push %0; popf" : /* output */ : /* input */ "r"(flags));
+
+    return (uint32_t) (end - start);
+}
+
+void pit::busyWait(uint16_t count) {
+    uint8_t gate = channel2Start(count);
+
+    channel2Wait();
+    io::outb(IO_CHANNEL_2_GATE, gate);
+}
+
+uint32_t pit::getTickPeriodNs() {
+    // Each PIT clock takes 1000000000 / 1193182 = 838.095 ns
+    return channel0Divisor * 838 + channel0Divisor * 95 / 1000;
+}
+
+void pit::sleep(uint32_t millis) {
+    PID pid = scheduler::getRunningProcess();
+
+    uint32_t sleepTicks = millisToTicks(millis);                    // Rounded up, never sleep less than asked
+    if (sleepTicks == 0) {
+        return;
+    }
 
+    timer::init(&pid->sleepTimer, sleepTimerExpired, pid);
+    timer::add(&pid->sleepTimer, timer::getTicks() + sleepTicks);
+    scheduler::block(&sleepingProcesses, PROC_STATE_SLEEPING);     // Other processes are executed until the timer wakes up this process
 }
 
 void pit::ksleep(uint32_t millis) {
-    // We need to perform a rule of 3 to know how many ticks are necessary to decrement a given amount of milliseconds.
-    // channel0Divisor ----> 1000 millis
-    // kCountdownTimer ----> millis
-    kCountdownTimer = millis * channel0Divisor / 1000;
+    kCountdownTimer = millisToTicks(millis);
     while(kCountdownTimer > 0) {
         __asm__ volatile ("hlt"); // Halt the cpu. Waits until an IRQ occurs minimize CPU usage
     } // Wait until countdown timer reaches 0 then continue execution.
@@ -5,6 +5,8 @@
 // libc
 #include <stdint.h>
 
+#define PIT_CRYSTAL_FREQUENCY 1193182       // The PIT contains a crystal oscillator which emits a signal 1193182 hz.
+
 /**
  * @brief PIT - Programmable Interval Timer
  * 
@@ -284,9 +286,50 @@ namespace pit {
     void configureChannel(uint16_t channel, uint8_t accessMode, uint8_t opMode, uint8_t bcdBinMode, uint16_t divisor);
 
     /**
-     * @brief Thread sleep function
+     * @brief Measure the TSC cycles elapsed while the PIT channel 2 counts down. Used to calibrate the TSC frequency.
+     *        Channel 2 is connected to the PC speaker, the speaker is kept disabled.
+     * 
+     * @param count         PIT clocks to wait (1193182 per second)
+     * @return uint32_t     TSC cycles elapsed
+     */
+    uint32_t measureTsc(uint16_t count);
+
+    /**
+     * @brief Busy wait the given PIT clocks counted by channel 2. Used to calibrate other timers with the interruptions disabled.
+     * 
+     * @param count PIT clocks to wait (1193182 per second)
+     */
+    void busyWait(uint16_t count);
+
+    /**
+     * @brief Get the duration of one timer tick
+     * 
+     * @return uint32_t Nanoseconds per tick
+     */
+    uint32_t getTickPeriodNs();
+
+    /**
+     * @brief Called by the idle loop of cpu 0 before halting the cpu, with interruptions disabled and the kernel lock held.
+     *        If no kernel timer expires on the next tick, the periodic timer is replaced by a one-shot that expires on the next
+     *        timer deadline, so the idle cpu isn't woken up by useless ticks.
+     *        The HPET comparator is used as the one-shot when available, the PIT interruption is masked meanwhile.
+     *        Only called when every cpu is idle, a process of another cpu would add its timers after the deadline was computed.
+     */
+    void idleEnter();
+
+    /**
+     * @brief Called by the idle loop of any cpu after it's woken up, with interruptions disabled and the kernel lock held.
+     *        If the one-shot didn't expire yet, account the elapsed ticks and restore the periodic timer.
+     *        An application processor woken up to run a process ends the one-shot of cpu 0, so the process sleeps from the
+     *        current tick and its timer expiry is seen by the periodic tick.
+     */
+    void idleExit();
+
+    /**
+     * @brief Process sleep function. The running process is blocked and other processes are executed meanwhile.
+     *        Must be called from a syscall.
      * 
-     * @param millis Milliseconds to wait until continue thread execution. 
+     * @param millis Milliseconds to wait until continue process execution. 
      *               The accuracy will depend on the divisor frequency of the PIT Channel 0. The higher is divisor the better is accuracy.
      *               The minimum millis depend on the divisor frequency of the PIT Channel 0. For a 0 divisor the minimum millis is 56.
      */
@@ -141,7 +141,7 @@ void ps2Port1IntHandler(registers_t* r) {
             ps2Port1DataBuffer[ps2Port1DataLength] = data;
             ps2Port1DataLength++;
         }
-        // stdio::kprintf("PS/2 port1 %x\n", data);
+        // KPRINTF("PS/2 port1 %x\n", data);
     }
 }
 
@@ -153,7 +153,7 @@ void ps2Port2IntHandler(registers_t* r) {
             ps2Port2DataBuffer[ps2Port2DataLength] = data;
             ps2Port2DataLength++;
         }
-        // stdio::kprintf("PS/2 port2 %x\n", data);
+        // KPRINTF("PS/2 port2 %x\n", data);
     }
 }
 
@@ -374,7 +374,7 @@ uint8_t ps2::install() {
     // Read configuration sent by controller to data buffer
     data = io::inb(IO_DATA);
 
-    // stdio::kprintf("PS/2 - old config: %08b\n", data);
+    // KPRINTF("PS/2 - old config: %08b\n", data);
 
     // Enable first PS/2 port interrupt bit 0
     data |= CTRL_CONF_PS2_PORT2_INT_ENABLED + CTRL_CONF_PS2_PORT1_INT_ENABLED;
@@ -416,7 +416,7 @@ uint8_t ps2::install() {
     
     // Read configuration sent by controller to data buffer
     data = io::inb(IO_DATA);
-    // stdio::kprintf("PS/2 - new config: %08b\n", data);
+    // KPRINTF("PS/2 - new config: %08b\n", data);
     
     // Wait until Input bit status cleared
     data = waitUntilStatusBitEquals(first_bit_set_index(STATUS_IN_BUFFER_STATUS), 0);
@@ -469,12 +469,12 @@ uint8_t ps2::install() {
     // Read configuration sent by controller to data buffer
     data = io::inb(IO_DATA);
 
-    // stdio::kprintf("PS/2 - config: %08b\n", data);
+    // KPRINTF("PS/2 - config: %08b\n", data);
 
     if (!(data & CTRL_CONF_PS2_PORT2_CLOCK_ENABLED)) { // If this bit is clear it's a dual channel, if set isn't dual channel
         // Is dual channel
         isDualChannel = true;
-        // stdio::kprintf("PS/2 - Is dual channel\n", data);
+        // KPRINTF("PS/2 - Is dual channel\n", data);
     }
     
     // Wait until Input bit status cleared
@@ -682,11 +682,11 @@ uint8_t ps2::install() {
             kbd::install();
         }
 
-        stdio::kprintf("PS/2 port1 device type: %d\n", ps2Port1DeviceId);
+        KPRINTF("PS/2 port1 device type: %d\n", ps2Port1DeviceId);
     }
 
     // if (isPort2DevicePresent) {
-    //     // stdio::kprintf("port2 device present\n");
+    //     // KPRINTF("port2 device present\n");
     // }
 
     // isr::registerIsrHandler(IRQ1, kbd::keyboardIntHandler);   // Register PS/2 Controller port1 IRQ handler
@@ -0,0 +1,260 @@
+// libc
+#include <stdint.h>
+// cpu
+#include "isr.h"
+// sys
+#include "io.h"
+#include "spinlock.h"
+#include "softirq.h"
+// stdlibs
+#include "string.h"
+// drivers
+#include "keyboard.h"
+#include "vga.h"
+#include "serial.h"
+
+#define SERIAL_NO_PORT 0xFFFF           // serialPort before serial::install found the UART
+
+#define REG_DATA 0                      // RBR / THR, DLL when DLAB is set
+#define REG_IER 1                       // Interrupt enable, DLM when DLAB is set
+#define REG_IIR 2                       // Interrupt identification (read)
+#define REG_FCR 2                       // FIFO control (write)
+#define REG_LCR 3                       // Line control
+#define REG_MCR 4                       // Modem control
+#define REG_LSR 5                       // Line status
+#define REG_MSR 6                       // Modem status
+
+#define IER_RX_AVAILABLE 0x01           // Received data available interruption
+#define IER_THR_EMPTY 0x02              // Transmitter holding register empty interruption (THRE)
+#define LCR_8N1 0x03                    // 8 data bits, no parity, 1 stop bit
+#define LCR_DLAB 0x80                   // Divisor latch access
+#define FCR_ENABLE_CLEAR_14 0xC7        // Enable and clear the FIFOs, RX interruption at 14 bytes
+#define MCR_DTR_RTS_OUT2 0x0B           // OUT2 connects the UART interruption to the IRQ line
+#define MCR_LOOPBACK 0x1E               // Loopback mode with RTS, OUT1 and OUT2, used to test the UART
+#define LSR_DATA_READY 0x01
+#define LSR_THR_EMPTY 0x20
+#define IIR_NO_INTERRUPT 0x01
+#define IIR_CAUSE_MASK 0x0E
+#define IIR_FIFO_ENABLED 0xC0           // Both bits set on a 16550A with a working FIFO
+#define IIR_MODEM_STATUS 0x00
+#define IIR_THR_EMPTY 0x02
+#define IIR_RX_AVAILABLE 0x04
+#define IIR_LINE_STATUS 0x06
+#define IIR_RX_TIMEOUT 0x0C
+
+#define LOOPBACK_TEST_BYTE 0xAE
+
+uint16_t serialPort = SERIAL_NO_PORT;   // Initialized data, serial::write can be called by the kernel console before serial::install
+uint8_t serialFifoSize;                 // Bytes written at each THRE interruption, 1 without a working FIFO
+char serialTxRing[SERIAL_TX_RING_SIZE];
+uint32_t serialTxHead;                  // Next byte written by serial::write
+uint32_t serialTxTail;                  // Next byte sent to the transmitter
+bool serialTxRunning;                   // THRE interruption enabled, the handler refills the FIFO
+uint32_t serialTxDropped;
+uint8_t serialRxRing[SERIAL_RX_RING_SIZE];
+uint8_t serialRxHead;
+uint8_t serialRxTail;
+Spinlock serialLock;                    // Protects the rings and the UART registers, taken by the interruption handler
+Tasklet serialRxTasklet;
+
+// ===================== PRIVATE =======================
+
+/**
+ * @brief Add a byte to the TX ring, or count it as dropped when the ring is full. Called with serialLock held.
+ *
+ * @param c Byte
+ */
+void serialPutLocked(char c) {
+    if ((serialTxHead + 1) % SERIAL_TX_RING_SIZE == serialTxTail) {
+        serialTxDropped++;
+        return;
+    }
+    serialTxRing[serialTxHead] = c;
+    serialTxHead = (serialTxHead + 1) % SERIAL_TX_RING_SIZE;
+}
+
+/**
+ * @brief Write up to a FIFO of bytes from the TX ring in the empty transmitter. Called with serialLock held.
+ *
+ * @return uint8_t Bytes written, 0 when the ring is empty
+ */
+uint8_t serialFillFifoLocked() {
+    uint8_t i;
+
+    for (i = 0; i < serialFifoSize && serialTxTail != serialTxHead; i++) {
+        io::outb(serialPort + REG_DATA, serialTxRing[serialTxTail]);
+        serialTxTail = (serialTxTail + 1) % SERIAL_TX_RING_SIZE;
+    }
+    return i;
+}
+
+/**
+ * @brief Refill the transmitter from the TX ring. The THRE interruption stays enabled while bytes are sent, the
+ *        transmitter is idle when the ring is empty. Called with serialLock held.
+ *
+ */
+void serialTransmitLocked() {
+    serialTxRunning = serialFillFifoLocked() > 0;
+    io::outb(serialPort + REG_IER, IER_RX_AVAILABLE | (serialTxRunning ? IER_THR_EMPTY : 0));
+}
+
+/**
+ * @brief IRQ4 handler. Serves every pending cause of the UART: stores the received bytes and refills the transmitter.
+ *
+ * @param r Pushed registers of the interruption
+ */
+void serialIntHandler(registers_t*) {
+    uint8_t iir;
+    bool received = false;
+
+    spinlock::acquire(&serialLock);         // Interruptions are already disabled in the handler
+    while (((iir = io::inb(serialPort + REG_IIR)) & IIR_NO_INTERRUPT) == 0) {
+        switch (iir & IIR_CAUSE_MASK) {
+            case IIR_RX_AVAILABLE:
+            case IIR_RX_TIMEOUT:
+                while ((io::inb(serialPort + REG_LSR) & LSR_DATA_READY) != 0) {
+                    serialRxRing[serialRxHead] = io::inb(serialPort + REG_DATA);
+                    if ((uint8_t) (serialRxHead + 1) != serialRxTail) {  // Dropped when the tasklet is late a whole ring
+                        serialRxHead++;
+                    }
+                }
+                received = true;
+                break;
+            case IIR_THR_EMPTY:
+                serialTransmitLocked();
+                break;
+            case IIR_LINE_STATUS:
+                io::inb(serialPort + REG_LSR);  // Reading the status clears the overrun, parity and framing errors
+                break;
+            case IIR_MODEM_STATUS:
+            default:
+                io::inb(serialPort + REG_MSR);      // Reading the status clears the interruption
+                break;
+        }
+    }
+    spinlock::release(&serialLock);
+
+    if (received) {
+        softirq::schedule(&serialRxTasklet);
+    }
+}
+
+/**
+ * @brief RX tasklet. Pass the received bytes to the keyboard line of the kernel console.
+ *
+ * @param data Unused
+ */
+void serialRxTaskletFunc(void*) {
+    uint32_t flags;
+    unsigned char c;
+
+    flags = spinlock::acquireIrqSave(&serialLock);
+    while (serialRxTail != serialRxHead) {
+        c = serialRxRing[serialRxTail++];
+        spinlock::releaseIrqRestore(&serialLock, flags);
+
+        if (c == '\r') {                    // Terminals send \r for the enter key
+            c = '\n';
+        } else if (c == 0x7F) {             // And DEL for the backspace key
+            c = '\b';
+        }
+        if (c == '\n' || c == '\b' || c == '\t' || (c >= ' ' && c < 0x7F)) {
+            kbd::inputChar(VGA_KERNEL_CONSOLE, c);
+        }
+
+        flags = spinlock::acquireIrqSave(&serialLock);
+    }
+    spinlock::releaseIrqRestore(&serialLock, flags);
+}
+
+// ====================== PUBLIC =======================
+
+uint8_t serial::install() {
+    uint16_t divisor = 115200 / SERIAL_BAUD_RATE;
+
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    serialPort = SERIAL_NO_PORT;
+    serialTxHead = 0;
+    serialTxTail = 0;
+    serialTxRunning = false;
+    serialTxDropped = 0;
+    serialRxHead = 0;
+    serialRxTail = 0;
+    spinlock::init(&serialLock, "serial");
+    softirq::initTasklet(&serialRxTasklet, serialRxTaskletFunc, NULL);
+
+    io::outb(SERIAL_COM1 + REG_IER, 0);                 // No interruption while it's configured
+    io::outb(SERIAL_COM1 + REG_LCR, LCR_DLAB);
+    io::outb(SERIAL_COM1 + REG_DATA, divisor & 0xFF);
+    io::outb(SERIAL_COM1 + REG_IER, divisor >> 8);
+    io::outb(SERIAL_COM1 + REG_LCR, LCR_8N1);
+    io::outb(SERIAL_COM1 + REG_FCR, FCR_ENABLE_CLEAR_14);
+
+    // A byte sent in loopback mode must be received back, a missing port reads 0xFF
+    io::outb(SERIAL_COM1 + REG_MCR, MCR_LOOPBACK);
+    io::outb(SERIAL_COM1 + REG_DATA, LOOPBACK_TEST_BYTE);
+    if (io::inb(SERIAL_COM1 + REG_DATA) != LOOPBACK_TEST_BYTE) {
+        return SERIAL_ERROR_NOT_PRESENT;
+    }
+    io::outb(SERIAL_COM1 + REG_MCR, MCR_DTR_RTS_OUT2);
+
+    serialFifoSize = (io::inb(SERIAL_COM1 + REG_IIR) & IIR_FIFO_ENABLED) == IIR_FIFO_ENABLED ? SERIAL_FIFO_SIZE : 1;
+    serialPort = SERIAL_COM1;
+    isr::registerIsrHandler(IRQ4, serialIntHandler);
+    io::outb(SERIAL_COM1 + REG_IER, IER_RX_AVAILABLE);
+
+    return SERIAL_NO_ERROR;
+}
+
+void serial::write(const char* str) {
+    serial::write(str, string::strlen(str));
+}
+
+void serial::write(const char* str, uint32_t length) {
+    const char* end = str + length;
+    uint32_t flags;
+
+    if (serialPort == SERIAL_NO_PORT) {
+        return;
+    }
+
+    flags = spinlock::acquireIrqSave(&serialLock);
+    for (; str < end; str++) {
+        if (*str == '\n') {
+            serialPutLocked('\r');
+            serialPutLocked('\n');
+        } else if (*str == '\b') {              // Erase the char like the screen does
+            serialPutLocked('\b');
+            serialPutLocked(' ');
+            serialPutLocked('\b');
+        } else {
+            serialPutLocked(*str);
+        }
+    }
+    if (!serialTxRunning) {                     // Idle transmitter, the next bytes are sent by the THRE interruptions
+        serialTransmitLocked();
+    }
+    spinlock::releaseIrqRestore(&serialLock, flags);
+}
+
+void serial::flush() {
+    uint32_t flags;
+
+    if (serialPort == SERIAL_NO_PORT) {
+        return;
+    }
+
+    flags = spinlock::acquireIrqSave(&serialLock);
+    io::outb(serialPort + REG_IER, 0);          // The halted cpu won't serve the interruption anymore
+    while (serialTxTail != serialTxHead) {
+        while ((io::inb(serialPort + REG_LSR) & LSR_THR_EMPTY) == 0) {
+        }
+        serialFillFifoLocked();
+    }
+    serialTxRunning = false;
+    spinlock::releaseIrqRestore(&serialLock, flags);
+}
+
+uint32_t serial::getDroppedBytes() {
+    return serialTxDropped;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef _SERIAL_H_
+#define _SERIAL_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SERIAL_NO_ERROR 0                       // No error happend. Same as Success
+#define SERIAL_ERROR_NOT_PRESENT 1              // The loopback test failed, no UART at the port
+
+#define SERIAL_COM1 0x3F8                       // I/O base port of COM1, IRQ4
+#define SERIAL_BAUD_RATE 115200                 // Divisor 1 of the 115200 Hz UART clock
+#define SERIAL_FIFO_SIZE 16                     // Bytes written in the transmitter FIFO of a 16550A at each THRE interruption
+#define SERIAL_TX_RING_SIZE 16384               // Output waiting for the transmitter. Holds the boot messages printed before the interruptions are enabled
+#define SERIAL_RX_RING_SIZE 256                 // Input received by the interruption handler, indexed with uint8_t so it wraps around by itself
+
+/**
+ * @brief SERIAL - 16550 UART serial console on COM1
+ *
+ * REGISTERS (I/O base + offset):
+ *  _____________________________________________________________________________________
+ * | OFFSET | DLAB |   READ                          |   WRITE                          |
+ * |   0    |  0   |   RBR - Receiver buffer         |   THR - Transmitter holding      |
+ * |   1    |  0   |   IER - Interrupt enable        |   IER - Interrupt enable         |
+ * |  0, 1  |  1   |   DLL, DLM - Baud rate divisor  |   DLL, DLM - Baud rate divisor   |
+ * |   2    |  -   |   IIR - Interrupt identification|   FCR - FIFO control             |
+ * |   3    |  -   |   LCR - Line control, bit 7 DLAB|   LCR - Line control             |
+ * |   4    |  -   |   MCR - Modem control           |   MCR - Modem control            |
+ * |   5    |  -   |   LSR - Line status             |   -                              |
+ * |   6    |  -   |   MSR - Modem status            |   -                              |
+ *  ‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+ *
+ * TRANSMISSION:
+ *    - serial::write only copies the text in the TX ring. When the transmitter is idle it fills the FIFO and enables
+ *      the THRE interruption, each IRQ4 refills the FIFO with up to SERIAL_FIFO_SIZE bytes until the ring is empty.
+ *    - No byte is busy-waited. When the ring is full the output is dropped and counted.
+ *    - \n is sent as \r\n and a backspace erases the char, so a terminal shows the same text as the screen.
+ *
+ * RECEPTION:
+ *    - The IRQ4 handler stores the received bytes in the RX ring and schedules a tasklet. The tasklet passes them to the
+ *      keyboard line of the kernel console, so readln receives the lines typed on the serial port too. \r is a \n.
+ *
+ * CONSOLE:
+ *    - Everything printed on the kernel console (vga.h VGA_KERNEL_CONSOLE) is also written on COM1: the kernel
+ *      messages and the output of the first shell. E.g qemu -serial stdio.
+ */
+namespace serial {
+    /**
+     * @brief Configure COM1 (115200 8N1, FIFO enabled) and its IRQ4 handler. Must be called after isr::install.
+     *
+     * @return uint8_t Error code: SERIAL_NO_ERROR or SERIAL_ERROR_NOT_PRESENT
+     */
+    uint8_t install();
+
+    /**
+     * @brief Queue a text to be sent on COM1, nothing is sent when the port isn't present
+     *
+     * @param str Text to be sent
+     */
+    void write(const char* str);
+
+    /**
+     * @brief Queue a text of a given length to be sent on COM1
+     *
+     * @param str    Text to be sent
+     * @param length Bytes of the text
+     */
+    void write(const char* str, uint32_t length);
+
+    /**
+     * @brief Send the whole TX ring, busy-waiting the transmitter. Only called before the cpu is halted by a fatal error.
+     */
+    void flush();
+
+    /**
+     * @brief Get the bytes dropped because the TX ring was full
+     *
+     * @return uint32_t Dropped bytes since serial::install
+     */
+    uint32_t getDroppedBytes();
+}
+
+#endif
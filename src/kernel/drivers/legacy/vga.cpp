@@ -2,30 +2,84 @@
 #include "io.h"
 #include "memutils.h"
 #include "stdlib.h"     // debug only
+#include "string.h"
+#include "spinlock.h"
+#include "softirq.h"
+#include "smp.h"
+#include "serial.h"
+#include "vbe.h"
 #include <stdint.h>
 
 int vgaAddress = 0xB8000;
 
-#define WIDTH 80
-#define HEIGHT 25
+#define VGA_TEXT_WIDTH 80
+#define VGA_TEXT_HEIGHT 25
 
 // #define VGA_ADDRESS 0xB8000
 // #define VGA_BUFFER ((uint16_t*) VGA_ADDRESS)
 
 // The Screen max offset pos
-#define SCREEN_MAX_OFFSET_POS (vgaAddress + (WIDTH * HEIGHT * 2))
+#define SCREEN_MAX_OFFSET_POS (vgaWidth * vgaHeight)
+// Chars in the color text memory, 0xB8000 - 0xBFFFF = 32 kB
+#define VGA_MEMORY_CHARS 0x4000
+// Lines of the text memory used as the scroll ring, 204 lines of 80 chars
+#define VGA_TEXT_RING_LINES (VGA_MEMORY_CHARS / VGA_TEXT_WIDTH)
+// Bit of a screen line in vgaDirtyLines
+#define VGA_LINE(row) ((uint64_t) 1 << (row))
+// All the lines of the screen in vgaDirtyLines
+#define VGA_ALL_LINES (VGA_LINE(vgaHeight) - 1)
 // Make a vga color attribute byte
 #define MAKE_COLOR(bg, fg) ((bg << 4) | fg)
 // Make a vga text mode char (2 bytes), bg = backgroundColor, fg = ForegroundColor
 #define PAINT(c, bg, fg) (((MAKE_COLOR(bg, fg)) << 8) | (c & 0xFF))
-// Get current vga cursor offset position
-#define VGA_OFFSET_CURSOR_POS(currentVgaAddr) (static_cast<uint16_t>((((int) currentVgaAddr) - vgaAddress)) / 2)
 // Get the Row position from vga cursor offset position
-#define ROW_FROM_OFFSET_CURSOR_POS(offset) (offset / WIDTH)
+#define ROW_FROM_OFFSET_CURSOR_POS(offset) (offset / vgaWidth)
 // Get the Col position from vga cursor offset position
-#define COL_FROM_OFFSET_CURSOR_POS(offset) (offset % WIDTH)
+#define COL_FROM_OFFSET_CURSOR_POS(offset) (offset % vgaWidth)
 // Get the Screen Offset Pos given a col and row value
-#define GET_SCREEN_OFFSET_POS(col, row) (row * WIDTH + col)
+#define GET_SCREEN_OFFSET_POS(col, row) (row * vgaWidth + col)
+
+/** ANSI ESCAPE SEQUENCES */
+#define VGA_ESC_NONE 0                  // Printable text
+#define VGA_ESC_START 1                 // ESC received, a [ starts a CSI sequence
+#define VGA_ESC_CSI 2                   // Reading the parameters of a CSI sequence until its final byte
+#define VGA_ESC_MAX_PARAMS 8            // Parameters kept by a sequence, the next ones are ignored
+#define VGA_ESC_MAX_PARAM 9999          // Bigger parameters are clamped
+#define VGA_ESC_DEFAULT_COLOR -1        // SGR color not set, the color passed to printStr is used
+
+/**
+ * @brief Virtual console, the text written by its processes in a ring of scrollback lines
+ *
+ */
+typedef struct {
+    uint16_t lines[VGA_SCROLLBACK_LINES * VGA_MAX_WIDTH];   // Scrollback ring of vgaWidth chars lines, the screen is the last vgaHeight lines
+    uint16_t top;                       // Ring line shown on the first screen line
+    uint16_t used;                      // Lines of the ring written since install, the scrollback can't go further
+    uint16_t cursor;                    // Software cursor offset in the screen
+    uint8_t escState;                   // VGA_ESC_NONE, VGA_ESC_START or VGA_ESC_CSI, a sequence can be split between prints
+    uint8_t escParamCount;              // Parameters read by the CSI sequence
+    uint16_t escParams[VGA_ESC_MAX_PARAMS];
+    int8_t escForeColor;                // Colors set by SGR (ESC[...m) or VGA_ESC_DEFAULT_COLOR, kept until ESC[0m
+    int8_t escBgColor;
+    bool escBold;                       // SGR 1, the bright variant of the foreground color
+} VgaConsole;
+
+VgaConsole vgaConsoles[VGA_CONSOLES] __attribute__((aligned(4)));
+// VGA color of each ANSI color: black, red, green, yellow, blue, magenta, cyan, white. +8 for the bright ones
+const uint8_t vgaAnsiColors[8] = {VGA_BLACK, VGA_RED, VGA_GREEN, VGA_BROWN, VGA_BLUE, VGA_MAGENTA, VGA_CYAN, VGA_LIGHT_GREY};
+uint16_t vgaWidth;                      // Chars of a console line, 80 in text mode, the framebuffer columns with vbe.h
+uint16_t vgaHeight;                     // Lines of the screen
+uint16_t vgaRingLines;                  // Lines of the screen memory used as the scroll ring, the screen itself with the framebuffer
+bool vgaFramebuffer;                    // The active console is rendered by vbe.h instead of the text memory
+uint8_t vgaActiveConsole;               // Console rendered to the vga memory, the others are only written in RAM
+uint8_t vgaCpuConsole[SMP_MAX_CPUS];    // Console of the process running on each cpu, written by vga::printStr without console
+uint16_t vgaViewLines;                  // Lines the active console screen is scrolled back into its scrollback
+uint16_t vgaStartLine;                  // Vga memory line shown on the first screen line, the CRTC start address is only written by vga::flush
+bool vgaStartDirty;                     // vgaStartLine changed since the last flush
+bool vgaCursorDirty;                    // Cursor of the active console changed since the last flush
+volatile uint64_t vgaDirtyLines;        // Bit n set when the screen line n of the active console changed since the last flush
+Spinlock vgaLock;                       // Protects the consoles, taken with the interruptions disabled
+Tasklet vgaFlushTasklet;                // Scheduled by the timer ticks when there's something to flush
 
 // ===================== PRIVATE =======================
 
@@ -55,94 +109,535 @@ void setCursorOffsetPos(uint16_t offsetPos) {
     io::outb(0x3D5, offsetPos);
 }
 
+/**
+ * @brief Set the CRTC start address, the offset in the vga memory of the first char on the screen
+ *
+ * @param offsetPos Char offset in the vga memory
+ */
+void setStartOffsetPos(uint16_t offsetPos) {
+    io::outb(0x3D4, 0x0C);
+    io::outb(0x3D5, offsetPos >> 8);
+    io::outb(0x3D4, 0x0D);
+    io::outb(0x3D5, offsetPos);
+}
+
+/**
+ * @brief Get a screen line of a console in its scrollback ring
+ *
+ * @param console       Console
+ * @param row           Screen line, negative rows are in the scrollback above the screen
+ * @return uint16_t*    First char of the line
+ */
+uint16_t* vgaConsoleLine(VgaConsole* console, int row) {
+    return console->lines + ((console->top + VGA_SCROLLBACK_LINES + row) % VGA_SCROLLBACK_LINES) * vgaWidth;
+}
+
+/**
+ * @brief Render the dirty screen lines of the active console with vbe.h, then move the cursor and copy the changed
+ *        rectangles to the framebuffer. The screen never moves, every scroll redraws the lines. Called with vgaLock held.
+ *
+ */
+void vgaFlushFramebufferLocked() {
+    VgaConsole* console = &vgaConsoles[vgaActiveConsole];
+    uint32_t row;
+    uint32_t cursor;
+
+    for (row = 0; row < vgaHeight && vgaDirtyLines != 0; row++) {
+        if ((vgaDirtyLines & VGA_LINE(row)) != 0) {
+            vgaDirtyLines &= ~VGA_LINE(row);
+            vbe::drawLine(row, vgaConsoleLine(console, (int) row - vgaViewLines), vgaWidth);
+        }
+    }
+    if (vgaStartDirty || vgaCursorDirty) {
+        cursor = console->cursor + vgaViewLines * vgaWidth;   // Below the screen while scrolled back, vbe hides it
+        vbe::setCursor(cursor / vgaWidth, cursor % vgaWidth);
+        vgaStartDirty = false;
+        vgaCursorDirty = false;
+    }
+    vbe::flush();
+}
+
+/**
+ * @brief Copy the dirty screen lines of the active console to the vga memory, a single copy for each run of consecutive
+ *        lines that doesn't wrap around the scrollback ring. Then move the screen start if it scrolled and update the
+ *        hardware cursor if it moved. Called with vgaLock held.
+ *
+ */
+void vgaFlushLocked() {
+    VgaConsole* console = &vgaConsoles[vgaActiveConsole];
+    uint32_t first;
+    uint32_t last;
+    uint32_t count;
+    uint32_t ringLine;
+    uint32_t start = vgaStartLine * vgaWidth;
+
+    if (vgaFramebuffer) {
+        vgaFlushFramebufferLocked();
+        return;
+    }
+
+    for (first = 0; vgaDirtyLines != 0; first = last) {
+        while ((vgaDirtyLines & VGA_LINE(first)) == 0) {
+            first++;
+        }
+        for (last = first; last < vgaHeight && (vgaDirtyLines & VGA_LINE(last)) != 0; last++) {
+            vgaDirtyLines &= ~VGA_LINE(last);
+        }
+        for (; first < last; first += count) {
+            ringLine = (console->top + VGA_SCROLLBACK_LINES - vgaViewLines + first) % VGA_SCROLLBACK_LINES;
+            count = VGA_SCROLLBACK_LINES - ringLine;
+            if (count > last - first) {
+                count = last - first;
+            }
+            memutils::memcpy((uint16_t*) vgaAddress + start + first * vgaWidth, console->lines + ringLine * vgaWidth, count * vgaWidth * 2);
+        }
+    }
+
+    // The lines are written before the screen moves to them
+    if (vgaStartDirty) {
+        setStartOffsetPos(start);
+        vgaStartDirty = false;
+        vgaCursorDirty = true;          // The cursor registers are an offset in the vga memory too
+    }
+    if (vgaCursorDirty) {
+        setCursorOffsetPos(start + console->cursor + vgaViewLines * vgaWidth);    // Below the screen while scrolled back
+        vgaCursorDirty = false;
+    }
+}
+
+/**
+ * @brief Mark the whole screen of the active console to be written by the next flush. Called with vgaLock held.
+ *
+ */
+void vgaRedrawLocked() {
+    vgaDirtyLines = VGA_ALL_LINES;
+    vgaCursorDirty = true;
+}
+
+/**
+ * @brief Change the size of the lines and of the screen of a console. The lines are moved to the new line stride
+ *        in the ring, the screen keeps its last lines and the cursor its position. Called with vgaLock held.
+ *
+ * @param console   Console
+ * @param width     New chars per line, up to VGA_MAX_WIDTH
+ * @param height    New screen lines, up to VGA_MAX_HEIGHT
+ */
+void vgaResizeConsoleLocked(VgaConsole* console, uint16_t width, uint16_t height) {
+    uint16_t blank = PAINT(0x20, VGA_DEF_BGCOLOR, VGA_DEF_FORECOLOR);
+    uint16_t row = ROW_FROM_OFFSET_CURSOR_POS(console->cursor);
+    uint16_t col = COL_FROM_OFFSET_CURSOR_POS(console->cursor);
+    uint16_t copied = width < vgaWidth ? width : vgaWidth;
+    int line;
+    int i;
+
+    // Longer lines are moved from the ring end, shorter ones from the ring start, so no line is overwritten before it's moved
+    if (width > vgaWidth) {
+        for (line = VGA_SCROLLBACK_LINES - 1; line >= 0; line--) {
+            for (i = copied - 1; i >= 0; i--) {
+                console->lines[line * width + i] = console->lines[line * vgaWidth + i];
+            }
+            memutils::memset_16(console->lines + line * width + copied, blank, width - copied);
+        }
+    } else if (width < vgaWidth) {
+        for (line = 0; line < VGA_SCROLLBACK_LINES; line++) {
+            memutils::memcpy(console->lines + line * width, console->lines + line * vgaWidth, copied * 2);
+        }
+    }
+    if (col >= width) {
+        col = width - 1;
+    }
+
+    if (height > vgaHeight) {
+        // The lines below the screen are the oldest of the ring, they become blank screen lines
+        for (line = vgaHeight; line < height; line++) {
+            memutils::memset_16(console->lines + ((console->top + line) % VGA_SCROLLBACK_LINES) * width, blank, width);
+        }
+        console->used = console->used + height - vgaHeight < VGA_SCROLLBACK_LINES ? console->used + height - vgaHeight : VGA_SCROLLBACK_LINES;
+    } else if (height < vgaHeight) {
+        // The first lines of the screen go to the scrollback
+        console->top = (console->top + vgaHeight - height) % VGA_SCROLLBACK_LINES;
+        row = row >= vgaHeight - height ? row - (vgaHeight - height) : 0;
+    }
+    console->cursor = row * width + col;
+}
+
+/**
+ * @brief Get the colors of the text printed in a console, the SGR colors of its escape sequences when they're set
+ *
+ * @param console   Console
+ * @param foreColor Text color passed to printStr
+ * @param bgColor   Background color passed to printStr
+ * @param fore      Text color to paint
+ * @param bg        Background color to paint
+ */
+void vgaEscapeColors(VgaConsole* console, int foreColor, int bgColor, int* fore, int* bg) {
+    *fore = console->escForeColor != VGA_ESC_DEFAULT_COLOR ? console->escForeColor : foreColor;
+    *bg = console->escBgColor != VGA_ESC_DEFAULT_COLOR ? console->escBgColor : bgColor;
+    if (console->escBold) {
+        *fore |= 0x8;
+    }
+}
+
+/**
+ * @brief Write blank chars in a range of the screen of a console. Called with vgaLock held.
+ *
+ * @param console       Console
+ * @param from          First screen offset
+ * @param to            Screen offset after the last one
+ * @param blank         Blank vga char, in the background color
+ * @param dirtyLines    Dirty lines of printStr, the lines written are added
+ */
+void vgaEraseLocked(VgaConsole* console, uint32_t from, uint32_t to, uint16_t blank, uint64_t* dirtyLines) {
+    uint32_t end;
+
+    for (; from < to; from = end) {
+        end = (ROW_FROM_OFFSET_CURSOR_POS(from) + 1) * vgaWidth;
+        if (end > to) {
+            end = to;
+        }
+        memutils::memset_16(vgaConsoleLine(console, ROW_FROM_OFFSET_CURSOR_POS(from)) + COL_FROM_OFFSET_CURSOR_POS(from), blank, end - from);
+        *dirtyLines |= VGA_LINE(ROW_FROM_OFFSET_CURSOR_POS(from));
+    }
+}
+
+/**
+ * @brief Apply the SGR parameters of an ESC[...m sequence to the colors of a console
+ *
+ * @param console   Console
+ */
+void vgaEscapeGraphics(VgaConsole* console) {
+    uint16_t param;
+    int i;
+
+    if (console->escParamCount == 0) {  // ESC[m = ESC[0m
+        console->escParams[0] = 0;
+        console->escParamCount = 1;
+    }
+    for (i = 0; i < console->escParamCount; i++) {
+        param = console->escParams[i];
+        if (param == 0) {
+            console->escForeColor = VGA_ESC_DEFAULT_COLOR;
+            console->escBgColor = VGA_ESC_DEFAULT_COLOR;
+            console->escBold = false;
+        } else if (param == 1) {
+            console->escBold = true;
+        } else if (param == 22) {
+            console->escBold = false;
+        } else if (param >= 30 && param <= 37) {
+            console->escForeColor = vgaAnsiColors[param - 30];
+        } else if (param == 39) {
+            console->escForeColor = VGA_ESC_DEFAULT_COLOR;
+        } else if (param >= 40 && param <= 47) {
+            console->escBgColor = vgaAnsiColors[param - 40];
+        } else if (param == 49) {
+            console->escBgColor = VGA_ESC_DEFAULT_COLOR;
+        } else if (param >= 90 && param <= 97) {
+            console->escForeColor = vgaAnsiColors[param - 90] | 0x8;
+        } else if (param >= 100 && param <= 107) {
+            console->escBgColor = vgaAnsiColors[param - 100] | 0x8;
+        }
+    }
+}
+
+/**
+ * @brief Run a CSI sequence once its final byte is read: cursor moves, erases and colors. The unsupported sequences
+ *        are ignored. Called with vgaLock held.
+ *
+ *    - ESC[nA ESC[nB ESC[nC ESC[nD: cursor n lines up, down, columns right, left. n = 1 when it's not set
+ *    - ESC[row;colH, ESC[row;colf: cursor position, from 1;1 at the top left corner
+ *    - ESC[nJ: erase from the cursor to the end of the screen (0), from the start to the cursor (1), the screen (2, 3)
+ *    - ESC[nK: erase from the cursor to the end of the line (0), from the line start to the cursor (1), the line (2)
+ *    - ESC[...m: SGR colors, see vgaEscapeGraphics
+ *
+ * @param console       Console
+ * @param final         Final byte
+ * @param pos           Cursor offset of printStr, moved by the sequence
+ * @param dirtyLines    Dirty lines of printStr
+ * @param blank         Blank vga char of the erases, in the background color
+ */
+void vgaEscapeLocked(VgaConsole* console, char final, uint16_t* pos, uint64_t* dirtyLines, uint16_t blank) {
+    uint32_t row = ROW_FROM_OFFSET_CURSOR_POS(*pos);
+    uint32_t col = COL_FROM_OFFSET_CURSOR_POS(*pos);
+    uint32_t n = console->escParamCount > 0 && console->escParams[0] > 0 ? console->escParams[0] : 1;
+    uint32_t mode = console->escParamCount > 0 ? console->escParams[0] : 0;
+
+    switch (final) {
+        case 'A':
+            row = row > n ? row - n : 0;
+            break;
+        case 'B':
+            row = row + n < vgaHeight ? row + n : vgaHeight - 1;
+            break;
+        case 'C':
+            col = col + n < vgaWidth ? col + n : vgaWidth - 1;
+            break;
+        case 'D':
+            col = col > n ? col - n : 0;
+            break;
+        case 'H':
+        case 'f':
+            row = n <= vgaHeight ? n - 1 : vgaHeight - 1;
+            n = console->escParamCount > 1 && console->escParams[1] > 0 ? console->escParams[1] : 1;
+            col = n <= vgaWidth ? n - 1 : vgaWidth - 1;
+            break;
+        case 'J':
+            if (mode == 0) {
+                vgaEraseLocked(console, *pos, SCREEN_MAX_OFFSET_POS, blank, dirtyLines);
+            } else if (mode == 1) {
+                vgaEraseLocked(console, 0, *pos + 1, blank, dirtyLines);
+            } else {
+                vgaEraseLocked(console, 0, SCREEN_MAX_OFFSET_POS, blank, dirtyLines);
+            }
+            return;
+        case 'K':
+            if (mode == 0) {
+                vgaEraseLocked(console, *pos, (row + 1) * vgaWidth, blank, dirtyLines);
+            } else if (mode == 1) {
+                vgaEraseLocked(console, row * vgaWidth, *pos + 1, blank, dirtyLines);
+            } else {
+                vgaEraseLocked(console, row * vgaWidth, (row + 1) * vgaWidth, blank, dirtyLines);
+            }
+            return;
+        case 'm':
+            vgaEscapeGraphics(console);
+            return;
+        default:
+            return;
+    }
+    *pos = GET_SCREEN_OFFSET_POS(col, row);
+}
+
+/**
+ * @brief Read a char of an escape sequence. Called by printStr with vgaLock held, while a sequence is open or on ESC.
+ *
+ * @param console       Console
+ * @param c             Char
+ * @param pos           Cursor offset of printStr
+ * @param dirtyLines    Dirty lines of printStr
+ * @param blank         Blank vga char of the erases, in the background color
+ * @return true         The char was part of a sequence
+ * @return false        ESC followed by something else than [, the char is printed
+ */
+bool vgaEscapeCharLocked(VgaConsole* console, char c, uint16_t* pos, uint64_t* dirtyLines, uint16_t blank) {
+    uint16_t* param;
+
+    if (c == '\033') {                  // A new sequence, the open one is dropped
+        console->escState = VGA_ESC_START;
+        return true;
+    }
+    if (console->escState == VGA_ESC_START) {
+        console->escState = c == '[' ? VGA_ESC_CSI : VGA_ESC_NONE;
+        console->escParamCount = 0;
+        console->escParams[0] = 0;
+        return c == '[';
+    }
+
+    if (c >= '0' && c <= '9') {
+        if (console->escParamCount == 0) {
+            console->escParamCount = 1;
+        }
+        param = &console->escParams[console->escParamCount - 1];
+        *param = *param * 10 + (c - '0');
+        if (*param > VGA_ESC_MAX_PARAM) {
+            *param = VGA_ESC_MAX_PARAM;
+        }
+    } else if (c == ';') {
+        if (console->escParamCount == 0) {  // Empty first parameter
+            console->escParamCount = 1;
+        }
+        if (console->escParamCount < VGA_ESC_MAX_PARAMS) {
+            console->escParams[console->escParamCount++] = 0;
+        }
+    } else if (c >= 0x40 && c <= 0x7E) {    // Final byte
+        console->escState = VGA_ESC_NONE;
+        vgaEscapeLocked(console, c, pos, dirtyLines, blank);
+    }                                       // Private markers and intermediate bytes, E.g ESC[?25l, are skipped
+    return true;
+}
+
+/**
+ * @brief Flush tasklet, runs after the timer tick with the interruptions enabled
+ *
+ * @param data Unused
+ */
+void vgaFlushTaskletFunc(void*) {
+    vga::flush();
+}
+
 // ====================== PUBLIC =======================
 
+void vga::install() {
+    VgaConsole* console;
+    int i;
+    int row;
+
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    // The first console starts with the text written by the boot loader, so nothing is lost on the first flush.
+    // The BIOS shows the screen at the start of the vga memory, the ring starts there
+    vgaWidth = VGA_TEXT_WIDTH;
+    vgaHeight = VGA_TEXT_HEIGHT;
+    vgaRingLines = VGA_TEXT_RING_LINES;
+    vgaFramebuffer = false;
+    for (i = 0; i < VGA_CONSOLES; i++) {
+        console = &vgaConsoles[i];
+        console->top = 0;
+        console->used = vgaHeight;
+        console->cursor = 0;
+        console->escState = VGA_ESC_NONE;
+        console->escParamCount = 0;
+        console->escForeColor = VGA_ESC_DEFAULT_COLOR;
+        console->escBgColor = VGA_ESC_DEFAULT_COLOR;
+        console->escBold = false;
+        for (row = 0; row < vgaHeight; row++) {
+            memutils::memset_16(vgaConsoleLine(console, row), PAINT(0x20, VGA_DEF_BGCOLOR, VGA_DEF_FORECOLOR), vgaWidth);
+        }
+    }
+    console = &vgaConsoles[VGA_KERNEL_CONSOLE];
+    console->cursor = getCursorOffsetPos();
+    if (console->cursor >= SCREEN_MAX_OFFSET_POS) {
+        console->cursor = 0;
+    }
+    memutils::memcpy(console->lines, (uint16_t*) vgaAddress, SCREEN_MAX_OFFSET_POS * 2);
+
+    for (i = 0; i < SMP_MAX_CPUS; i++) {
+        vgaCpuConsole[i] = VGA_KERNEL_CONSOLE;
+    }
+    vgaActiveConsole = VGA_KERNEL_CONSOLE;
+    vgaViewLines = 0;
+    vgaStartLine = 0;
+    vgaStartDirty = true;
+    vgaCursorDirty = false;
+    vgaDirtyLines = 0;
+    spinlock::init(&vgaLock, "vga");
+    softirq::initTasklet(&vgaFlushTasklet, vgaFlushTaskletFunc, NULL);
+}
+
 void vga::printStr(const char* str) {
     vga::printStr(VGA_DEF_FORECOLOR, VGA_DEF_BGCOLOR, str);
 }
 
 void vga::printStr(int foreColor, int bgColor, const char* str) {
+    vga::printStr(vgaCpuConsole[smp::getCpuIndex()], foreColor, bgColor, str);
+}
+
+void vga::printStr(uint8_t consoleIndex, int foreColor, int bgColor, const char* str) {
+    vga::write(consoleIndex, foreColor, bgColor, str, string::strlen(str));
+}
+
+void vga::write(uint8_t consoleIndex, int foreColor, int bgColor, const char* str, uint32_t length) {
+    VgaConsole* console = &vgaConsoles[consoleIndex];
+    const char* text = str;
+    const char* end = str + length;
     int i;
+    uint32_t flags;
+    uint16_t pos;
+    uint16_t startPos;
+    bool visible;
+    uint64_t dirtyLines = 0;
+    int fore;
+    int bg;
 
-    // Get current vga cursor offset position
-    uint16_t cursorOffset = getCursorOffsetPos();
+    flags = spinlock::acquireIrqSave(&vgaLock);
 
-    // Video memory base offset
-    volatile uint16_t* video = (volatile uint16_t*) vgaAddress + cursorOffset;
+    // Only the active console is rendered, the others are written in RAM at full speed
+    visible = consoleIndex == vgaActiveConsole;
+    if (visible && vgaViewLines != 0) {     // New output brings the scrolled back screen to the last lines
+        vgaViewLines = 0;
+        vgaRedrawLocked();
+    }
+
+    // Software cursor, no CRTC port I/O
+    pos = console->cursor;
+    startPos = pos;
+    vgaEscapeColors(console, foreColor, bgColor, &fore, &bg);
 
-    // Offset video memory to start at current cursor position
-    //  - Since it is a short 16 bits variable should be sum in increments of 2 bytes positions
-    while (*str != 0) {
+    while (str < end) {
+        if ((console->escState != VGA_ESC_NONE || *str == '\033') &&
+            vgaEscapeCharLocked(console, *str, &pos, &dirtyLines, PAINT(' ', bg, fore))) {
+            // Escape sequence - Discard its chars, a complete one moved the cursor, erased or changed the colors
+            str++;
+            if (console->escState == VGA_ESC_NONE) {
+                vgaEscapeColors(console, foreColor, bgColor, &fore, &bg);
+                if (pos < startPos) {
+                    startPos = pos;
+                }
+            }
+            continue;
+        }
         if (*str == '\n') {
             // Line break - Discard \n char
             str++;
-            // Increment video buffer to go to next line
+            // Increment the offset to go to next line
             // E.g.:
-            // WIDTH = 80;
-            // VGA_OFFSET_CURSOR_POS = 30;
-            // OFFSET_INCREMENT = 30 = VGA_OFFSET_CURSOR_POS % 80;
-            // VIDEO_BUFFER_INCREMENT = 50 = WIDTH - OFFSET_INCREMENT;
-            //  - Increment video address by 50 to advance to the next line
-            // E.g. 2:
-            // WIDTH = 80;
-            // VGA_OFFSET_CURSOR_POS = 90;
-            // OFFSET_INCREMENT = 10 = VGA_OFFSET_CURSOR_POS % 80;
-            // VIDEO_BUFFER_INCREMENT = 70 = WIDTH - OFFSET_INCREMENT;
-            //  - Increment video address by 70 to advance to the next line
-            video += WIDTH - (VGA_OFFSET_CURSOR_POS((int) video) % WIDTH);
+            // vgaWidth = 80;
+            // pos = 30;
+            // OFFSET_INCREMENT = 30 = pos % 80;
+            // POS_INCREMENT = 50 = vgaWidth - OFFSET_INCREMENT;
+            //  - Increment pos by 50 to advance to the next line
+            pos += vgaWidth - (pos % vgaWidth);
         } else if (*str == '\b') {
             // Back space - Discard \b char backspace
             str++;
-            if (((int) video) > vgaAddress + cursorOffset) {
-                // Get back to previous char writes a blank char on it then set offset to previous char position.
-                video -= 1;
-                *video++ = PAINT(' ', bgColor, foreColor);
-                video -= 1;
+            if (pos > startPos) {
+                // Get back to previous char writes a blank char on it.
+                pos--;
+                vgaConsoleLine(console, ROW_FROM_OFFSET_CURSOR_POS(pos))[COL_FROM_OFFSET_CURSOR_POS(pos)] = PAINT(' ', bg, fore);
+                dirtyLines |= VGA_LINE(ROW_FROM_OFFSET_CURSOR_POS(pos));
             }
         } else if (*str == '\t') {
             // Tab - Discard \t char tab
             str++;
-            for(i=0; i<4 && ((int) video) < SCREEN_MAX_OFFSET_POS; i++) { // Adds 4 space chars if less than max screen content
-                *video++ = PAINT(' ', bgColor, foreColor);
+            for(i=0; i<4 && pos < SCREEN_MAX_OFFSET_POS; i++) { // Adds 4 space chars if less than max screen content
+                dirtyLines |= VGA_LINE(ROW_FROM_OFFSET_CURSOR_POS(pos));
+                vgaConsoleLine(console, ROW_FROM_OFFSET_CURSOR_POS(pos))[COL_FROM_OFFSET_CURSOR_POS(pos)] = PAINT(' ', bg, fore);
+                pos++;
             }
         } else {
-            *video++ = PAINT(*str++, bgColor, foreColor);
+            dirtyLines |= VGA_LINE(ROW_FROM_OFFSET_CURSOR_POS(pos));
+            vgaConsoleLine(console, ROW_FROM_OFFSET_CURSOR_POS(pos))[COL_FROM_OFFSET_CURSOR_POS(pos)] = PAINT(*str++, bg, fore);
+            pos++;
         }
 
-        // Check if video max address reached and scroll content up
-        if (((int) video) >= SCREEN_MAX_OFFSET_POS) {
-            void* startAddress = (void*) ((uint16_t*) vgaAddress + WIDTH);           // startAddress = The start ptr address of the second vga text buffer line
-            uint32_t sizeToCopy = (HEIGHT - 1) * WIDTH * 2;              // sizeToCopy = Size of the buffer of all lines from second line until last line
-            memutils::memcpy((uint16_t*) vgaAddress, startAddress, sizeToCopy);      // copy the lines up by one line
+        // Check if the end of the screen is reached and scroll content up. The screen starts one line lower in the
+        // scrollback ring, the line that leaves the screen is kept in the scrollback
+        if (pos >= SCREEN_MAX_OFFSET_POS) {
+            console->top = (console->top + 1) % VGA_SCROLLBACK_LINES;
+            if (console->used < VGA_SCROLLBACK_LINES) {
+                console->used++;
+            }
+            memutils::memset_16(vgaConsoleLine(console, vgaHeight - 1), PAINT(0x20, bg, fore), vgaWidth);  // blank the last line
 
-            // While current video ptr address is greather than start ptr address of the last line
-            // decrement blanking all chars of the last line and position cursor at the end char of the
-            // penultimate line, so we need to increment video ptr address to move cursor to the last line.
-            // this operation is needed because the first char of the last line was not blanked
-            while(((int) video) >= (vgaAddress + (WIDTH * (HEIGHT - 1) * 2))) {
-                *video-- = PAINT(0x20, bgColor, foreColor);
+            // Visible console: the screen starts one line lower in the vga memory, the next flush writes the new last
+            // line and the CRTC start address. The whole screen is copied only when the vga memory ring wraps
+            if (visible) {
+                if (vgaStartLine + vgaHeight < vgaRingLines) {
+                    vgaStartLine++;
+                    vgaDirtyLines >>= 1;                                    // the screen lines move up by one line
+                    dirtyLines >>= 1;
+                } else {
+                    vgaStartLine = 0;
+                    dirtyLines = VGA_ALL_LINES;
+                }
+                vgaStartDirty = true;
             }
-            video++;
+            dirtyLines |= VGA_LINE(vgaHeight - 1);
+            pos -= vgaWidth;                                                // same column, last line
+            startPos = startPos >= vgaWidth ? startPos - vgaWidth : 0;
         }
     }
 
-    // // USED FOR DEBUG
-    // char strCurOffset[33] = {0};
-    // stdlib::itoa(SCREEN_MAX_OFFSET_POS, 10, strCurOffset);
-    // const char* mStrCurOffset = strCurOffset;
-
-    // while (*mStrCurOffset != 0) {
-    //     if (*mStrCurOffset == '\n') {
-    //         // Line break
-    //         *mStrCurOffset++;
-    //         //video += 1;
-    //     } else {
-    //         *video++ = PAINT(*mStrCurOffset++, bgColor, foreColor);
-    //     }
-    // }
-
     // Update cursor offset position
-    setCursorOffsetPos(VGA_OFFSET_CURSOR_POS((int) video));
+    if (pos != console->cursor) {
+        console->cursor = pos;
+        vgaCursorDirty = vgaCursorDirty || visible;
+    }
+    if (visible) {
+        vgaDirtyLines |= dirtyLines;
+    }
+    spinlock::releaseIrqRestore(&vgaLock, flags);
+    if (consoleIndex == VGA_KERNEL_CONSOLE) {   // The kernel console is mirrored on the serial port
+        serial::write(text, length);
+    }
 }
 
 void vga::clearScreen() {
@@ -150,24 +645,140 @@ void vga::clearScreen() {
 }
 
 void vga::clearScreen(int foreColor, int bgColor, bool setCursor) {
-    // Write 0x20 = ' ' blank char in entire vga buffer
+    uint8_t consoleIndex = vgaCpuConsole[smp::getCpuIndex()];
+    VgaConsole* console = &vgaConsoles[consoleIndex];
+    uint32_t flags;
+    int row;
+
+    // Write 0x20 = ' ' blank char in the entire screen of the console, the scrollback is kept
+    flags = spinlock::acquireIrqSave(&vgaLock);
+    for (row = 0; row < vgaHeight; row++) {
+        memutils::memset_16(vgaConsoleLine(console, row), PAINT(0x20, bgColor, foreColor), vgaWidth);
+    }
     if (setCursor) {
-        vga::setCursorPosition(0, 0);
+        console->cursor = 0;
+    }
+    if (consoleIndex == vgaActiveConsole) {
+        vgaViewLines = 0;
+        vgaRedrawLocked();
     }
-    memutils::memset_16((uint16_t*) vgaAddress, PAINT(0x20, bgColor, foreColor), WIDTH * HEIGHT);
+    spinlock::releaseIrqRestore(&vgaLock, flags);
 }
 
 void vga::getCursorPosition(int* row, int* col) {
-    uint16_t offset = getCursorOffsetPos();
+    uint16_t offset = vgaConsoles[vgaCpuConsole[smp::getCpuIndex()]].cursor;
     *row = ROW_FROM_OFFSET_CURSOR_POS(offset);
     *col = COL_FROM_OFFSET_CURSOR_POS(offset);
 }
 
 void vga::setCursorPosition(int col, int row) {
     unsigned offset_pos = GET_SCREEN_OFFSET_POS(col, row);
-    setCursorOffsetPos(offset_pos);
+    uint8_t consoleIndex = vgaCpuConsole[smp::getCpuIndex()];
+    uint32_t flags;
+
+    flags = spinlock::acquireIrqSave(&vgaLock);
+    vgaConsoles[consoleIndex].cursor = offset_pos;
+    if (consoleIndex == vgaActiveConsole) {
+        vgaCursorDirty = true;
+    }
+    spinlock::releaseIrqRestore(&vgaLock, flags);
+}
+
+void vga::setFramebuffer(uint16_t cols, uint16_t rows) {
+    uint32_t flags;
+    int i;
+
+    if (cols > VGA_MAX_WIDTH) {
+        cols = VGA_MAX_WIDTH;
+    }
+    if (rows > VGA_MAX_HEIGHT) {
+        rows = VGA_MAX_HEIGHT;
+    }
+
+    flags = spinlock::acquireIrqSave(&vgaLock);
+    for (i = 0; i < VGA_CONSOLES; i++) {
+        vgaResizeConsoleLocked(&vgaConsoles[i], cols, rows);
+    }
+    vgaWidth = cols;
+    vgaHeight = rows;
+    vgaRingLines = rows;                // Each scroll redraws the screen, vbe only renders the cells that changed
+    vgaStartLine = 0;
+    vgaViewLines = 0;
+    vgaFramebuffer = true;
+    vgaRedrawLocked();
+    vgaFlushLocked();
+    spinlock::releaseIrqRestore(&vgaLock, flags);
 }
 
 void vga::setVgaAddress(int newVgaAddress) {
+    uint32_t flags;
+
+    flags = spinlock::acquireIrqSave(&vgaLock);
     vgaAddress = newVgaAddress;
-}
\ No newline at end of file
+    vgaDirtyLines = VGA_ALL_LINES;      // Same physical memory, but every line is written again through the new address
+    spinlock::releaseIrqRestore(&vgaLock, flags);
+}
+
+void vga::setOutputConsole(uint8_t console) {
+    vgaCpuConsole[smp::getCpuIndex()] = console;
+}
+
+uint8_t vga::getOutputConsole() {
+    return vgaCpuConsole[smp::getCpuIndex()];
+}
+
+void vga::setActiveConsole(uint8_t console) {
+    uint32_t flags;
+
+    if (console >= VGA_CONSOLES) {
+        return;
+    }
+    flags = spinlock::acquireIrqSave(&vgaLock);
+    if (console != vgaActiveConsole) {
+        vgaActiveConsole = console;
+        vgaViewLines = 0;
+        vgaStartLine = 0;               // The screen of the new console is written at the vga memory start
+        vgaStartDirty = true;
+        vgaRedrawLocked();
+    }
+    spinlock::releaseIrqRestore(&vgaLock, flags);
+}
+
+uint8_t vga::getActiveConsole() {
+    return vgaActiveConsole;
+}
+
+void vga::scrollView(int lines) {
+    VgaConsole* console;
+    uint32_t flags;
+    int view;
+
+    flags = spinlock::acquireIrqSave(&vgaLock);
+    console = &vgaConsoles[vgaActiveConsole];
+    view = vgaViewLines + lines;
+    if (view > console->used - vgaHeight) {
+        view = console->used - vgaHeight;
+    }
+    if (view < 0) {
+        view = 0;
+    }
+    if (view != vgaViewLines) {
+        vgaViewLines = view;
+        vgaRedrawLocked();
+    }
+    spinlock::releaseIrqRestore(&vgaLock, flags);
+}
+
+void vga::flush() {
+    uint32_t flags;
+
+    flags = spinlock::acquireIrqSave(&vgaLock);
+    vgaFlushLocked();
+    spinlock::releaseIrqRestore(&vgaLock, flags);
+}
+
+void vga::scheduleFlush() {
+    if (vgaDirtyLines != 0 || vgaStartDirty || vgaCursorDirty) {
+        softirq::schedule(&vgaFlushTasklet);
+    }
+}
@@ -2,6 +2,7 @@
 #ifndef _VGA_H_
 #define _VGA_H_
 
+#include <stdint.h>
 #include <stdbool.h>
 
 /* VGA (FOREGROUND | BACKGROUND) COLORS */
@@ -26,6 +27,13 @@
 #define VGA_DEF_FORECOLOR VGA_WHITE
 #define VGA_DEF_BGCOLOR VGA_BLACK
 
+/** VIRTUAL CONSOLES */
+#define VGA_CONSOLES 4                  // Switched with Alt+F1..F4
+#define VGA_KERNEL_CONSOLE 0            // Console of the boot messages, the kernel threads and the first shell
+#define VGA_SCROLLBACK_LINES 200        // Lines kept in the RAM ring of each console, the screen included
+#define VGA_MAX_WIDTH 128               // Chars of a console line with the framebuffer, 80 in text mode
+#define VGA_MAX_HEIGHT 48               // Lines of a console screen with the framebuffer, 25 in text mode. Up to 64, one dirty bit per line
+
 /**
  * @brief LEGACY VGA (Text Mode) 80x86 
  * 
@@ -65,11 +73,56 @@
  * - ESCAPESEQ:
  *   - \b - Backspace;
  *   - \t - Tabulation;
+ *   - ESC[ (\033[) - ANSI CSI sequences, parsed by printStr in the same pass as the text. A program redraws a whole
+ *     screen with a single print: ESC[2J ESC[H to clear it, then its lines at their ESC[row;colH positions.
+ *       - ESC[nA, ESC[nB, ESC[nC, ESC[nD - Cursor up, down, right, left;
+ *       - ESC[row;colH, ESC[row;colf - Cursor position, 1;1 is the top left corner;
+ *       - ESC[nJ - Erase the screen: 0 after the cursor, 1 before it, 2 all;
+ *       - ESC[nK - Erase the line: 0 after the cursor, 1 before it, 2 all;
+ *       - ESC[...m - Colors: 0 reset, 1 bright, 30-37 and 90-97 text, 40-47 and 100-107 background, 39 and 49 default;
+ *   - The sequence state and the colors belong to the console, a sequence can be split between two prints and the
+ *     colors stay until ESC[0m. The other sequences are read and ignored.
  * 
  * - MORE:
  *   - To know more about vga access folder docs and search for soft_vga.pdf file
+ * - SHADOW_BUFFER:
+ *   - printStr writes in a RAM copy of the screen (the console ring) and moves a software cursor, the vga memory is slow MMIO and each
+ *     CRTC cursor access is two port I/Os.
+ *   - The changed lines are marked dirty. vga::flush copies each run of dirty lines with a single memcpy and writes the
+ *     cursor registers only if it moved.
+ *   - The timer ticks schedule a flush tasklet when something changed, so the screen is updated at most once per tick.
+ *     The idle loop and the fatal errors flush on demand before halting the cpu.
+ *
+ * - HARDWARE_SCROLL:
+ *   - The whole 32 kB of text memory is a ring of 204 lines, the screen shows 25 consecutive lines starting at the CRTC
+ *     start address (registers 0x0C and 0x0D).
+ *   - Scrolling moves the start address one line down and blanks the new last line. The flush writes that line and the
+ *     start address, the other lines are already in the vga memory.
+ *   - When the screen reaches the end of the ring, it's written again at the ring start, the only bulk copy.
+ *   - The CRTC cursor is an offset in the vga memory, the flush adds the start address to the screen cursor.
+ *
+ * - VIRTUAL_CONSOLES:
+ *   - VGA_CONSOLES consoles, each one with its own cursor and a RAM ring of VGA_SCROLLBACK_LINES lines. The screen of
+ *     a console is its last 25 lines (48 with the framebuffer), the lines scrolled off stay in the ring until it wraps.
+ *   - Only the active console is rendered to the vga memory. The others are written in RAM only, so a background
+ *     process logs without paying for the vga writes. Switching console redraws the whole screen.
+ *   - A process writes to its own console (PCB console), inherited from its parent. The scheduler sets the console
+ *     of each cpu when it switches process, the kernel messages go to the console of the running process.
+ *   - Alt+F1..F4 switch the active console, Shift+PageUp/PageDown scroll its screen back into the scrollback.
+ *     New output on the active console brings its screen back to the last lines.
+ *
+ * - FRAMEBUFFER:
+ *   - vga::setFramebuffer is called by vbe::install once the graphics mode is set. The consoles become a larger grid
+ *     of cells (128x48 at 1024x768), the lines already written are kept.
+ *   - The flush passes the dirty lines to vbe.h instead of the text memory, there's no CRTC start address: a scroll
+ *     marks every line dirty and vbe only renders the cells that changed.
  */
 namespace vga {
+    /**
+     * @brief Initialize the consoles, the first one with the current screen and cursor. Must be called before any print.
+     */
+    void install();
+
     /**
      * @brief Print text in vga using default foreColor and bgColor
      * 
@@ -78,7 +131,7 @@ namespace vga {
     void printStr(const char *str);
 
     /**
-     * @brief Print text in vga
+     * @brief Print text in vga, on the console of the process running on this cpu
      * 
      * @param foreColor Text color E.g VGA_WHITE
      * @param bgColor Text background color E.g VGA_BLACK
@@ -86,6 +139,27 @@ namespace vga {
      */
     void printStr(int foreColor, int bgColor, const char *str);
 
+    /**
+     * @brief Print text in a console
+     *
+     * @param console Console index, 0 to VGA_CONSOLES - 1
+     * @param foreColor Text color E.g VGA_WHITE
+     * @param bgColor Text background color E.g VGA_BLACK
+     * @param str Text to be printed
+     */
+    void printStr(uint8_t console, int foreColor, int bgColor, const char *str);
+
+    /**
+     * @brief Print a text of a given length in a console, its null chars are printed too
+     *
+     * @param console Console index, 0 to VGA_CONSOLES - 1
+     * @param foreColor Text color E.g VGA_WHITE
+     * @param bgColor Text background color E.g VGA_BLACK
+     * @param str Text to be printed
+     * @param length Chars of the text
+     */
+    void write(uint8_t console, int foreColor, int bgColor, const char *str, uint32_t length);
+
     /**
      * @brief Clear the vga text using default foreColor and bgColor and set cursor
      * 
@@ -125,5 +199,60 @@ namespace vga {
      * @param vgaAddress 
      */
     void setVgaAddress(int newVgaAddress);
+
+    /**
+     * @brief Render the consoles with vbe.h in a grid of cols x rows chars, instead of the text memory.
+     *        Called by vbe::install after the graphics mode is set, the whole screen is drawn again.
+     *
+     * @param cols Chars per line, up to VGA_MAX_WIDTH
+     * @param rows Screen lines, up to VGA_MAX_HEIGHT
+     */
+    void setFramebuffer(uint16_t cols, uint16_t rows);
+
+    /**
+     * @brief Set the console written by printStr and clearScreen on this cpu. Called by the scheduler on each
+     *        process switch.
+     *
+     * @param console Console index, 0 to VGA_CONSOLES - 1
+     */
+    void setOutputConsole(uint8_t console);
+
+    /**
+     * @brief Get the console written by printStr and clearScreen on this cpu
+     *
+     * @return uint8_t Console index
+     */
+    uint8_t getOutputConsole();
+
+    /**
+     * @brief Show a console on the screen, its screen is written by the next flush
+     *
+     * @param console Console index, ignored when it's VGA_CONSOLES or more
+     */
+    void setActiveConsole(uint8_t console);
+
+    /**
+     * @brief Get the console shown on the screen
+     *
+     * @return uint8_t Console index
+     */
+    uint8_t getActiveConsole();
+
+    /**
+     * @brief Scroll the screen of the active console into its scrollback, limited to the lines kept in the ring
+     *
+     * @param lines Lines to go back, negative to go forward to the last lines
+     */
+    void scrollView(int lines);
+
+    /**
+     * @brief Copy the dirty lines of the shadow buffer to the vga memory and update the hardware cursor
+     */
+    void flush();
+
+    /**
+     * @brief Schedule a flush tasklet if the shadow buffer changed since the last flush. Called by the timer ticks.
+     */
+    void scheduleFlush();
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,401 @@
+// libc
+#include <stdint.h>
+// stdlibs
+#include "stdlib.h"
+// cpu
+#include "paging.h"
+// memory
+#include "heap.h"
+#include "memutils.h"
+// sys
+#include "io.h"
+// drivers
+#include "vga.h"
+#include "vbe.h"
+
+#define VBE_DISPI_INDEX 0x1CE
+#define VBE_DISPI_DATA 0x1CF
+#define VBE_DISPI_INDEX_ID 0
+#define VBE_DISPI_INDEX_XRES 1
+#define VBE_DISPI_INDEX_YRES 2
+#define VBE_DISPI_INDEX_BPP 3
+#define VBE_DISPI_INDEX_ENABLE 4
+#define VBE_DISPI_ID_MASK 0xFFF0        // Versions 0xB0C0 to 0xB0C5
+#define VBE_DISPI_ID 0xB0C0
+#define VBE_DISPI_DISABLED 0x00
+#define VBE_DISPI_ENABLED 0x01
+#define VBE_DISPI_LFB_ENABLED 0x40
+
+#define PCI_CONFIG_ADDRESS 0xCF8
+#define PCI_CONFIG_DATA 0xCFC
+#define PCI_CONFIG_ENABLE 0x80000000
+#define PCI_DEVICES 32                  // Devices of a bus, only bus 0 function 0 is scanned
+#define PCI_REG_ID 0x00                 // Device id in the high word, vendor id in the low word
+#define PCI_REG_BAR0 0x10
+#define PCI_BAR_MEMORY_MASK 0xFFFFFFF0
+#define PCI_ID_BOCHS_VGA 0x11111234     // Vendor 1234, device 1111: Bochs and qemu std VGA
+
+#define VGA_SEQ_INDEX 0x3C4
+#define VGA_SEQ_DATA 0x3C5
+#define VGA_GC_INDEX 0x3CE
+#define VGA_GC_DATA 0x3CF
+#define SEQ_MAP_MASK 0x02
+#define SEQ_MEMORY_MODE 0x04
+#define GC_READ_MAP 0x04
+#define GC_MODE 0x05
+#define GC_MISC 0x06
+#define SEQ_MAP_MASK_PLANE2 0x04        // Write plane 2 only
+#define SEQ_MEMORY_MODE_PLANAR 0x06     // Extended memory, odd/even addressing disabled
+#define GC_READ_MAP_PLANE2 0x02         // Read plane 2, the font plane
+#define GC_MODE_READ0 0x00              // Read mode 0, odd/even disabled
+#define GC_MISC_A0000 0x04              // Memory mapped at 0xA0000 - 0xAFFFF, alphanumeric mode
+
+#define VGA_FONT_ADDRESS 0xA0000
+#define VGA_FONT_GLYPH_STRIDE 32        // Bytes of a glyph in plane 2, only the first VBE_GLYPH_HEIGHT are used
+#define VBE_GLYPHS 256
+#define VBE_GLYPH_PIXELS (VBE_GLYPH_WIDTH * VBE_GLYPH_HEIGHT)
+#define VBE_GLYPH_CACHE_ATTR_STRIDE 97  // Spreads the colors of a char over the cache entries
+#define VBE_GLYPH_CACHE_EMPTY 0xFFFFFFFF
+#define VBE_CURSOR_FIRST_LINE 14        // The underline covers the last 2 pixel lines of the cell
+
+uint16_t vbeCols;
+uint16_t vbeRows;
+uint32_t* vbeFramebuffer;               // Linear framebuffer, virtual address = physical address
+uint32_t* vbeBackBuffer;                // RAM copy of the screen, the glyphs are drawn here
+uint32_t* vbeGlyphCache;                // VBE_GLYPH_CACHE_ENTRIES rendered glyphs of VBE_GLYPH_PIXELS pixels
+uint32_t vbeGlyphTags[VBE_GLYPH_CACHE_ENTRIES];     // Cell rendered in each cache entry
+uint16_t* vbeCells;                     // Cell drawn at each position of the back buffer
+uint8_t vbeFont[VBE_GLYPHS * VBE_GLYPH_HEIGHT];
+uint32_t vbeRowMasks[VBE_GLYPHS][VBE_GLYPH_WIDTH];  // 0xFFFFFFFF for the foreground pixels of each font row byte
+uint16_t vbeDirtyFirst[VGA_MAX_HEIGHT]; // Dirty rectangle of each text line, columns first to last - 1
+uint16_t vbeDirtyLast[VGA_MAX_HEIGHT];
+uint16_t vbeCursorRow;
+uint16_t vbeCursorCol;
+bool vbeEnabled;
+
+// 0x00RRGGBB values of the 16 colors of the text mode
+const uint32_t vbePalette[16] = {
+    0x000000, 0x0000AA, 0x00AA00, 0x00AAAA, 0xAA0000, 0xAA00AA, 0xAA5500, 0xAAAAAA,
+    0x555555, 0x5555FF, 0x55FF55, 0x55FFFF, 0xFF5555, 0xFF55FF, 0xFFFF55, 0xFFFFFF
+};
+
+// ===================== PRIVATE =======================
+
+/**
+ * @brief Read a dispi register
+ *
+ * @param index         Register index
+ * @return uint16_t     Value
+ */
+uint16_t vbeRead(uint16_t index) {
+    io::outw(VBE_DISPI_INDEX, index);
+    return io::inw(VBE_DISPI_DATA);
+}
+
+/**
+ * @brief Write a dispi register
+ *
+ * @param index Register index
+ * @param value Value
+ */
+void vbeWrite(uint16_t index, uint16_t value) {
+    io::outw(VBE_DISPI_INDEX, index);
+    io::outw(VBE_DISPI_DATA, value);
+}
+
+/**
+ * @brief Find the framebuffer address in the BAR0 of the display PCI device
+ *
+ * @return uint32_t Physical address, 0 when there's no Bochs display device
+ */
+uint32_t vbeFindFramebuffer() {
+    uint32_t device;
+
+    for (device = 0; device < PCI_DEVICES; device++) {
+        io::outl(PCI_CONFIG_ADDRESS, PCI_CONFIG_ENABLE | (device << 11) | PCI_REG_ID);
+        if (io::inl(PCI_CONFIG_DATA) == PCI_ID_BOCHS_VGA) {
+            io::outl(PCI_CONFIG_ADDRESS, PCI_CONFIG_ENABLE | (device << 11) | PCI_REG_BAR0);
+            return io::inl(PCI_CONFIG_DATA) & PCI_BAR_MEMORY_MASK;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Copy the font of the text mode from the VGA plane 2. The sequencer and graphics controller registers are
+ *        switched to planar access while it's read, then restored.
+ *
+ */
+void vbeReadFont() {
+    uint8_t* plane = (uint8_t*) VGA_FONT_ADDRESS;
+    uint8_t mapMask, memoryMode, readMap, mode, misc;
+    uint32_t glyph;
+
+    paging::mapMmio(VGA_FONT_ADDRESS);
+    paging::mapMmio(VGA_FONT_ADDRESS + FRAME_SIZE);     // 256 glyphs * 32 bytes = 2 pages
+
+    io::outb(VGA_SEQ_INDEX, SEQ_MAP_MASK);
+    mapMask = io::inb(VGA_SEQ_DATA);
+    io::outb(VGA_SEQ_INDEX, SEQ_MEMORY_MODE);
+    memoryMode = io::inb(VGA_SEQ_DATA);
+    io::outb(VGA_GC_INDEX, GC_READ_MAP);
+    readMap = io::inb(VGA_GC_DATA);
+    io::outb(VGA_GC_INDEX, GC_MODE);
+    mode = io::inb(VGA_GC_DATA);
+    io::outb(VGA_GC_INDEX, GC_MISC);
+    misc = io::inb(VGA_GC_DATA);
+
+    io::outb(VGA_SEQ_INDEX, SEQ_MAP_MASK);
+    io::outb(VGA_SEQ_DATA, SEQ_MAP_MASK_PLANE2);
+    io::outb(VGA_SEQ_INDEX, SEQ_MEMORY_MODE);
+    io::outb(VGA_SEQ_DATA, SEQ_MEMORY_MODE_PLANAR);
+    io::outb(VGA_GC_INDEX, GC_READ_MAP);
+    io::outb(VGA_GC_DATA, GC_READ_MAP_PLANE2);
+    io::outb(VGA_GC_INDEX, GC_MODE);
+    io::outb(VGA_GC_DATA, GC_MODE_READ0);
+    io::outb(VGA_GC_INDEX, GC_MISC);
+    io::outb(VGA_GC_DATA, GC_MISC_A0000);
+
+    for (glyph = 0; glyph < VBE_GLYPHS; glyph++) {
+        memutils::memcpy(&vbeFont[glyph * VBE_GLYPH_HEIGHT], plane + glyph * VGA_FONT_GLYPH_STRIDE, VBE_GLYPH_HEIGHT);
+    }
+
+    io::outb(VGA_SEQ_INDEX, SEQ_MAP_MASK);
+    io::outb(VGA_SEQ_DATA, mapMask);
+    io::outb(VGA_SEQ_INDEX, SEQ_MEMORY_MODE);
+    io::outb(VGA_SEQ_DATA, memoryMode);
+    io::outb(VGA_GC_INDEX, GC_READ_MAP);
+    io::outb(VGA_GC_DATA, readMap);
+    io::outb(VGA_GC_INDEX, GC_MODE);
+    io::outb(VGA_GC_DATA, mode);
+    io::outb(VGA_GC_INDEX, GC_MISC);
+    io::outb(VGA_GC_DATA, misc);
+}
+
+/**
+ * @brief Get the rendered glyph of a cell, rendering it in its cache entry on a miss
+ *
+ * @param cell          Vga cell, char and color attribute
+ * @return uint32_t*    VBE_GLYPH_PIXELS pixels, row by row
+ */
+uint32_t* vbeGlyph(uint16_t cell) {
+    uint32_t entry = ((cell & 0xFF) + (cell >> 8) * VBE_GLYPH_CACHE_ATTR_STRIDE) % VBE_GLYPH_CACHE_ENTRIES;
+    uint32_t* pixels = vbeGlyphCache + entry * VBE_GLYPH_PIXELS;
+    uint32_t* masks;
+    uint32_t fore;
+    uint32_t back;
+    uint32_t y;
+    uint32_t x;
+
+    if (vbeGlyphTags[entry] == cell) {
+        return pixels;
+    }
+
+    fore = vbePalette[(cell >> 8) & 0x0F];
+    back = vbePalette[(cell >> 12) & 0x0F];
+    for (y = 0; y < VBE_GLYPH_HEIGHT; y++) {
+        masks = vbeRowMasks[vbeFont[(cell & 0xFF) * VBE_GLYPH_HEIGHT + y]];
+        for (x = 0; x < VBE_GLYPH_WIDTH; x++) {
+            pixels[y * VBE_GLYPH_WIDTH + x] = (masks[x] & fore) | (~masks[x] & back);
+        }
+    }
+    vbeGlyphTags[entry] = cell;
+    return pixels;
+}
+
+/**
+ * @brief Draw the cell of a position in the back buffer, with the cursor underline when it's there. Grows the dirty
+ *        rectangle of the line.
+ *
+ * @param row Text line
+ * @param col Column
+ */
+void vbeDrawCell(uint16_t row, uint16_t col) {
+    uint16_t cell = vbeCells[row * vbeCols + col];
+    uint32_t* src = vbeGlyph(cell);
+    uint32_t* dst = vbeBackBuffer + row * VBE_GLYPH_HEIGHT * VBE_WIDTH + col * VBE_GLYPH_WIDTH;
+    uint32_t fore;
+    uint32_t y;
+    uint32_t x;
+
+    for (y = 0; y < VBE_GLYPH_HEIGHT; y++) {    // One 32-bit store per pixel, a glyph row is 8 stores
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+        dst[3] = src[3];
+        dst[4] = src[4];
+        dst[5] = src[5];
+        dst[6] = src[6];
+        dst[7] = src[7];
+        dst += VBE_WIDTH;
+        src += VBE_GLYPH_WIDTH;
+    }
+
+    if (row == vbeCursorRow && col == vbeCursorCol) {
+        fore = vbePalette[(cell >> 8) & 0x0F];
+        dst = vbeBackBuffer + (row * VBE_GLYPH_HEIGHT + VBE_CURSOR_FIRST_LINE) * VBE_WIDTH + col * VBE_GLYPH_WIDTH;
+        for (y = VBE_CURSOR_FIRST_LINE; y < VBE_GLYPH_HEIGHT; y++) {
+            for (x = 0; x < VBE_GLYPH_WIDTH; x++) {
+                dst[x] = fore;
+            }
+            dst += VBE_WIDTH;
+        }
+    }
+
+    if (col < vbeDirtyFirst[row]) {
+        vbeDirtyFirst[row] = col;
+    }
+    if (col + 1 > vbeDirtyLast[row]) {
+        vbeDirtyLast[row] = col + 1;
+    }
+}
+
+/**
+ * @brief Release the heap buffers when the mode can't be used. heap::kfree ignores the NULL ones.
+ *
+ */
+void vbeFreeBuffers() {
+    heap::kfree(vbeBackBuffer);
+    heap::kfree(vbeGlyphCache);
+    heap::kfree(vbeCells);
+}
+
+// ====================== PUBLIC =======================
+
+uint8_t vbe::install() {
+    uint32_t framebuffer;
+    uint32_t size = VBE_WIDTH * VBE_HEIGHT * (VBE_BPP / 8);
+    uint32_t i;
+    uint32_t x;
+
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    vbeEnabled = false;
+    vbeCols = VBE_WIDTH / VBE_GLYPH_WIDTH;
+    vbeRows = VBE_HEIGHT / VBE_GLYPH_HEIGHT;
+    if (vbeCols > VGA_MAX_WIDTH) {
+        vbeCols = VGA_MAX_WIDTH;
+    }
+    if (vbeRows > VGA_MAX_HEIGHT) {
+        vbeRows = VGA_MAX_HEIGHT;
+    }
+
+    if ((vbeRead(VBE_DISPI_INDEX_ID) & VBE_DISPI_ID_MASK) != VBE_DISPI_ID) {
+        return VBE_ERROR_NOT_PRESENT;
+    }
+    framebuffer = vbeFindFramebuffer();
+    if (framebuffer == 0) {
+        return VBE_ERROR_NO_FRAMEBUFFER;
+    }
+
+    vbeBackBuffer = (uint32_t*) heap::kmalloc(size);
+    vbeGlyphCache = (uint32_t*) heap::kmalloc(VBE_GLYPH_CACHE_ENTRIES * VBE_GLYPH_PIXELS * sizeof(uint32_t));
+    vbeCells = (uint16_t*) heap::kmalloc(vbeCols * vbeRows * sizeof(uint16_t));
+    if (vbeBackBuffer == NULL || vbeGlyphCache == NULL || vbeCells == NULL) {
+        vbeFreeBuffers();
+        return VBE_ERROR_NO_MEMORY;
+    }
+
+    // The font is read while the text mode is still set
+    vbeReadFont();
+    for (i = 0; i < VBE_GLYPHS; i++) {
+        for (x = 0; x < VBE_GLYPH_WIDTH; x++) {
+            vbeRowMasks[i][x] = (i & (0x80 >> x)) != 0 ? 0xFFFFFFFF : 0;    // Bit 7 is the leftmost pixel
+        }
+    }
+    for (i = 0; i < VBE_GLYPH_CACHE_ENTRIES; i++) {
+        vbeGlyphTags[i] = VBE_GLYPH_CACHE_EMPTY;
+    }
+
+    // A black screen: cell 0 is black on black, every cell that differs is drawn by the first flush
+    memutils::memset(vbeBackBuffer, 0, size);
+    memutils::memset(vbeCells, 0, vbeCols * vbeRows * sizeof(uint16_t));
+    for (i = 0; i < vbeRows; i++) {
+        vbeDirtyFirst[i] = vbeCols;
+        vbeDirtyLast[i] = 0;
+    }
+    vbeCursorRow = vbeRows;                     // Hidden
+    vbeCursorCol = 0;
+
+    vbeWrite(VBE_DISPI_INDEX_ENABLE, VBE_DISPI_DISABLED);
+    vbeWrite(VBE_DISPI_INDEX_XRES, VBE_WIDTH);
+    vbeWrite(VBE_DISPI_INDEX_YRES, VBE_HEIGHT);
+    vbeWrite(VBE_DISPI_INDEX_BPP, VBE_BPP);
+    vbeWrite(VBE_DISPI_INDEX_ENABLE, VBE_DISPI_ENABLED | VBE_DISPI_LFB_ENABLED);   // Clears the framebuffer
+    if (vbeRead(VBE_DISPI_INDEX_XRES) != VBE_WIDTH || vbeRead(VBE_DISPI_INDEX_YRES) != VBE_HEIGHT) {
+        vbeWrite(VBE_DISPI_INDEX_ENABLE, VBE_DISPI_DISABLED);  // Back to the text mode
+        vbeFreeBuffers();
+        return VBE_ERROR_MODE;
+    }
+
+    paging::mapFramebuffer(framebuffer, size);
+    vbeFramebuffer = (uint32_t*) framebuffer;
+    vbeEnabled = true;
+
+    vga::setFramebuffer(vbeCols, vbeRows);      // The consoles are rendered here from now on
+    return VBE_NO_ERROR;
+}
+
+bool vbe::isEnabled() {
+    return vbeEnabled;
+}
+
+void vbe::getTextSize(uint16_t* cols, uint16_t* rows) {
+    *cols = vbeCols;
+    *rows = vbeRows;
+}
+
+void vbe::drawLine(uint16_t row, const uint16_t* cells, uint16_t count) {
+    uint16_t* drawn = vbeCells + row * vbeCols;
+    uint16_t col;
+
+    if (row >= vbeRows) {
+        return;
+    }
+    if (count > vbeCols) {
+        count = vbeCols;
+    }
+    for (col = 0; col < count; col++) {
+        if (cells[col] != drawn[col]) {         // Unchanged cells are already in the back buffer
+            drawn[col] = cells[col];
+            vbeDrawCell(row, col);
+        }
+    }
+}
+
+void vbe::setCursor(uint16_t row, uint16_t col) {
+    uint16_t oldRow = vbeCursorRow;
+    uint16_t oldCol = vbeCursorCol;
+
+    if (row == oldRow && col == oldCol) {
+        return;
+    }
+    vbeCursorRow = row;
+    vbeCursorCol = col;
+    if (oldRow < vbeRows && oldCol < vbeCols) {
+        vbeDrawCell(oldRow, oldCol);            // Without the underline
+    }
+    if (row < vbeRows && col < vbeCols) {
+        vbeDrawCell(row, col);
+    }
+}
+
+void vbe::flush() {
+    uint32_t row;
+    uint32_t y;
+    uint32_t offset;
+    uint32_t bytes;
+
+    for (row = 0; row < vbeRows; row++) {
+        if (vbeDirtyFirst[row] >= vbeDirtyLast[row]) {
+            continue;
+        }
+        offset = row * VBE_GLYPH_HEIGHT * VBE_WIDTH + vbeDirtyFirst[row] * VBE_GLYPH_WIDTH;
+        bytes = (vbeDirtyLast[row] - vbeDirtyFirst[row]) * VBE_GLYPH_WIDTH * sizeof(uint32_t);
+        for (y = 0; y < VBE_GLYPH_HEIGHT; y++) {
+            memutils::memcpy(vbeFramebuffer + offset, vbeBackBuffer + offset, bytes);
+            offset += VBE_WIDTH;
+        }
+        vbeDirtyFirst[row] = vbeCols;
+        vbeDirtyLast[row] = 0;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#ifndef _VBE_H_
+#define _VBE_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+
+#define VBE_NO_ERROR 0
+#define VBE_ERROR_NOT_PRESENT 1         // No Bochs dispi interface, E.g qemu without -vga std
+#define VBE_ERROR_NO_FRAMEBUFFER 2      // The display PCI device wasn't found, its BAR0 is the framebuffer address
+#define VBE_ERROR_MODE 3                // The resolution was refused
+#define VBE_ERROR_NO_MEMORY 4           // The back buffer doesn't fit in the kernel heap
+
+#define VBE_WIDTH 1024                  // Resolution set by vbe::install
+#define VBE_HEIGHT 768
+#define VBE_BPP 32                      // One uint32_t 0x00RRGGBB per pixel
+#define VBE_GLYPH_WIDTH 8               // Glyphs of the VGA ROM font, 128x48 chars at 1024x768
+#define VBE_GLYPH_HEIGHT 16
+#define VBE_GLYPH_CACHE_ENTRIES 1024    // Rendered glyphs kept by the cache, 512 bytes each
+
+/**
+ * @brief VBE - Linear framebuffer graphics console with the Bochs VBE (dispi) interface of qemu -vga std
+ *
+ * REGISTERS:
+ *    - Index port 0x1CE selects a register, data port 0x1CF reads or writes it: ID, XRES, YRES, BPP, ENABLE, ...
+ *    - With ENABLE = ENABLED | LFB_ENABLED the screen is a linear framebuffer, VBE_WIDTH * VBE_HEIGHT pixels in
+ *      row order. Its physical address is the BAR0 of the display PCI device (1234:1111).
+ *
+ * FONT:
+ *    - The 8x16 glyphs are copied from the VGA plane 2 before the mode is set, so the text looks like the text mode.
+ *    - Each font row byte has a precomputed row of 8 pixel masks. A glyph is rendered once per char and color in the
+ *      glyph cache (direct mapped, indexed by the vga cell), then drawn with 32-bit row blits: 8 stores per row.
+ *    - The kernel doesn't use SSE: the FPU/SSE registers belong to the process running (fpu.h lazy switch).
+ *
+ * RENDERING:
+ *    - vga.h keeps the consoles as cells (char and color attribute), a 128x48 grid once vga::setFramebuffer is called.
+ *    - vga::flush passes the dirty lines to vbe::drawLine. Only the cells that changed since the last draw are
+ *      rendered in a RAM back buffer, and the changed columns of each line grow its dirty rectangle.
+ *    - vbe::flush copies the dirty rectangles to the framebuffer, the slow device memory is only written, never read.
+ *    - The cursor is an underline in the foreground color, drawn over its cell.
+ */
+namespace vbe {
+    /**
+     * @brief Set the VBE_WIDTH x VBE_HEIGHT x VBE_BPP mode, map the framebuffer and render the consoles in it.
+     *        Requires the kernel heap, must be called before the application processors are started.
+     *
+     * @return uint8_t Error code: VBE_NO_ERROR, VBE_ERROR_NOT_PRESENT, VBE_ERROR_NO_FRAMEBUFFER, VBE_ERROR_MODE or
+     *         VBE_ERROR_NO_MEMORY. The text mode is kept on error
+     */
+    uint8_t install();
+
+    /**
+     * @brief Return whether the consoles are rendered in the framebuffer or not
+     *
+     * @return true  Graphics mode
+     * @return false VGA text mode
+     */
+    bool isEnabled();
+
+    /**
+     * @brief Get the size of the text grid
+     *
+     * @param cols Chars per line
+     * @param rows Lines
+     */
+    void getTextSize(uint16_t* cols, uint16_t* rows);
+
+    /**
+     * @brief Render the cells of a text line that changed since the last draw in the back buffer. Called by vga::flush.
+     *
+     * @param row   Text line
+     * @param cells Vga cells, char in the low byte and color attribute in the high byte
+     * @param count Cells of the line
+     */
+    void drawLine(uint16_t row, const uint16_t* cells, uint16_t count);
+
+    /**
+     * @brief Move the cursor underline. Called by vga::flush.
+     *
+     * @param row Text line, the cursor is hidden when it's out of the screen
+     * @param col Column
+     */
+    void setCursor(uint16_t row, uint16_t col);
+
+    /**
+     * @brief Copy the dirty rectangles of the back buffer to the framebuffer. Called by vga::flush.
+     *
+     */
+    void flush();
+}
+
+#endif
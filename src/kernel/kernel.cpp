@@ -2,7 +2,11 @@
 // legacy drivers
 #include "vga.h"
 #include "ps2.h"
+#include "serial.h"
 #include "pit.h"
+// drivers
+#include "hpet.h"
+#include "vbe.h"
 // stdlibs
 #include "stdio.h"
 // cpu
@@ -11,11 +15,21 @@
 #include "paging.h"
 #include "apic.h"
 #include "cpuid.h"
+#include "fpu.h"
+#include "smp.h"
 // memory
 #include "heap.h"
 // sys
 #include "io.h"
 #include "fs.h"
+#include "timer.h"
+#include "clock.h"
+#include "acpi.h"
+#include "syscalls.h"
+#include "lockstat.h"
+#include "softirq.h"
+#include "workqueue.h"
+#include "klog.h"
 // scheduler
 #include "scheduler.h"
 #include "kernel.h"
@@ -27,37 +41,77 @@ extern "C" void gen_interrupt(int index);
 void handleError(uint8_t errorCode, const char* errorPrefix) {
     if (errorCode > 0) {
         // Some error happend
-        stdio::kprintf("%s - ERROR: %d\n", errorPrefix, errorCode);
+        KPRINTF("%s - ERROR: %d\n", errorPrefix, errorCode);
+        vga::flush();
+        serial::flush();
         __asm__ volatile ("cli; hlt");  // Halt the cpu. Waits until an IRQ occurs
     }
 }
 
 extern "C" int kmain() {
     uint8_t errorCode;
+    uint8_t console;
 
     const char* OK_MSG = "OK";
     const char* ERR_MSG = "Failed with error code";
     const char* PS2_INSTALL_MSG = "PS/2 Controller - Install:";
 
+    // Lock statistics list, before any lock is initialized
+    lockstat::install();
+
+    // Screen shadow buffer and virtual consoles, before any print
+    vga::install();
+
+    // Bootstrap processor data and kernel lock, before any interruption is enabled
+    smp::init();
+
+    // Tasklets and work list, before the interruption handlers can schedule them
+    softirq::install();
+    workqueue::install();
+
+    // Kernel log ring, before any print
+    klog::install();
+
     // Clear VGA screen
     vga::clearScreen();
 
     // Kernel entry point in memory
-    // stdio::kprintf("KERNEL_ENTRY: %x\n", (int) _start);
+    // KPRINTF("KERNEL_ENTRY: %x\n", (int) _start);
 
     // Install a new GDT table
     gdt::install();
-    stdio::kprintf("GDT             - Install: %s\n", OK_MSG);
+    KPRINTF("GDT             - Install: %s\n", OK_MSG);
 
     // Install ISR and IDT tables
     // Remap the PIC offsets into the IDT table 32 and 40 and setup the IRQs
     isr::install();
-    stdio::kprintf("IDT, ISR, IRQ   - Install: %s\n", OK_MSG);
+    KPRINTF("IDT, ISR, IRQ   - Install: %s\n", OK_MSG);
 
-    // Install APIC
-    // errorCode = apic::install();
-    // handleError(errorCode, "APIC");
-    // vga::printStr("APIC        - Install: OK\n");
+    // Install SERIAL - COM1 mirrors the kernel console, the messages printed before aren't sent
+    errorCode = serial::install();
+    if (errorCode == SERIAL_NO_ERROR) {
+        KPRINTF("SERIAL          - Install: %s (COM1 %d bauds)\n", OK_MSG, SERIAL_BAUD_RATE);
+    } else {
+        KPRINTF("SERIAL          - Not present (%d)\n", errorCode);
+    }
+
+    // Install SYSENTER - Fast system calls, int 0x30 is used when not supported
+    errorCode = syscalls::install();
+    if (errorCode == SYSCALLS_NO_ERROR) {
+        KPRINTF("SYSENTER        - Install: %s\n", OK_MSG);
+    } else {
+        KPRINTF("SYSENTER        - Not supported, using int 0x30\n");
+    }
+
+    // Install FPU - Floating point and SSE registers switched lazily with CR0.TS
+    errorCode = fpu::install();
+    if (errorCode == FPU_NO_ERROR) {
+        KPRINTF("FPU, SSE        - Install: %s\n", OK_MSG);
+    } else if (errorCode == FPU_ERROR_SSE_NOT_PRESENT) {
+        KPRINTF("FPU             - Install: %s, SSE not supported\n", OK_MSG);
+    } else {
+        KPRINTF("FPU             - Not present\n");
+    }
 
     // Install HEAP - Kernel Heap
     // kheap::install();
@@ -65,37 +119,102 @@ extern "C" int kmain() {
 
     // Install FS - File System
     fs::install();
-    stdio::kprintf("FS File System  - Install: %s\n", OK_MSG);
+    KPRINTF("FS File System  - Install: %s\n", OK_MSG);
+
+    // Install ACPI - Firmware tables are read at their physical address, before paging is enabled
+    errorCode = acpi::install();
+    if (errorCode == ACPI_NO_ERROR) {
+        KPRINTF("ACPI Tables     - Install: %s (%d cpus, %d io apics, hpet: %s)\n", OK_MSG, acpi::getCpuCount(), acpi::getIoApicCount(), acpi::hasHpet() ? "yes" : "no");
+    } else {
+        KPRINTF("ACPI Tables     - Not found (%d), using the PC defaults\n", errorCode);
+    }
 
     // Install MMU - Paging tables
     paging::install();
-    stdio::kprintf("MMU Paging      - Install: %s\n", OK_MSG);
+    KPRINTF("MMU Paging      - Install: %s\n", OK_MSG);
     // paging::test();
 
+    // Install TIMER - Kernel timer wheel driven by the PIT interruption
+    timer::install();
+    KPRINTF("TIMER Wheel     - Install: %s\n", OK_MSG);
+
     // Install PIT - Programmable Interval Timer
     pit::install();
-    stdio::kprintf("PIT Timer       - Install: %s\n", OK_MSG);
+    KPRINTF("PIT Timer       - Install: %s\n", OK_MSG);
+
+    // Install CLOCK - TSC calibrated against the PIT
+    errorCode = clock::install();
+    if (errorCode == CLOCK_NO_ERROR) {
+        KPRINTF("CLOCK TSC       - Install: %s (%d khz)\n", OK_MSG, clock::getTscKhz());
+    } else {
+        KPRINTF("CLOCK           - TSC not supported, using timer ticks\n");
+    }
+
+    // Install APIC - Local APIC and I/O APIC replace the 8259 PIC. Requires paging to map its registers
+    errorCode = apic::install();
+    if (errorCode == APIC_NO_ERROR) {
+        KPRINTF("APIC, IO APIC   - Install: %s (%d hz tick)\n", OK_MSG, APIC_TIMER_HZ);
+    } else {
+        KPRINTF("APIC            - Not available (%d), using 8259 PIC\n", errorCode);
+    }
+
+    // Install HPET - One-shot event of the idle cpu. Requires the I/O APIC
+    errorCode = hpet::install();
+    if (errorCode == HPET_NO_ERROR) {
+        KPRINTF("HPET            - Install: %s (%d hz)\n", OK_MSG, hpet::getFrequency());
+    } else {
+        KPRINTF("HPET            - Not available (%d), using PIT one-shot\n", errorCode);
+    }
 
     // Install PS/2 - Controller
     errorCode = ps2::install();
     if (errorCode == PS2_NO_ERROR) {
-        stdio::kprintf("%s %s\n", PS2_INSTALL_MSG, OK_MSG);
+        KPRINTF("%s %s\n", PS2_INSTALL_MSG, OK_MSG);
     } else {
-        stdio::kprintf("%s %s %d\n", PS2_INSTALL_MSG, ERR_MSG, errorCode);
+        KPRINTF("%s %s %d\n", PS2_INSTALL_MSG, ERR_MSG, errorCode);
     }
     
     // Install HEAP
     heap::initKheap();
     vga::printStr("KERNEL HEAP     - Install: OK\n");
 
+    // Install VBE - Graphics console in the linear framebuffer. Requires the kernel heap, before the application processors
+    errorCode = vbe::install();
+    if (errorCode == VBE_NO_ERROR) {
+        KPRINTF("VBE Framebuffer - Install: %s (%dx%dx%d)\n", OK_MSG, VBE_WIDTH, VBE_HEIGHT, VBE_BPP);
+    } else {
+        KPRINTF("VBE             - Not available (%d), using VGA text mode\n", errorCode);
+    }
+
     scheduler::init();
     PID pidShell = scheduler::createProcess("shell.exe");
     scheduler::resumeProcess(pidShell);
-    scheduler::start();
 
-    // scheduler::processLoadContext(pidShell);
+    // One more shell on each virtual console, switched with Alt+F1..F4
+    for (console = VGA_KERNEL_CONSOLE + 1; console < VGA_CONSOLES; console++) {
+        pidShell = scheduler::createProcess("shell.exe");
+        if (pidShell == NULL) {
+            break;
+        }
+        pidShell->console = console;
+        scheduler::resumeProcess(pidShell);
+    }
+
+    // Install SMP - Start the application processors. Requires the APIC, the kernel heap and the scheduler
+    errorCode = smp::install();
+    if (errorCode == SMP_NO_ERROR) {
+        KPRINTF("SMP             - Install: %s (%d cpus)\n", OK_MSG, smp::getCpuCount());
+    } else {
+        KPRINTF("SMP             - Not available (%d), using 1 cpu\n", errorCode);
+    }
+
+    // Start the worker threads, one per online cpu
+    workqueue::startWorkers();
+    KPRINTF("WORKQUEUE       - Install: %s (%d workers)\n", OK_MSG, smp::getCpuCount());
+
+    scheduler::start();
 
-    // stdio::kprintf("pidShell 0x%x\n", (int) pidShell);
+    // KPRINTF("pidShell 0x%x\n", (int) pidShell);
 
     // Test interruption
     // sysfuncs::printStr("testando123456\n");
@@ -103,7 +222,7 @@ extern "C" int kmain() {
     // cpuid::printCpuInfo();
 
 
-    // stdio::kprintf("cpuid - eax: %x - ebx: %x - ecx: %x - edx: %x\n", eax, ebx, ecx, edx);
+    // KPRINTF("cpuid - eax: %x - ebx: %x - ecx: %x - edx: %x\n", eax, ebx, ecx, edx);
 
     // Throw an exception to test IDT ISR
     // __asm__ ("mov %eax, %0" :: "r"(1));
@@ -3,12 +3,15 @@
 // cpu
 #include "paging.h"
 #include "heap.h"
+// sys
+#include "spinlock.h"
 
 /**
  * @brief Reference to the kernel heap
  * Since the kernel has only one heap we can declare the kernel heap as static
  */
 Heap kernelHeap;
+Spinlock kernelHeapLock;    // The kernel heap is shared by all cpus
 
 void heap::init(Heap* heap, unsigned int baseAddress, unsigned int sizeInFrames) {
     heap->baseAddress = baseAddress;
@@ -91,12 +94,18 @@ void heap::free(Heap* heap, void* addr) {
 void heap::initKheap() {
     // Initialize kernelHeap since it is located in .bss unitialized data section.
     init(&kernelHeap, KERNEL_HEAP_START_ADDR, KERNEL_HEAP_SIZE);
+    spinlock::init(&kernelHeapLock, "kheap");
 }
 
 void* heap::kmalloc(unsigned int size) {
-    return malloc(&kernelHeap, size);
+    uint32_t flags = spinlock::acquireIrqSave(&kernelHeapLock);
+    void* addr = malloc(&kernelHeap, size);
+    spinlock::releaseIrqRestore(&kernelHeapLock, flags);
+    return addr;
 }
 
 void heap::kfree(void* addr) {
+    uint32_t flags = spinlock::acquireIrqSave(&kernelHeapLock);
     free(&kernelHeap, addr);
+    spinlock::releaseIrqRestore(&kernelHeapLock, flags);
 }
\ No newline at end of file
@@ -101,6 +101,7 @@ namespace heap {
 
     /**
      * @brief Allocate a new data in kernel heap space instance
+     *        The kernel heap is protected by a spinlock, it can be called on any cpu and by the interruption handlers.
      *
      * @param size      Size being allocated.
      * @return void*    The pointer reference of the allocated data. or NULL=No free HeapElement found.
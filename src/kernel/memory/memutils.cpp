@@ -145,15 +145,15 @@ void memutils::memHexDump(const char *desc, const void *addr, const int len, int
 
     // Output description if given.
     if (desc != NULL)
-        stdio::kprintf("%s:\n", desc);
+        KPRINTF("%s:\n", desc);
 
     // Length checks.
     if (len == 0) {
-        stdio::kprintf("  ZERO LENGTH\n");
+        KPRINTF("  ZERO LENGTH\n");
         return;
     }
     if (len < 0) {
-        stdio::kprintf("  NEGATIVE LENGTH: %d\n", len);
+        KPRINTF("  NEGATIVE LENGTH: %d\n", len);
         return;
     }
 
@@ -164,15 +164,15 @@ void memutils::memHexDump(const char *desc, const void *addr, const int len, int
         if ((i % perLine) == 0) {
             // Only print previous-line ASCII buffer for lines beyond first.
             if (i != 0) {
-                stdio::kprintf("  %s\n", buff);
+                KPRINTF("  %s\n", buff);
             }
 
             // Output the offset of current line.
-            stdio::kprintf("  %04x ", i & 0xFFFF);
+            KPRINTF("  %04x ", i & 0xFFFF);
         }
 
         // Now the hex code for the specific character.
-        stdio::kprintf(" %02x", pc[i] & 0xFF);
+        KPRINTF(" %02x", pc[i] & 0xFF);
 
         // And buffer a printable ASCII character for later.
         if ((pc[i] < 0x20) || (pc[i] > 0x7e)) { // isprint() may be better.
@@ -185,12 +185,12 @@ void memutils::memHexDump(const char *desc, const void *addr, const int len, int
 
     // Pad out last line if not exactly perLine characters.
     while ((i % perLine) != 0) {
-        stdio::kprintf("   ");
+        KPRINTF("   ");
         i++;
     }
 
     // And print the final ASCII buffer.
 
-    stdio::kprintf("  %s\n", buff);
+    KPRINTF("  %s\n", buff);
 }
 #endif
\ No newline at end of file
@@ -71,7 +71,7 @@ void stack::print(Stack *s) {
 
     temp = s->head;
     while (temp != NULL) {
-        stdio::kprintf("%d = 0x%x\n", temp->data, temp->data);
+        KPRINTF("%u = 0x%x\n", (uint32_t) temp->data, temp->data);
         temp = temp->next;
     }
 }
\ No newline at end of file
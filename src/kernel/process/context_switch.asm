@@ -0,0 +1,46 @@
+; ============================================
+; Process kernel context switch.
+; ============================================
+
+[bits 32]
+[section .text]
+
+[global switch_to]          ; Export switch_to to be used in scheduler.cpp file
+[global process_start]      ; Export process_start to be used in scheduler.cpp file
+[extern scheduler_process_entry]    ; Reference scheduler_process_entry exported function from scheduler.cpp file
+
+; =============================
+; void switch_to(unsigned int* prevESP, unsigned int nextESP)
+;
+; Save the callee-saved registers of the current kernel context on its own stack, store the stack pointer in prevESP,
+; then load nextESP and restore the registers saved there. The caller saved registers (eax, ecx, edx) and the
+; segment registers are already preserved by the C calling convention and the flat segments, so they are not saved.
+; Returns in the next context, at the point where it called switch_to or at process_start for a new process.
+; =============================
+switch_to:
+    mov eax, [esp+4]        ; prevESP
+    mov edx, [esp+8]        ; nextESP
+
+    push ebp                ; SwitchFrame - same order as scheduler.h
+    push ebx
+    push esi
+    push edi
+
+    mov [eax], esp          ; Save the current kernel stack pointer in the PCB
+    mov esp, edx            ; Switch to the next kernel stack
+
+    pop edi
+    pop esi
+    pop ebx
+    pop ebp
+    ret                     ; Continue the next context
+
+; =============================
+; First return address of a new process kernel stack.
+; The stack holds the initial user registers (IntRegisters) built by scheduler::createProcess.
+; The kernel lock is still held by the cpu that switched to the new process, it's released before the jump to ring 3.
+; =============================
+process_start:
+    call scheduler_process_entry
+    popa                    ; pop: edi, esi, ebp, esp, ebx, edx, ecx, eax
+    iret                    ; Jump to the process entry point in ring 3
@@ -5,55 +5,411 @@
 #include "string.h"
 #include "stdio.h" // Debug only
 // cpu
+#include "gdt.h"
 #include "paging.h"
+#include "tsc.h"
+#include "fpu.h"
+#include "apic.h"
+#include "smp.h"
 // memory
 #include "heap.h"
-#include "stack.h"
 #include "memutils.h" // Debug only
 // process
 #include "queue.h"
+// legacy drivers
+#include "pit.h"
+#include "vga.h"
 // sys
 #include "fs.h"
+#include "timer.h"
 #include "scheduler.h"
 #include "syscalls.h"
+#include "spinlock.h"
+#include "rwlock.h"
+#include "softirq.h"
+#include "workqueue.h"
 
 Queue allProcesses;
-Queue readyProcesses;
 Queue waitingProcesses;
-PID runningProcess;
-
-// Only one process can access a keyboard resource per time.
-// Also this resource should be discarded, after it's usage.
-Stack waitingKeyboardProcesses;
-
-unsigned int kernelESP;
+RwLock processesLock;           // Protects allProcesses, read by the process list and changed by the creation and termination
+Spinlock waitLock;              // Protects waitingProcesses, the wait queues and the waitQueue of the PCBs. Taken with the interruptions disabled
+
+/**
+ * @brief Scheduler state of one cpu
+ * 
+ */
+typedef struct {
+    Spinlock lock;              // Protects readyProcesses and readyCount, other cpus add and steal processes
+    Queue readyProcesses;       // Processes that ran the last time on this cpu
+    volatile uint32_t readyCount;   // Processes in readyProcesses, read without the lock to choose the queue to steal from
+    PID runningProcess;         // NULL when the cpu runs its idle context
+    PID mappedProcess;          // Process which memory pages are mapped at virtual address 0 in the page directory of the cpu
+    PID deadProcess;            // Terminated process which PCB and kernel stack are released after the next context switch
+    unsigned int idleESP;       // Kernel stack pointer of the idle context (scheduler::start)
+    uint32_t sliceTicks;        // Scheduler ticks of the running process since it was switched in
+    bool needResched;           // The running process used its time slice
+    uint64_t switchStartTsc;    // TSC read before switch_to, the TSC of each cpu is only compared with itself
+    uint32_t preemptions;       // Processes switched out at the end of their time slice
+    uint32_t steals;            // Processes taken from the ready queue of another cpu
+    uint32_t idleWakeups;       // Times the idle cpu was woken up
+    uint32_t idleTicks;         // Timer ticks elapsed while the cpu was halted
+} RunQueue;
+
+RunQueue runQueues[SMP_MAX_CPUS];
+
+uint32_t switchCount;           // Context switches measured
+uint32_t switchLastCycles;      // Cycles of the last context switch
+uint32_t switchMinCycles;       // Fastest context switch
+uint32_t switchMaxCycles;       // Slowest context switch
+uint32_t switchAvgCycles;       // Moving average 1/8 of the context switch cycles
+
+/**
+ * @brief Get the scheduler state of the running cpu
+ * 
+ * @return RunQueue* Run queue of the cpu
+ */
+RunQueue* currentRunQueue() {
+    return &runQueues[smp::getCpuIndex()];
+}
 
 void scheduler::init() {
+    int i;
+    RunQueue* rq;
+
     // Global vars are located in .bss section unitialized data. Must be initialized.
     queue::init(&allProcesses);
-    queue::init(&readyProcesses);
     queue::init(&waitingProcesses);
-    stack::init(&waitingKeyboardProcesses);
-    kernelESP = 0;
+    rwlock::init(&processesLock, "processes");
+    spinlock::init(&waitLock, "waitqueues");
+    for (i = 0; i < SMP_MAX_CPUS; i++) {
+        rq = &runQueues[i];
+        spinlock::init(&rq->lock);
+        queue::init(&rq->readyProcesses);
+        rq->readyCount = 0;
+        rq->runningProcess = NULL;
+        rq->mappedProcess = NULL;
+        rq->deadProcess = NULL;
+        rq->idleESP = 0;
+        rq->sliceTicks = 0;
+        rq->needResched = false;
+        rq->switchStartTsc = 0;
+        rq->preemptions = 0;
+        rq->steals = 0;
+        rq->idleWakeups = 0;
+        rq->idleTicks = 0;
+    }
+    switchCount = 0;
+    switchLastCycles = 0;
+    switchMinCycles = 0xFFFFFFFF;
+    switchMaxCycles = 0;
+    switchAvgCycles = 0;
+}
+
+/**
+ * @brief Add a process at the end of a ready queue
+ * 
+ * @param rq    Run queue
+ * @param pid   PID = PCB*
+ */
+void runQueueAdd(RunQueue* rq, PID pid) {
+    uint32_t flags;
+
+    flags = spinlock::acquireIrqSave(&rq->lock);
+    queue::add(&rq->readyProcesses, pid);
+    rq->readyCount++;
+    spinlock::releaseIrqRestore(&rq->lock, flags);
+}
+
+/**
+ * @brief Remove the first process of a ready queue
+ * 
+ * @param rq        Run queue
+ * @return PID      First ready process, NULL if the queue is empty
+ */
+PID runQueueRemoveFirst(RunQueue* rq) {
+    PID pid;
+    uint32_t flags;
+
+    flags = spinlock::acquireIrqSave(&rq->lock);
+    pid = (PID) queue::removeFirst(&rq->readyProcesses);
+    if (pid != NULL) {
+        rq->readyCount--;
+    }
+    spinlock::releaseIrqRestore(&rq->lock, flags);
+    return pid;
+}
+
+/**
+ * @brief Remove a process from a ready queue
+ * 
+ * @param rq    Run queue
+ * @param pid   PID = PCB*
+ */
+void runQueueRemove(RunQueue* rq, PID pid) {
+    uint32_t flags;
+
+    flags = spinlock::acquireIrqSave(&rq->lock);
+    while (queue::removeElement(&rq->readyProcesses, (void*) pid->pid)) {
+        rq->readyCount--;
+    }
+    spinlock::releaseIrqRestore(&rq->lock, flags);
+}
+
+/**
+ * @brief Check if every cpu runs its idle context. Only then the tick can be stopped: the ticks of cpu 0 are the clock
+ *        of the timer wheel of every cpu, a process running on another cpu reads them when it sleeps.
+ * 
+ * @return true     No cpu runs a process
+ * @return false    At least one cpu runs a process
+ */
+bool allCpusIdle() {
+    uint8_t i;
+
+    for (i = 0; i < smp::getCpuCount(); i++) {
+        if (runQueues[i].runningProcess != NULL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Take the first ready process of the longest ready queue of the other cpus. Called by an idle cpu.
+ * 
+ * @param cpu       Index of the idle cpu
+ * @return PID      Stolen process, now belonging to the idle cpu. NULL if no other cpu has ready processes
+ */
+PID stealProcess(uint8_t cpu) {
+    uint8_t i;
+    uint8_t victim = cpu;
+    uint32_t longest = 0;
+    PID pid;
+
+    for (i = 0; i < smp::getCpuCount(); i++) {
+        if (i != cpu && runQueues[i].readyCount > longest) {
+            longest = runQueues[i].readyCount;
+            victim = i;
+        }
+    }
+    if (victim == cpu) {
+        return NULL;
+    }
+
+    pid = runQueueRemoveFirst(&runQueues[victim]);
+    if (pid != NULL) {
+        pid->cpu = cpu;
+        runQueues[cpu].steals++;
+    }
+    return pid;
+}
+
+/**
+ * @brief Map the memory pages of the given process at virtual address 0 with user access, in the page directory of the running cpu.
+ * 
+ * @param rq  Run queue of the running cpu
+ * @param pid PID = PCB*
+ */
+void mapProcessMemory(RunQueue* rq, PID pid) {
+    int i;
+
+    for (i=0; i < PROC_MAX_MEMORY_PAGES; i++) {
+        paging::unmapPage(i * FRAME_SIZE);
+        if (pid->memoryPages[i] != PROC_UNUSED_PAGE) {
+            paging::remoteMapPage(i * FRAME_SIZE, pid->memoryPages[i], 1);
+        }
+    }
 
+    paging::pagesRefresh();
+    rq->mappedProcess = pid;
+}
+
+/**
+ * @brief Release the PCB and the kernel stack of the last terminated process of the running cpu.
+ *        Called only when running on another kernel stack.
+ * 
+ * @param rq Run queue of the running cpu
+ */
+void freeDeadProcess(RunQueue* rq) {
+    if (rq->deadProcess != NULL) {
+        heap::kfree(rq->deadProcess->kernelStack);
+        heap::kfree(rq->deadProcess);
+        rq->deadProcess = NULL;
+    }
+}
+
+/**
+ * @brief Update the context switch statistics
+ * 
+ * @param cycles Cycles elapsed between switch_to call and return
+ */
+void recordSwitchCycles(uint32_t cycles) {
+    switchCount++;
+    switchLastCycles = cycles;
+    if (cycles < switchMinCycles) {
+        switchMinCycles = cycles;
+    }
+    if (cycles > switchMaxCycles) {
+        switchMaxCycles = cycles;
+    }
+    switchAvgCycles = switchCount == 1 ? cycles : switchAvgCycles - (switchAvgCycles >> 3) + (cycles >> 3);
+}
+
+/**
+ * @brief Save the current kernel context in prevESP and continue the next process, or the idle context if next is NULL.
+ *        Returns when the current context is switched back, maybe on another cpu.
+ * 
+ * @param prevESP   Where the current kernel stack pointer is saved
+ * @param next      Next process or NULL for the idle context
+ */
+void switchTo(unsigned int* prevESP, PID next) {
+    uint8_t cpu;
+    RunQueue* rq;
+    unsigned int nextESP;
+    uint32_t flags;
+
+    // A worker thread can block with the interruptions enabled, they are restored when it's switched back
+    asm volatile("pushf; pop %0; cli" : /* output */ "=r"(flags) : /* input */ : /* clobbers */ "memory");
+    cpu = smp::getCpuIndex();
+    rq = &runQueues[cpu];
+    nextESP = rq->idleESP;
+
+    rq->runningProcess = next;
+    rq->sliceTicks = 0;
+    rq->needResched = false;
+    fpu::switchTo(next != NULL ? &next->fpuState : NULL);   // FPU/SSE registers are switched on the first FPU instruction
+    vga::setOutputConsole(next != NULL ? next->console : VGA_KERNEL_CONSOLE);  // The kernel messages go to the console of the running process
+    if (next != NULL) {
+        next->processState = PROC_STATE_RUNNING;
+        next->cpu = cpu;
+        if (!next->kernelThread && next != rq->mappedProcess) { // memory switch, skipped when the process is already mapped or has no user memory
+            mapProcessMemory(rq, next);
+        }
+        gdt::setKernelStack(cpu, (uint32_t) next->kernelStack + PROC_KERNEL_STACK_SIZE); // Interrupts and syscalls from ring 3 use the process kernel stack
+        nextESP = next->kernelESP;
+    }
+
+    rq->switchStartTsc = tsc::read();
+    switch_to(prevESP, nextESP);
+    rq = currentRunQueue();     // The context may be continued by another cpu
+    recordSwitchCycles((uint32_t) (tsc::read() - rq->switchStartTsc)); // Switched back, only the time spent in switch_to of the previous context is measured
+
+    freeDeadProcess(rq);
+    asm volatile("push %0; popf" : /* output */ : /* input */ "r"(flags) : /* clobbers */ "memory", "cc");
+}
+
+extern "C" void scheduler_process_entry() {
+    freeDeadProcess(currentRunQueue());
+    smp::unlockKernel();                                // Taken by the cpu that switched to the new process
+}
+
+/**
+ * @brief First function of a kernel thread, the return address of its initial SwitchFrame.
+ *        The kernel lock taken by the cpu that switched to it is kept, kernel threads run kernel code.
+ *
+ * @param entry Thread function
+ */
+extern "C" void scheduler_kthread_start(void (*entry)()) {
+    freeDeadProcess(currentRunQueue());
+    entry();
+
+    // The thread function returned
+    scheduler::processTerminate(currentRunQueue()->runningProcess);
+    scheduler::schedule();
 }
 
 void scheduler::start() {
-    runningProcess = (PID) queue::removeFirst(&readyProcesses);
-    if (runningProcess == NULL) {
-        // No ready processes, stop cpu execution until next interruption to save power consumption.
-        // stdio::kprintf("SCHEDULER - no ready process found.\n");
-        __asm__ volatile ("sti");       // Enable interruptions again to use hlt.
-        while(runningProcess == NULL) { // This is our idle process.
-            __asm__ volatile ("hlt");   // Halt the cpu. Waits until an IRQ occurs minimize CPU usage, heat and consumption.
-            runningProcess = (PID) queue::removeFirst(&readyProcesses);
+    uint8_t cpu = smp::getCpuIndex();
+    RunQueue* rq = &runQueues[cpu];
+    PID next;
+    uint32_t haltTick = 0;
+    bool halted = false;
+
+    // Kernel and processes share the flat user data segment, so the segment registers are never reloaded on a context switch.
+    asm volatile("mov %0, %%ds;"
+                 "mov %0, %%es;"
+                 "mov %0, %%fs;"
+                 "mov %0, %%gs;"
+                 : /* output */ : /* input */ "r" (GDT_USER_DATA_SEL));
+
+    __asm__ volatile ("cli");
+    smp::lockKernel();                                  // The idle context holds the kernel lock while the queues are read
+    if (cpu == 0) {
+        smp::releaseAps();
+    }
+
+    while (true) { // This is our idle process.
+        if (halted) {                                   // Woken up by an interruption
+            __asm__ volatile ("cli");                   // Disable interruptions while the queues are read.
+            smp::lockKernel();
+            pit::idleExit();                            // Back to periodic ticks, accounting the ticks skipped by the one-shot.
+                                                        // Any cpu ends it, so its next process doesn't read stale ticks.
+
+            apic::timerStart();
+            rq->idleWakeups++;
+            rq->idleTicks += timer::getTicks() - haltTick;
+            halted = false;
         }
-        __asm__ volatile ("cli");       // Disable interruptions again since one or more processes are in execution.
+
+        next = runQueueRemoveFirst(rq);
+        if (next == NULL) {
+            next = stealProcess(cpu);                   // Balance the load before halting
+        }
+        if (next != NULL) {
+            switchTo(&rq->idleESP, next);               // Returns when no process is ready, the idle context never changes of cpu.
+        } else {
+            // No ready processes, stop cpu execution until next interruption to save power consumption.
+            if (cpu == 0 && allCpusIdle()) {
+                pit::idleEnter();                       // Tickless idle, skip the ticks without expiring timers
+            }
+            apic::timerStop();                          // The scheduler tick is useless while no process runs
+            vga::flush();                               // No tick will flush the screen while the cpu is halted
+            haltTick = timer::getTicks();
+            halted = true;
+            smp::unlockKernel();                        // The interruptions of the halted cpu take the lock
+            // sti only takes effect after the next instruction, so an IRQ can't be lost between sti and hlt.
+            __asm__ volatile ("sti; hlt");              // Halt the cpu. Waits until an IRQ occurs minimize CPU usage, heat and consumption.
+        }
+    }
+}
+
+void scheduler::schedule() {
+    RunQueue* rq = currentRunQueue();
+    PID prev = rq->runningProcess;
+    PID next = runQueueRemoveFirst(rq);
+
+    if (next == prev) { // Only the running process is ready
+        prev->processState = PROC_STATE_RUNNING;
+        return;
+    }
+
+    switchTo(&prev->kernelESP, next);
+}
+
+void scheduler::yield() {
+    resumeProcess(currentRunQueue()->runningProcess);
+    schedule();
+}
+
+void scheduler::tick() {
+    RunQueue* rq = currentRunQueue();
+
+    if (rq->runningProcess != NULL && ++rq->sliceTicks >= PROC_TIMESLICE_TICKS) {
+        rq->needResched = true;
     }
+}
 
-    // kprintf("sched: %s\n", runningProcess->processName);
+void scheduler::preempt() {
+    RunQueue* rq = currentRunQueue();
 
-    processLoadContext(runningProcess);
+    if (!rq->needResched || rq->runningProcess == NULL) {
+        return;
+    }
+    rq->needResched = false;
+    if (rq->readyCount > 0) { // Keep running when no other process is ready
+        rq->preemptions++;
+        yield();
+    }
+    currentRunQueue()->sliceTicks = 0;
 }
 
 unsigned int scheduler::loadProcess(unsigned int *pages, const char* processName) {
@@ -92,18 +448,21 @@ unsigned int scheduler::loadProcess(unsigned int *pages, const char* processName
         bytesCopied += bytesToCopy;
         paging::unmapPage(pages[i]);
 
-        stdio::kprintf("SCHED - allocatingPages: 0x%x\n", pages[i]);
+        KPRINTF("SCHED - allocatingPages: 0x%x\n", pages[i]);
     }
 
-    stdio::kprintf("SCHED - bytesCopied: %d\n", bytesCopied);
+    KPRINTF("SCHED - bytesCopied: %d\n", bytesCopied);
 
     return pageCount;
 }
 
 PID scheduler::createProcess(const char* processName) {
     PCB *pcb;
+    PID parent;
     int i;
     int progPageCount = 0; // pages for program text
+    IntRegisters* regs;
+    SwitchFrame* frame;
 
     pcb = (PCB*) heap::kmalloc(sizeof(PCB));
 
@@ -111,10 +470,23 @@ PID scheduler::createProcess(const char* processName) {
         return NULL;
     }
 
+    pcb->kernelStack = (unsigned char*) heap::kmalloc(PROC_KERNEL_STACK_SIZE);
+    if (pcb->kernelStack == NULL) {
+        heap::kfree(pcb);
+        return NULL;
+    }
+
     string::strcpy(pcb->processName, processName);
     pcb->processState = PROC_STATE_NEW;
     pcb->pid = (unsigned int) pcb;
     pcb->priority = PROC_PRIORITY_USER;
+    fpu::initState(&pcb->fpuState);
+    pcb->waitQueue = NULL;
+    pcb->cpu = smp::getCpuIndex();              // Starts on the cpu of its parent, idle cpus steal it when this one is busy
+    pcb->kernelThread = false;
+    parent = currentRunQueue()->runningProcess;
+    pcb->console = parent != NULL ? parent->console : VGA_KERNEL_CONSOLE;   // Same console as its parent, the boot processes use the first one
+    timer::init(&pcb->sleepTimer, NULL, pcb);
 
     for (i = 0; i < PROC_MAX_MEMORY_PAGES; i++) {
         pcb->memoryPages[i] = PROC_UNUSED_PAGE;
@@ -122,6 +494,8 @@ PID scheduler::createProcess(const char* processName) {
 
     progPageCount = loadProcess(pcb->memoryPages, processName); // load program text
     if (progPageCount == 0) {
+        heap::kfree(pcb->kernelStack);
+        heap::kfree(pcb);
         return NULL;
     }
 
@@ -143,43 +517,56 @@ PID scheduler::createProcess(const char* processName) {
     // Initializing process stack (PAGE POSITION 17)
     pcb->memoryPages[PROC_MAX_MEMORY_PAGES - stackOffet] = paging::frameAddress(paging::frameAlloc());
 
-    // stdio::kprintf("%s - (%d) - STACK: 0x%x\n", processName, PROC_MAX_MEMORY_PAGES - stackOffet, pcb->memoryPages[PROC_MAX_MEMORY_PAGES - stackOffet]);
+    // KPRINTF("%s - (%d) - STACK: 0x%x\n", processName, PROC_MAX_MEMORY_PAGES - stackOffet, pcb->memoryPages[PROC_MAX_MEMORY_PAGES - stackOffet]);
 
     // Initializing heap (PAGE POSITION 1-16)
     for (i = progPageCount; i < PROC_MAX_MEMORY_PAGES - heapOffset; i++) {
         pcb->memoryPages[i] = paging::frameAddress(paging::frameAlloc());
     }
-    // stdio::kprintf("%s - (%d) - HEAP: 0x%x - 0x%x\n", processName, PROC_MAX_MEMORY_PAGES - heapOffset, pcb->memoryPages[progPageCount], pcb->memoryPages[PROC_MAX_MEMORY_PAGES - heapOffset - 1]);
+    // KPRINTF("%s - (%d) - HEAP: 0x%x - 0x%x\n", processName, PROC_MAX_MEMORY_PAGES - heapOffset, pcb->memoryPages[progPageCount], pcb->memoryPages[PROC_MAX_MEMORY_PAGES - heapOffset - 1]);
 
     heap::init(&pcb->processHeap, progPageCount * FRAME_SIZE, (i - progPageCount));
 
-    // stdio::kprintf("PAGE_LAYOUT: ");
+    // KPRINTF("PAGE_LAYOUT: ");
     // for (i=0; i<PROC_MAX_MEMORY_PAGES; i++) {
-    //     stdio::kprintf("%x, ", pcb->memoryPages[i]);
+    //     KPRINTF("%x, ", pcb->memoryPages[i]);
     // }
-    // stdio::kprintf("\n");
-
-    // Initializing registers
-    pcb->registers.EAX = 0;
-    pcb->registers.EBX = 0;
-    pcb->registers.ECX = 0;
-    pcb->registers.EDX = 0;
-    pcb->registers.ESP = (PROC_MAX_MEMORY_PAGES - espOffset) * FRAME_SIZE - 4; // Decrement 4 to let 1 byte free in end of process memory layout.
-    pcb->registers.EBP = 0;
-    pcb->registers.ESI = 0;
-    pcb->registers.EDI = 0;
-    pcb->registers.EFLAGS = 1 << 9; // IT (interrupt flag) set. Enable interruptions
-    pcb->registers.EIP = 0;
-    pcb->registers.CS = 0x8;        // GDT - code segment 0x8
-    pcb->registers.SS = 0x10;       // GDT - data segment 0x10
-    pcb->registers.DS = 0x10;
-    pcb->registers.ES = 0x10;
-    pcb->registers.FS = 0x10;
-    pcb->registers.GS = 0x10;
-
-    // stdio::kprintf("%s - ESP: 0x%x\n", processName, pcb->registers.ESP);
+    // KPRINTF("\n");
 
+    /*
+        INITIAL KERNEL STACK (top to bottom):
+        IntRegisters: user registers popped by process_start (popa + iret to ring 3)
+        SwitchFrame:  callee-saved registers popped by switch_to, returns to process_start
+    */
+    regs = (IntRegisters*) (pcb->kernelStack + PROC_KERNEL_STACK_SIZE - sizeof(IntRegisters));
+    regs->eax = 0;
+    regs->ebx = 0;
+    regs->ecx = 0;
+    regs->edx = 0;
+    regs->esp = 0;                              // Ignored by popa
+    regs->ebp = 0;
+    regs->esi = 0;
+    regs->edi = 0;
+    regs->eip = 0;
+    regs->cs = GDT_USER_CODE_SEL;               // GDT - user code segment 0x18 | RPL 3
+    regs->eflags = 1 << 9;                      // IT (interrupt flag) set. Enable interruptions
+    regs->useresp = (PROC_MAX_MEMORY_PAGES - espOffset) * FRAME_SIZE - 4; // Decrement 4 to let 1 byte free in end of process memory layout.
+    regs->ss = GDT_USER_DATA_SEL;               // GDT - user data segment 0x20 | RPL 3
+    pcb->registers = regs;
+
+    frame = (SwitchFrame*) regs - 1;
+    frame->edi = 0;
+    frame->esi = 0;
+    frame->ebx = 0;
+    frame->ebp = 0;
+    frame->eip = (unsigned int) process_start;
+    pcb->kernelESP = (unsigned int) frame;
+
+    // KPRINTF("%s - ESP: 0x%x\n", processName, regs->useresp);
+
+    rwlock::writeLock(&processesLock);
     queue::add(&allProcesses, (void*) pcb->pid);
+    rwlock::writeUnlock(&processesLock);
 
     // Debug only
     // runningProcess = pcb;
@@ -187,144 +574,225 @@ PID scheduler::createProcess(const char* processName) {
     return pcb;
 }
 
-void scheduler::resumeProcess(PID pid) {
-    queue::add(&readyProcesses, pid);
-    pid->processState = PROC_STATE_READY;
-}
-
-void scheduler::processLoadContext(PID pid) {
+PID scheduler::createKernelThread(const char* threadName, void (*entry)()) {
+    PCB *pcb;
     int i;
+    unsigned int* args;
+    SwitchFrame* frame;
 
-    pid->processState = PROC_STATE_RUNNING;
+    pcb = (PCB*) heap::kmalloc(sizeof(PCB));
+    if (pcb == NULL) {
+        return NULL;
+    }
 
-    // memory switch
-    for (i=0; i < PROC_MAX_MEMORY_PAGES; i++) {
-        if (pid->memoryPages[i] != PROC_UNUSED_PAGE) {
-            paging::unmapPage(i * FRAME_SIZE);
-            paging::remoteMapPage(i * FRAME_SIZE, pid->memoryPages[i]);
-        }
+    pcb->kernelStack = (unsigned char*) heap::kmalloc(PROC_KERNEL_STACK_SIZE);
+    if (pcb->kernelStack == NULL) {
+        heap::kfree(pcb);
+        return NULL;
     }
 
-    paging::pagesRefresh();
-    //kprintf("load: %s %x\n", pid->processName, pid->pid);
-
-    if (kernelESP == 0) { // When the first context switch is performed we save the Last Kernel ESP 
-        // kernelESP = 0x6504FE0;
-        int currentEspPtr = 0;
-        kernelESP = (unsigned int) &currentEspPtr;
-    }
-
-    asm("push %0;"
-        "pop %%esp;"
-        "push %1;"
-        "push %2;"
-        "push %3;"
-        : /* output*/ 
-        : /* input */ "g" (pid->registers.ESP), "g" (pid->registers.EFLAGS), "g" (pid->registers.CS),
-                      "g" (pid->registers.EIP)
-        );
-    asm("push %0;"
-        "push %1;"
-        "push %2;"
-        "push %3;"
-        : /* output*/
-        : /* input */ "g" (pid->registers.DS), "g" (pid->registers.ES), "g" (pid->registers.FS),
-                      "g" (pid->registers.GS)
-        );
-    asm("push %0;"
-        "push %1;"
-        "push %2;"
-        "push %3;"
-        "push %4;"
-        "push %5;"
-        "push %6;"
-        "push %7;"
-        : /* output */ 
-        : /* input  */ "g" (pid->registers.EAX), "g" (pid->registers.ECX), "g" (pid->registers.EDX),
-                       "g" (pid->registers.EBX), "g" (pid->registers.ESP), "g" (pid->registers.EBP),
-                       "g" (pid->registers.ESI), "g" (pid->registers.EDI)
-        );
-
-    asm("popa;"
-        "pop %%gs;"
-        "pop %%fs;"
-        "pop %%es;"
-        "pop %%ds;"
-        "iret;"
-        : /* output */ : /* input */
-        );
+    string::strcpy(pcb->processName, threadName);
+    pcb->processState = PROC_STATE_NEW;
+    pcb->pid = (unsigned int) pcb;
+    pcb->priority = PROC_PRIORITY_SYSTEM;
+    fpu::initState(&pcb->fpuState);
+    pcb->waitQueue = NULL;
+    pcb->cpu = smp::getCpuIndex();
+    pcb->kernelThread = true;
+    pcb->console = VGA_KERNEL_CONSOLE;
+    pcb->registers = NULL;                      // Never runs in user mode
+    timer::init(&pcb->sleepTimer, NULL, pcb);
+
+    for (i = 0; i < PROC_MAX_MEMORY_PAGES; i++) {
+        pcb->memoryPages[i] = PROC_UNUSED_PAGE;
+    }
+
+    /*
+        INITIAL KERNEL STACK (top to bottom):
+        entry:        argument of scheduler_kthread_start
+        0:            return address of scheduler_kthread_start, it never returns
+        SwitchFrame:  callee-saved registers popped by switch_to, returns to scheduler_kthread_start
+    */
+    args = (unsigned int*) (pcb->kernelStack + PROC_KERNEL_STACK_SIZE) - 2;
+    args[0] = 0;
+    args[1] = (unsigned int) entry;
+
+    frame = (SwitchFrame*) args - 1;
+    frame->edi = 0;
+    frame->esi = 0;
+    frame->ebx = 0;
+    frame->ebp = 0;
+    frame->eip = (unsigned int) scheduler_kthread_start;
+    pcb->kernelESP = (unsigned int) frame;
+
+    rwlock::writeLock(&processesLock);
+    queue::add(&allProcesses, (void*) pcb->pid);
+    rwlock::writeUnlock(&processesLock);
+
+    return pcb;
 }
 
-void scheduler::processSaveContext(PID pid, IntRegisters *regs) {
-    pid->registers.EAX = regs->eax;
-    pid->registers.EBX = regs->ebx;
-    pid->registers.ECX = regs->ecx;
-    pid->registers.EDX = regs->edx;
-    pid->registers.ESI = regs->esi;
-    pid->registers.EDI = regs->edi;
-    pid->registers.ESP = regs->esp + 12;
-    pid->registers.EBP = regs->ebp;
-    pid->registers.EFLAGS = regs->eflags;
-    pid->registers.EIP = regs->eip;
-    pid->registers.CS = regs->cs;
+void scheduler::resumeProcess(PID pid) {
+    uint8_t i;
+    uint8_t cpu = pid->cpu;
+
+    pid->processState = PROC_STATE_READY;
+    runQueueAdd(&runQueues[cpu], pid);
+
+    // Wake up the cpu of the process if it's idle, otherwise another idle cpu that will steal it
+    if (runQueues[cpu].runningProcess != NULL) {
+        for (i = 0; i < smp::getCpuCount() && runQueues[i].runningProcess != NULL; i++) {}
+        cpu = i;
+    }
+    if (cpu < smp::getCpuCount()) {
+        smp::sendReschedule(cpu);
+    }
 }
 
 void scheduler::processTerminate(PID pid) {
     int i;
+    uint32_t flags;
+    RunQueue* rq = currentRunQueue();
 
+    rwlock::writeLock(&processesLock);
     if (queue::removeElement(&allProcesses, (void*) pid) == false) { // No such process
+        rwlock::writeUnlock(&processesLock);
         return;
     }
+    while (queue::removeElement(&allProcesses, (void*)pid->pid)){}
+    rwlock::writeUnlock(&processesLock);
 
     // Freeing memory used by the process
     for (i = 0; i < PROC_MAX_MEMORY_PAGES; i++) {
         if (pid->memoryPages[i] != PROC_UNUSED_PAGE) {
             paging::frameFree(paging::frameNumber(pid->memoryPages[i]));
-            paging::unmapPage(i * FRAME_SIZE);
+            if (rq->mappedProcess == pid) {
+                paging::unmapPage(i * FRAME_SIZE);
+            }
         }
     }
+    for (i = 0; i < SMP_MAX_CPUS; i++) {
+        if (runQueues[i].mappedProcess == pid) {    // The other cpus remap their first page table on the next switch
+            runQueues[i].mappedProcess = NULL;
+        }
+    }
+
+    fpu::releaseState(&pid->fpuState);
+    timer::cancel(&pid->sleepTimer);
 
     // Removing PID from all process queues
-    while (queue::removeElement(&allProcesses, (void*)pid->pid)){}
-    while (queue::removeElement(&readyProcesses, (void*)pid->pid)){}
+    for (i = 0; i < SMP_MAX_CPUS; i++) {
+        runQueueRemove(&runQueues[i], pid);
+    }
+    flags = spinlock::acquireIrqSave(&waitLock);
     while (queue::removeElement(&waitingProcesses, (void*)pid->pid)){}
-    while (stack::removeElement(&waitingKeyboardProcesses, (void*)pid->pid)){}
+    if (pid->waitQueue != NULL) {
+        while (queue::removeElement(pid->waitQueue, (void*)pid->pid)){}
+    }
+    spinlock::releaseIrqRestore(&waitLock, flags);
+
+    if (pid == rq->runningProcess) {
+        // The process is terminating itself and its kernel stack is in use, release it after the next context switch.
+        freeDeadProcess(rq);
+        rq->deadProcess = pid;
+        return;
+    }
 
     // Freeing process PCB
+    heap::kfree(pid->kernelStack);
     heap::kfree(pid);
 }
 
-void scheduler::kbdAskResource(PID pid) {
-    pid->processState = PROC_STATE_WAITING;                                      // Move process to waiting state
-    while (queue::removeElement(&readyProcesses, (void*) runningProcess->pid)){} // Remove process from ready queue
-    queue::add(&waitingProcesses, (void*) runningProcess->pid);                  // Add process to waiting queue
-    stack::push(&waitingKeyboardProcesses, (void*) runningProcess->pid);         // Add process to waitingKeyboard queue
+void scheduler::block(Queue* waitQueue, unsigned char state, Spinlock* lock) {
+    PID pid = currentRunQueue()->runningProcess;
+    uint32_t flags;
+
+    // The wait queues are also changed by the interruption handlers and the tasklets
+    flags = spinlock::acquireIrqSave(&waitLock);
+    pid->processState = state;                                      // Move process to waiting or sleeping state
+    pid->waitQueue = waitQueue;
+    queue::add(&waitingProcesses, (void*) pid->pid);                // Add process to waiting queue
+    queue::add(waitQueue, (void*) pid->pid);                        // Add process to the queue of the event being waited
+    spinlock::releaseIrqRestore(&waitLock, flags);
+
+    if (lock != NULL) {
+        spinlock::release(lock);                                    // A wake up after the condition check finds the process in the wait queue
+    }
+
+    schedule();                                                     // Returns when the process is woken up
+}
+
+/**
+ * @brief Move a process removed from a wait queue to the ready queue. Called with waitLock held.
+ * 
+ * @param pid PID = PCB*
+ */
+void wakeUpLocked(PID pid) {
+    while (queue::removeElement(&waitingProcesses, (void*) pid->pid)) {}
+    pid->waitQueue = NULL;
+    scheduler::resumeProcess(pid);                                  // Add process to ready queue
 }
 
-void scheduler::kbdCreateResource(char* kbdBuffer) {
+void scheduler::wakeUp(Queue* waitQueue) {
     PID pid;
-    int i;
+    uint32_t flags;
+
+    flags = spinlock::acquireIrqSave(&waitLock);
+    while ((pid = (PID) queue::removeFirst(waitQueue)) != NULL) {
+        wakeUpLocked(pid);
+    }
+    spinlock::releaseIrqRestore(&waitLock, flags);
+}
+
+PID scheduler::wakeUpOne(Queue* waitQueue) {
+    PID pid;
+    uint32_t flags;
 
-    // Remove process from waiting queues
-    pid = (PID) stack::pop(&waitingKeyboardProcesses);
+    flags = spinlock::acquireIrqSave(&waitLock);
+    pid = (PID) queue::removeFirst(waitQueue);
     if (pid != NULL) {
-        while (queue::removeElement(&waitingProcesses, (void*) pid->pid)) {}
+        wakeUpLocked(pid);
+    }
+    spinlock::releaseIrqRestore(&waitLock, flags);
+    return pid;
+}
 
-        // Copy input buffer to process memory, address is in EDI
-        for (i=0; i<PROC_MAX_MEMORY_PAGES; i++) {
-            if (pid->memoryPages[i] != PROC_UNUSED_PAGE) {
-                paging::remoteMapPage(i * FRAME_SIZE, pid->memoryPages[i]);
-            }
-        }
-        string::strcpy((char*) pid->registers.EDI, kbdBuffer);
+void scheduler::wakeUpProcess(Queue* waitQueue, PID pid) {
+    uint32_t flags;
 
-        // Add process that request this resource to ready queue
-        queue::add(&readyProcesses, (void*) pid->pid);
+    flags = spinlock::acquireIrqSave(&waitLock);
+    if (queue::removeElement(waitQueue, (void*) pid->pid)) {
+        wakeUpLocked(pid);
     }
+    spinlock::releaseIrqRestore(&waitLock, flags);
 }
 
 PID scheduler::getRunningProcess() {
-    return runningProcess;
+    return currentRunQueue()->runningProcess;
+}
+
+bool scheduler::isUserMemory(PID pid, const void* ptr, unsigned int size) {
+    unsigned int start = (unsigned int) ptr;
+    unsigned int page;
+
+    if (size == 0) {                                                    // Nothing is accessed
+        return true;
+    }
+    if (start + size < start || start + size > PROC_MAX_MEMORY_PAGES * FRAME_SIZE) {
+        return false;
+    }
+
+    for (page = start / FRAME_SIZE; page <= (start + size - 1) / FRAME_SIZE; page++) {
+        if (pid->memoryPages[page] == PROC_UNUSED_PAGE) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool scheduler::hasReadyProcesses() {
+    return currentRunQueue()->readyCount > 0;
 }
 
 void scheduler::printProcessList() {
@@ -332,12 +800,14 @@ void scheduler::printProcessList() {
     Queue* q = &allProcesses;
     QueueElement *e;
     PCB *pcb;
+    RunQueue* rq;
 
-    stdio::kprintf("---------- Processes ---------\n");
+    KPRINTF("---------- Processes ---------\n");
+    rwlock::readLock(&processesLock);
     e = q->front;
     while (e != NULL) {
         pcb = (PCB*) e->data;
-        char* stateStr;
+        const char* stateStr = "UNKNOWN";
         switch(pcb->processState) {
             case PROC_STATE_NEW:
                 stateStr = "NEW";
@@ -351,9 +821,25 @@ void scheduler::printProcessList() {
             case PROC_STATE_WAITING:
                 stateStr = "WAITING";
                 break;
+            case PROC_STATE_SLEEPING:
+                stateStr = "SLEEPING";
+                break;
         }
-        stdio::kprintf("%s (%x) - %s\n", pcb->processName, (unsigned int) pcb, stateStr);
+        KPRINTF("%s (%x) - %s - cpu %d - tty%d\n", pcb->processName, (unsigned int) pcb, stateStr, pcb->cpu, pcb->console + 1);
         e = e->next;
     }
-    stdio::kprintf("-----------------------------\n");
+    rwlock::readUnlock(&processesLock);
+    for (i = 0; i < smp::getCpuCount(); i++) {
+        rq = &runQueues[i];
+        KPRINTF("CPU %d: ready %d, preemptions %d, steals %d, idle wakeups %d in %d ticks\n", i, rq->readyCount, rq->preemptions, rq->steals, rq->idleWakeups, rq->idleTicks);
+        KPRINTF("       tasklets %d\n", softirq::getTaskletRuns(i));
+    }
+    KPRINTF("Worker threads: %d works run\n", workqueue::getWorkRuns());
+    if (apic::isEnabled()) {
+        KPRINTF("APIC scheduler ticks: %d\n", apic::getTimerTicks());
+    }
+    if (switchCount > 0) {
+        KPRINTF("Context switch cycles: last %d, avg %d, min %d, max %d\n", switchLastCycles, switchAvgCycles, switchMinCycles, switchMaxCycles);
+    }
+    KPRINTF("-----------------------------\n");
 }
\ No newline at end of file
@@ -3,16 +3,24 @@
 #define _SCHEDULER_H_
 // libc
 #include <stdint.h>
+#include <stdbool.h>
 // memory
 #include "heap.h"
+// process
+#include "queue.h"
+// sys
+#include "timer.h"
+#include "spinlock.h"
 // cpu
 #include "isr.h"
+#include "fpu.h"
 
 // Process state
 #define PROC_STATE_NEW 1
 #define PROC_STATE_RUNNING 2
 #define PROC_STATE_WAITING 3
 #define PROC_STATE_READY 4
+#define PROC_STATE_SLEEPING 5
 
 // Process priority
 #define PROC_PRIORITY_SYSTEM 0
@@ -23,42 +31,128 @@
 // Max memory pages that can be alloc for one process
 #define PROC_MAX_MEMORY_PAGES 20
 
+// Size in bytes of the kernel stack of each process
+#define PROC_KERNEL_STACK_SIZE 8192
+
+// Scheduler ticks a process runs in user mode before it's preempted
+#define PROC_TIMESLICE_TICKS 5
+
+/**
+ * @brief Kernel context saved by switch_to on the kernel stack of the process being switched out.
+ *        Only the callee-saved registers are saved, the others are already saved by the caller.
+ */
 typedef struct {
-    unsigned int EAX, EBX, ECX, EDX, ESP, EBP, ESI, EDI; // general registers
-    unsigned int EFLAGS;                                 // flags registers
-    unsigned int EIP;                                    // instruction pointer register
-    unsigned int CS, SS, ES, DS, FS, GS;                 // segment registers
-} __attribute__((packed)) SchedulerRegs;
+    unsigned int edi, esi, ebx, ebp;                    // callee-saved registers
+    unsigned int eip;                                   // return address of switch_to
+} __attribute__((packed)) SwitchFrame;
 
 typedef struct {
     char processName[32];                               // Process name
     unsigned char processState;                         // Process state
     unsigned int pid;                                   // Process id
     unsigned char priority;                             // Process priority
-    SchedulerRegs registers;                            // Process context state
+    unsigned int kernelESP;                             // Kernel stack pointer saved by switch_to
+    unsigned char* kernelStack;                         // Kernel stack, the user registers are saved on its top when the kernel is entered
+    IntRegisters* registers;                            // User registers saved by the last kernel entry (syscall or interrupt)
+    FpuState fpuState;                                  // FPU/SSE registers, saved and restored lazily
+    Queue* waitQueue;                                   // Wait queue where the process is blocked, NULL when not blocked
+    uint8_t cpu;                                        // Cpu where the process ran the last time, its ready queue
+    bool kernelThread;                                  // Runs only in ring 0, without user memory pages
+    uint8_t console;                                    // Virtual console of the process output and keyboard input (vga.h)
+    Timer sleepTimer;                                   // Wakes up the process sleeping in pit::sleep
     unsigned int memoryPages[PROC_MAX_MEMORY_PAGES];    // Addresses of process memory pages
     Heap processHeap;                                   // User process heap
 } PCB;
 
 typedef PCB* PID;
 
-extern "C" unsigned int kernelESP;
+/**
+ * @brief Save the kernel context of the current process in prevESP and continue the context saved in nextESP. Imported from context_switch.asm
+ * 
+ * @param prevESP   Where the current kernel stack pointer is saved
+ * @param nextESP   Kernel stack pointer of the next context
+ */
+extern "C" void switch_to(unsigned int* prevESP, unsigned int nextESP);
+
+/**
+ * @brief Entry point of a new process kernel stack. Pop the initial user registers and jump to ring 3. Imported from context_switch.asm
+ * 
+ */
+extern "C" void process_start();
+
+/**
+ * @brief Called by process_start before a new process jumps to ring 3. Releases the kernel lock taken by the cpu that switched to it.
+ * 
+ */
+extern "C" void scheduler_process_entry();
 
+/**
+ * @brief Entry point of a new kernel thread, called by switch_to with the thread function as argument.
+ * 
+ * @param entry Thread function
+ */
+extern "C" void scheduler_kthread_start(void (*entry)());
+
+/**
+ * @brief SCHEDULER - Process scheduler
+ * 
+ * RUN_QUEUES:
+ *    - Each cpu has its own ready queue, running process and idle context. A process is added to the ready queue of the
+ *      cpu where it ran the last time, so its cache lines and TLB entries are still warm when it's scheduled again.
+ *    - A new process is added to the ready queue of the cpu that created it.
+ *    - When a process is resumed and its cpu is busy, an idle cpu is woken up with the reschedule IPI.
+ *    - A cpu with an empty ready queue steals the first process of the longest ready queue before halting.
+ *
+ * KERNEL_THREADS:
+ *    - A kernel thread is scheduled as a process, but it runs a kernel function in ring 0 with the kernel lock held and
+ *      has no user memory. The memory switch is skipped, the pages of the previous process stay mapped.
+ *    - It isn't preempted when its time slice ends, it yields or blocks itself. E.g the worker threads (workqueue.h).
+ */
 namespace scheduler {
     /**
      * @brief Initialize process scheduler
      *        Initialize allProcesses queue
-     *        Initialize readyProcesses queue
+     *        Initialize the ready queue of each cpu
      *        Initialize waitingProcesses queue
      */
     void init();
 
     /**
-     * @brief Start process scheduler and execute the next ready program on the first ready queue position.
+     * @brief Start process scheduler on the running cpu. The caller becomes the idle context of the cpu and never returns.
+     *        Execute the next ready program on the first ready queue position, or halt the cpu until one is ready.
+     *        On the bootstrap processor the application processors are released.
      * 
      */
     void start();
 
+    /**
+     * @brief Switch to the next ready process. If no process is ready switch to the idle context.
+     *        The running process must already be in the ready queue or waiting for a resource.
+     *        Returns when the running process is scheduled again.
+     * 
+     */
+    void schedule();
+
+    /**
+     * @brief Put the running process back in the ready queue and switch to the next ready process.
+     * 
+     */
+    void yield();
+
+    /**
+     * @brief Scheduler tick, called by the per cpu timer interruption.
+     *        Asks for a reschedule when the running process used its time slice.
+     * 
+     */
+    void tick();
+
+    /**
+     * @brief Called before an interruption returns to user mode.
+     *        Switch to the next ready process when the running process used its time slice.
+     * 
+     */
+    void preempt();
+
     /**
      * @brief 
      * 
@@ -75,29 +169,23 @@ namespace scheduler {
     PID createProcess(const char* processName);
 
     /**
-     * @brief Resume the given Process Control Block
-     * 
-     * - Add process pid to ready queue.
-     * - Change process state to PROC_STATE_READY to be executed.
+     * @brief Create a new kernel thread. It must be resumed with scheduler::resumeProcess to start running.
      * 
-     * @param pid PCB* Process Control Block
+     * @param threadName    Name listed with the processes
+     * @param entry         Thread function, the thread is terminated if it returns
+     * @return PID          PCB of the thread, NULL if there's no memory
      */
-    void resumeProcess(PID pid);
+    PID createKernelThread(const char* threadName, void (*entry)());
 
     /**
-     * @brief Load the register with given Process Control Block information
+     * @brief Resume the given Process Control Block
      * 
-     * @param pid PCB* Process Control Block
-     */
-    void processLoadContext(PID pid);
-
-    /**
-     * @brief Save the Process Control Block to be resumed later
+     * - Add process pid to ready queue.
+     * - Change process state to PROC_STATE_READY to be executed.
      * 
      * @param pid PCB* Process Control Block
-     * @param regs Registers to be saved
      */
-    void processSaveContext(PID pid, IntRegisters* regs);
+    void resumeProcess(PID pid);
 
     /**
      * @brief Terminate process execution for given PID
@@ -106,28 +194,51 @@ namespace scheduler {
      * - Remove given process from all queue lists.
      * - Also release all page frames used by this process to be used by others. Reset all pages to unused.
      * - Also release memory dynamic allocated to this process PID = PCB*
+     * - If it's the running process its kernel stack is still in use, PCB and kernel stack are released after the next context switch.
      * 
      * @param pid PID = PCB*
      */
     void processTerminate(PID pid);
 
     /**
-     * @brief Process is asking for a keyboard input resource.
+     * @brief Block the running process on the given wait queue until it's woken up by scheduler::wakeUp.
+     *        Other processes are executed meanwhile. Must be called from a syscall or a kernel thread, with interruptions disabled,
+     *        so the condition being waited can't change between its check and the block.
      * 
-     * - Remove pid from ready queue.
-     * - Add pid to waiting queue.
-     * - Add pid to waitingKbdProcesses queue.
+     * - Change process state to PROC_STATE_WAITING or the given state.
+     * - Add pid to waiting queue and to the given wait queue.
+     * - Release the given lock, that protects the condition being waited.
+     * - Switch to the next ready process. Returns when the process is woken up and scheduled again.
      * 
-     * @param pid PID = PCB*
+     * @param waitQueue Queue of the processes waiting for the same event
+     * @param state     PROC_STATE_WAITING or PROC_STATE_SLEEPING
+     * @param lock      Lock held by the caller while it checked the condition, released once the process is in the wait queue,
+     *                  so a wake up from another cpu isn't lost. It isn't taken again on return. NULL when there's no lock
+     */
+    void block(Queue* waitQueue, unsigned char state = PROC_STATE_WAITING, Spinlock* lock = NULL);
+
+    /**
+     * @brief Wake up all processes blocked on the given wait queue. Can be called from an interruption handler.
+     * 
+     * @param waitQueue Queue of the processes waiting for the same event
      */
-    void kbdAskResource(PID pid);
+    void wakeUp(Queue* waitQueue);
 
     /**
-     * @brief Create a keyboard resource to be shared with process that requested keyboard input
+     * @brief Wake up the first process blocked on the given wait queue. Can be called from an interruption handler.
      * 
-     * @param kbdBuffer Buffer to be shared with the process
+     * @param waitQueue Queue of the processes waiting for the same event
+     * @return PID      Process woken up, NULL if no process was waiting
      */
-    void kbdCreateResource(char* kbdBuffer);
+    PID wakeUpOne(Queue* waitQueue);
+
+    /**
+     * @brief Wake up the given process if it's blocked on the given wait queue. Can be called from an interruption handler.
+     * 
+     * @param waitQueue Queue where the process is blocked
+     * @param pid       PID = PCB*
+     */
+    void wakeUpProcess(Queue* waitQueue, PID pid);
 
     /**
      * @brief Get the current Running Process
@@ -136,6 +247,26 @@ namespace scheduler {
      */
     PID getRunningProcess();
 
+    /**
+     * @brief Check that a buffer passed by a process lies inside its mapped memory pages, so a syscall can access it.
+     *        The process pages are mapped from the virtual address 0, see mapProcessMemory.
+     * 
+     * @param pid       PID = PCB*
+     * @param ptr       Start of the buffer, address in the process memory
+     * @param size      Bytes of the buffer
+     * @return true     Every byte of the buffer is in a page of the process
+     * @return false    The buffer wraps around, goes past the process memory or touches an unused page
+     */
+    bool isUserMemory(PID pid, const void* ptr, unsigned int size);
+
+    /**
+     * @brief Check if there is any process waiting in the ready queue to be executed
+     * 
+     * @return true  At least one process is ready
+     * @return false Ready queue is empty
+     */
+    bool hasReadyProcesses();
+
     /**
      * @brief Print the process list
      * 
@@ -0,0 +1,27 @@
+// stdlibs
+#include "format.h"
+
+int format::emit(stdlib::FormatSink sink, void* context, const char* format, const Segment* segments, uint32_t count,
+                 const uint32_t* words) {
+    int written = 0;
+    uint32_t value;
+    bool negative;
+
+    for (; count > 0; count--, segments++) {
+        if (segments->length > 0) {
+            sink(context, format + segments->text, segments->length);
+            written += segments->length;
+        }
+        if (segments->spec.specifier == 0) {
+            continue;                           // Text only, or %%
+        }
+        value = *words++;
+        if (segments->spec.specifier == 's') {
+            written += stdlib::formatString(sink, context, &segments->spec, (const char*) value);
+        } else {
+            negative = segments->isSigned && (int32_t) value < 0;    // Only set for %d and %i
+            written += stdlib::formatInteger(sink, context, &segments->spec, negative ? -value : value, negative);
+        }
+    }
+    return written;
+}
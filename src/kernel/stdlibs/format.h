@@ -0,0 +1,339 @@
+#pragma once
+#ifndef _FORMAT_H_
+#define _FORMAT_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+// stdlibs
+#include "stdlib.h"
+
+#define FORMAT_STEP_END 0                       // No format left in the string
+#define FORMAT_STEP_ESCAPE 1                    // %%, emits a % without argument
+#define FORMAT_STEP_ARG 2                       // Format of the next argument
+
+/**
+ * @brief FORMAT - Compile-time format strings, used by KPRINTF
+ *
+ *    - The format string is a literal returned by a constexpr function of a type, E.g the local struct declared by
+ *      KPRINTF, so it's parsed by the compiler, never at run time.
+ *    - format::Check compares the argument types with the specifiers, a mismatch is a static_assert error:
+ *          - d i u x X b c: integers up to 32 bits, bool and enums. 64 bits integers aren't supported
+ *          - s: char*, unsigned char* and their const
+ *          - x X: pointers too
+ *    - format::Program splits the string in segments, a text and the parsed options of the format after it. The table
+ *      is a constant of the call site, which only converts its arguments to 32 bits words.
+ *    - format::emit follows a table for every call site: one sink call per text and one stdlib::formatInteger or
+ *      stdlib::formatString call per argument. A table per call site instead of code per call site keeps the kernel
+ *      small, it's built without optimizations.
+ */
+namespace format {
+    enum ArgClass {
+        ARG_UNSUPPORTED,
+        ARG_INTEGER,
+        ARG_STRING,
+        ARG_POINTER
+    };
+
+    /**
+     * @brief Class of an argument type and its conversion to a 32 bits word, the size of a pointer
+     *
+     */
+    template<typename T, bool Enum = __is_enum(T)>
+    struct Arg {
+        static constexpr ArgClass kind = ARG_UNSUPPORTED;
+        static constexpr bool isSigned = false;
+    };
+
+    template<typename T>
+    struct Arg<T, true> {
+        static constexpr ArgClass kind = ARG_INTEGER;
+        static constexpr bool isSigned = true;
+        static uint32_t convert(T value) { return (uint32_t) value; }
+    };
+
+    template<typename T>
+    struct Arg<T*, false> {
+        static constexpr ArgClass kind = ARG_POINTER;
+        static constexpr bool isSigned = false;
+        static uint32_t convert(T* value) { return (uint32_t) value; }
+    };
+
+    template<>
+    struct Arg<char*, false> {
+        static constexpr ArgClass kind = ARG_STRING;
+        static constexpr bool isSigned = false;
+        static uint32_t convert(char* value) { return (uint32_t) value; }
+    };
+
+    template<>
+    struct Arg<const char*, false> {
+        static constexpr ArgClass kind = ARG_STRING;
+        static constexpr bool isSigned = false;
+        static uint32_t convert(const char* value) { return (uint32_t) value; }
+    };
+
+    template<>
+    struct Arg<unsigned char*, false> {
+        static constexpr ArgClass kind = ARG_STRING;
+        static constexpr bool isSigned = false;
+        static uint32_t convert(unsigned char* value) { return (uint32_t) value; }
+    };
+
+    template<>
+    struct Arg<const unsigned char*, false> {
+        static constexpr ArgClass kind = ARG_STRING;
+        static constexpr bool isSigned = false;
+        static uint32_t convert(const unsigned char* value) { return (uint32_t) value; }
+    };
+
+#define FORMAT_INTEGER_ARG(TYPE, SIGNED)                                        \
+    template<>                                                                  \
+    struct Arg<TYPE, false> {                                                   \
+        static constexpr ArgClass kind = ARG_INTEGER;                           \
+        static constexpr bool isSigned = SIGNED;                                \
+        static uint32_t convert(TYPE value) { return (uint32_t) value; }        \
+    };
+    FORMAT_INTEGER_ARG(bool, false)
+    FORMAT_INTEGER_ARG(char, true)
+    FORMAT_INTEGER_ARG(signed char, true)
+    FORMAT_INTEGER_ARG(unsigned char, false)
+    FORMAT_INTEGER_ARG(short, true)
+    FORMAT_INTEGER_ARG(unsigned short, false)
+    FORMAT_INTEGER_ARG(int, true)
+    FORMAT_INTEGER_ARG(unsigned int, false)
+    FORMAT_INTEGER_ARG(long, true)
+    FORMAT_INTEGER_ARG(unsigned long, false)
+#undef FORMAT_INTEGER_ARG
+
+    /**
+     * @brief Find the next format
+     *
+     * @param format        Format string
+     * @param pos           Position
+     * @return uint32_t     Position of the next %, or of the null terminator
+     */
+    constexpr uint32_t nextFormat(const char* format, uint32_t pos) {
+        while (format[pos] != 0 && format[pos] != '%') {
+            pos++;
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Get the step of a position returned by nextFormat
+     *
+     * @param format        Format string
+     * @param pos           Position
+     * @return uint32_t     FORMAT_STEP_END, FORMAT_STEP_ESCAPE or FORMAT_STEP_ARG
+     */
+    constexpr uint32_t stepAt(const char* format, uint32_t pos) {
+        return format[pos] == 0 ? FORMAT_STEP_END
+             : stdlib::parseFormatSpec(format, pos).specifier == '%' ? FORMAT_STEP_ESCAPE : FORMAT_STEP_ARG;
+    }
+
+    /**
+     * @brief Check whether a specifier accepts an argument class
+     *
+     * @param specifier     Specifier
+     * @param kind          Argument class
+     * @return true         Accepted
+     * @return false        Mismatch
+     */
+    constexpr bool accepts(char specifier, ArgClass kind) {
+        switch (kind) {
+            case ARG_INTEGER:
+                return specifier == 'd' || specifier == 'i' || specifier == 'u' || specifier == 'x' || specifier == 'X' ||
+                       specifier == 'b' || specifier == 'c';
+            case ARG_STRING:
+                return specifier == 's';
+            case ARG_POINTER:
+                return specifier == 'x' || specifier == 'X';
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief Compare the arguments with the formats of a string, one format per argument
+     *
+     */
+    template<typename... Args>
+    struct Check;
+
+    template<>
+    struct Check<> {
+        static constexpr bool matches(const char* format, uint32_t pos) {
+            for (pos = nextFormat(format, pos); format[pos] != 0; pos = nextFormat(format, pos)) {
+                if (stepAt(format, pos) != FORMAT_STEP_ESCAPE) {
+                    return false;                   // A format without argument
+                }
+                pos = stdlib::parseFormatSpec(format, pos).end;
+            }
+            return true;
+        }
+    };
+
+    template<typename T, typename... Rest>
+    struct Check<T, Rest...> {
+        static constexpr bool matches(const char* format, uint32_t pos) {
+            for (pos = nextFormat(format, pos); stepAt(format, pos) == FORMAT_STEP_ESCAPE; pos = nextFormat(format, pos)) {
+                pos = stdlib::parseFormatSpec(format, pos).end;
+            }
+            return format[pos] != 0 && accepts(stdlib::parseFormatSpec(format, pos).specifier, Arg<T>::kind) &&
+                   Check<Rest...>::matches(format, stdlib::parseFormatSpec(format, pos).end);
+        }
+    };
+
+    /**
+     * @brief Count the formats of a string, %% included
+     *
+     * @param format        Format string
+     * @return uint32_t     Formats
+     */
+    constexpr uint32_t formatCount(const char* format) {
+        uint32_t count = 0;
+        uint32_t pos = nextFormat(format, 0);
+
+        for (; format[pos] != 0; pos = nextFormat(format, stdlib::parseFormatSpec(format, pos).end)) {
+            count++;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Position of a format, %% included
+     *
+     * @param format        Format string
+     * @param index         Format
+     * @return uint32_t     Position of its %, or of the null terminator for the index formatCount
+     */
+    constexpr uint32_t formatAt(const char* format, uint32_t index) {
+        uint32_t pos = nextFormat(format, 0);
+
+        for (; format[pos] != 0 && index > 0; index--) {
+            pos = nextFormat(format, stdlib::parseFormatSpec(format, pos).end);
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Count the argument formats before a format
+     *
+     * @param format        Format string
+     * @param index         Format
+     * @return uint32_t     Index of its argument
+     */
+    constexpr uint32_t argIndex(const char* format, uint32_t index) {
+        uint32_t arg = 0;
+        uint32_t i = 0;
+
+        for (; i < index; i++) {
+            if (stepAt(format, formatAt(format, i)) == FORMAT_STEP_ARG) {
+                arg++;
+            }
+        }
+        return arg;
+    }
+
+    /**
+     * @brief Part of a format string: a text and the format that follows it. A %% is kept as the last char of the text
+     *        with no format, and the text after the last format has none either.
+     *
+     */
+    struct Segment {
+        uint16_t text;                          // Position of the text in the format string
+        uint16_t length;                        // Chars of the text
+        bool isSigned;                          // Argument of a signed type with %d or %i, printed with a minus sign when
+                                                // negative. The other specifiers print its 32 bits, like va_formatf
+        stdlib::FormatSpec spec;                // Format of the argument, specifier 0 when there's no argument
+    };
+
+    /**
+     * @brief Build a segment of a format string
+     *
+     * @param format        Format string
+     * @param index         Segment, from 0 to formatCount
+     * @param isSigned      Signedness of the argument types, one per argument. Only kept for %d and %i
+     * @return Segment      Segment
+     */
+    constexpr Segment segmentAt(const char* format, uint32_t index, const bool* isSigned) {
+        uint32_t from = index == 0 ? 0 : stdlib::parseFormatSpec(format, formatAt(format, index - 1)).end;
+        uint32_t at = formatAt(format, index);
+        Segment segment = { (uint16_t) from, (uint16_t) (at - from), false, { 0, false, false, 0, -1, at } };
+
+        if (stepAt(format, at) == FORMAT_STEP_ESCAPE) {
+            segment.length++;                   // The first % of %%
+        } else if (stepAt(format, at) == FORMAT_STEP_ARG) {
+            segment.spec = stdlib::parseFormatSpec(format, at);
+            segment.isSigned = (segment.spec.specifier == 'd' || segment.spec.specifier == 'i') &&
+                               isSigned[argIndex(format, index)];
+        }
+        return segment;
+    }
+
+    // A negative int is -1 with %d and %i, ffffffff with %x and 4294967295 with %u, as va_formatf prints it
+    constexpr bool signedArg[] = { true };
+    static_assert(segmentAt("%d", 0, signedArg).isSigned && segmentAt("%i", 0, signedArg).isSigned,
+                  "format: %d and %i must print the sign of a signed argument");
+    static_assert(!segmentAt("%x", 0, signedArg).isSigned && !segmentAt("%X", 0, signedArg).isSigned &&
+                  !segmentAt("%u", 0, signedArg).isSigned && !segmentAt("%b", 0, signedArg).isSigned &&
+                  !segmentAt("%c", 0, signedArg).isSigned,
+                  "format: %x %X %u %b and %c must print the 32 bits of a signed argument");
+
+    template<uint32_t... Index>
+    struct Indexes {
+    };
+
+    template<uint32_t Count, uint32_t... Index>
+    struct MakeIndexes : MakeIndexes<Count - 1, Count - 1, Index...> {
+    };
+
+    template<uint32_t... Index>
+    struct MakeIndexes<0, Index...> {
+        typedef Indexes<Index...> type;
+    };
+
+    template<typename Format, typename Indexes, typename... Args>
+    struct ProgramOf;
+
+    template<typename Format, uint32_t... Index, typename... Args>
+    struct ProgramOf<Format, Indexes<Index...>, Args...> {
+        static constexpr bool isSigned[] = { Arg<Args>::isSigned..., false };
+        static constexpr Segment segments[] = { segmentAt(Format::str(), Index, isSigned)... };
+    };
+
+    template<typename Format, uint32_t... Index, typename... Args>
+    constexpr bool ProgramOf<Format, Indexes<Index...>, Args...>::isSigned[];
+
+    template<typename Format, uint32_t... Index, typename... Args>
+    constexpr Segment ProgramOf<Format, Indexes<Index...>, Args...>::segments[];
+
+    /**
+     * @brief Segments of a format string, built by the compiler. One table in .rodata per call site.
+     *
+     * @tparam Format   Type with a constexpr str() that returns the format string
+     * @tparam Args     Argument types, checked by format::Check
+     */
+    template<typename Format, typename... Args>
+    struct Program : ProgramOf<Format, typename MakeIndexes<formatCount(Format::str()) + 1>::type, Args...> {
+        static constexpr uint32_t count = formatCount(Format::str()) + 1;
+    };
+
+    /**
+     * @brief Emit the text of a format string from its segments. Shared by all the call sites: it only follows the
+     *        table, the format string isn't parsed.
+     *
+     * @param sink      Sink called with each chunk of the text
+     * @param context   Passed to the sink
+     * @param format    Format string
+     * @param segments  Segments built by format::Program
+     * @param count     Segments
+     * @param words     Arguments converted by format::Arg, one per segment with a format
+     * @return int      Chars emitted
+     */
+    int emit(stdlib::FormatSink sink, void* context, const char* format, const Segment* segments, uint32_t count,
+             const uint32_t* words);
+}
+
+#endif
@@ -2,16 +2,9 @@
 #include <stdarg.h>
 // stdlibs
 #include "stdio.h"
-#include "stdlib.h"
-// drivers
-#include "vga.h"
-
-#define KPRINTF_STR_BUFFER_SIZE 2048
 
 void _kprintf(int foreColor, int bgColor, const char *str, va_list list) {
-    char formatedStr[KPRINTF_STR_BUFFER_SIZE];
-    stdlib::va_stringf(formatedStr, str, list);
-    vga::printStr(foreColor, bgColor, formatedStr);
+    klog::vwrite(vga::getOutputConsole(), foreColor, bgColor, str, list);
 }
 
 void stdio::kprintf(const char *str, ...) {
@@ -26,4 +19,24 @@ void stdio::kprintf(int foreColor, int bgColor, const char *str, ...) {
     va_start(list, str);
     _kprintf(foreColor, bgColor, str, list);
     va_end(list);
-}
\ No newline at end of file
+}
+void stdio::kprintSegments(int foreColor, int bgColor, const char* format, const format::Segment* segments,
+                           uint32_t count, const uint32_t* words) {
+    stdlib::FormatString string;
+    char* text;
+
+    string.dest = NULL;
+    string.capacity = 0;                        // Only counts
+    string.length = 0;
+    format::emit(stdlib::stringSink, &string, format, segments, count, words);
+
+    text = klog::reserve(vga::getOutputConsole(), foreColor, bgColor, string.length);
+    if (text == NULL) {
+        return;
+    }
+    string.dest = text;
+    string.capacity = (string.length < KLOG_MAX_TEXT ? string.length : KLOG_MAX_TEXT) + 1;
+    string.length = 0;
+    format::emit(stdlib::stringSink, &string, format, segments, count, words);
+    klog::commit(text);
+}
@@ -2,17 +2,81 @@
 #ifndef _STDIO_H_
 #define _STDIO_H_
 
-#define PANIC(str) stdio::kprintf(str); \
+// libc
+#include <stdint.h>
+// stdlibs
+#include "stdlib.h"
+#include "format.h"
+// drivers
+#include "vga.h"
+// sys
+#include "klog.h"
+
+#define PANIC(str) KPRINTF(str); \
     while(true){}
 
+/**
+ * @brief kprintf with a literal format checked at compile time. E.g: KPRINTF("%s - %d\n", name, value)
+ *        Arguments that don't match the format are a build error, and the format is never parsed at run time.
+ */
+#define KPRINTF(format, ...) KPRINTF_COLOR(VGA_DEF_FORECOLOR, VGA_DEF_BGCOLOR, format, ##__VA_ARGS__)
+
+/**
+ * @brief KPRINTF with colors. The local struct carries the literal to stdio::kprint as a type, one per call site.
+ */
+#define KPRINTF_COLOR(foreColor, bgColor, format, ...)                          \
+    do {                                                                        \
+        struct KprintfFormat {                                                  \
+            static constexpr const char* str() { return format; }               \
+        };                                                                      \
+        stdio::kprint<KprintfFormat>(foreColor, bgColor, ##__VA_ARGS__);        \
+    } while (false)
+
 /**
  * @brief Standard kernel input output utilities
- * 
+ *
  */
 namespace stdio {
+    /**
+     * @brief Print a format parsed at run time, for the formats that aren't literals. KPRINTF is checked at build time.
+     *
+     * @param str Format of stdlib::va_formatf
+     */
     void kprintf(const char* str, ...);
 
     void kprintf(int foreColor, int bgColor, const char* str, ...);
+
+    /**
+     * @brief Print the segments of a format in a kernel log record, on the console of the caller.
+     *        The text is measured by a first pass, then formatted straight in the reserved record by the second one.
+     *
+     * @param foreColor Text color
+     * @param bgColor   Background color
+     * @param format    Format string
+     * @param segments  Segments built by format::Program
+     * @param count     Segments
+     * @param words     Arguments converted by format::Arg
+     */
+    void kprintSegments(int foreColor, int bgColor, const char* format, const format::Segment* segments, uint32_t count,
+                        const uint32_t* words);
+
+    /**
+     * @brief Print a compile-time format. Called by KPRINTF.
+     *
+     * @tparam Format   Type with a constexpr str() that returns the format string
+     * @param foreColor Text color
+     * @param bgColor   Background color
+     * @param args      Arguments, checked against the format by format::Check
+     */
+    template<typename Format, typename... Args>
+    void kprint(int foreColor, int bgColor, Args... args) {
+        typedef format::Program<Format, Args...> Program;
+        uint32_t words[] = { format::Arg<Args>::convert(args)..., 0 };      // One more word, never empty
+
+        static_assert(format::Check<Args...>::matches(Format::str(), 0), "KPRINTF: the arguments don't match the format");
+
+        kprintSegments(foreColor, bgColor, Format::str(), Program::segments, Program::count, words);
+    }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -7,33 +7,143 @@
 #define X86_DIGITS 32
 #define X64_DIGITS 64
 
-#define VA_STR_BUFFER_SIZE 64
+#define FORMAT_NUMBER_BUFFER_SIZE X86_DIGITS    // Binary digits of a 32 bits number, the sign is emitted on its own
+#define FORMAT_PAD_CHUNK 16                     // Padding chars emitted at a time
+#define STRING_UNBOUNDED 0xFFFFFFFF             // Capacity of the destination of va_stringf
 
-unsigned long stdlib::ultoa(unsigned long value, unsigned char radix, char *str)  {
-	unsigned long written = 0;
-	unsigned int index;
-	unsigned char ch;
-	unsigned char buffer[X86_DIGITS];  /* space for X86_DIGITS + '\0' */
+// The two digits of each number 0 - 99 and 0x00 - 0xff, the conversions write two digits per division
+const char stdlibDecimalPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+const char stdlibHexPairs[] =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+const char stdlibZeros[FORMAT_PAD_CHUNK + 1] = "0000000000000000";
+const char stdlibSpaces[FORMAT_PAD_CHUNK + 1] = "                ";
 
-	index = X86_DIGITS;
+/**
+ * @brief Write the digits of a number backwards, ending at the end of a buffer. Decimal and hexadecimal numbers are
+ *        written two digits at a time from the digit pair tables.
+ *
+ * @param value     Number
+ * @param radix     Radix numeric base (E.g 10 = Decimal, 2 = Binary ...)
+ * @param end       End of the buffer, it must have room for X86_DIGITS digits
+ * @return char*    First digit
+ */
+char* stdlibFormatDigits(uint32_t value, uint8_t radix, char* end) {
+    uint32_t pair;
+    uint32_t digit;
 
-	do {
-		ch = '0' + (value % radix);
-		if ( ch > (unsigned char)'9') {
-			ch += 'a' - '9' - 1;
-		}
-        buffer[--index] = ch;
-        value /= radix;
-    } while (value != 0);
+    if (radix == 10) {
+        while (value >= 100) {
+            pair = (value % 100) * 2;
+            value /= 100;
+            *--end = stdlibDecimalPairs[pair + 1];
+            *--end = stdlibDecimalPairs[pair];
+        }
+        if (value >= 10) {
+            *--end = stdlibDecimalPairs[value * 2 + 1];
+            *--end = stdlibDecimalPairs[value * 2];
+        } else {
+            *--end = '0' + value;
+        }
+    } else if (radix == 16) {
+        while (value >= 0x100) {
+            pair = (value & 0xFF) * 2;
+            value >>= 8;
+            *--end = stdlibHexPairs[pair + 1];
+            *--end = stdlibHexPairs[pair];
+        }
+        *--end = stdlibHexPairs[value * 2 + 1];
+        if (value >= 0x10) {
+            *--end = stdlibHexPairs[value * 2];
+        }
+    } else {
+        do {
+            digit = value % radix;
+            *--end = digit < 10 ? '0' + digit : 'a' + digit - 10;
+            value /= radix;
+        } while (value != 0);
+    }
+    return end;
+}
 
-	do {
-		*str++ = buffer[index++];
-		written++;
-    } while (index < X86_DIGITS);
+/**
+ * @brief Emit a char repeated, in chunks of the padding strings
+ *
+ * @param sink      Sink
+ * @param context   Context of the sink
+ * @param pad       stdlibZeros or stdlibSpaces
+ * @param count     Chars
+ */
+void stdlibFormatPad(stdlib::FormatSink sink, void* context, const char* pad, uint32_t count) {
+    uint32_t chunk;
+
+    while (count > 0) {
+        chunk = count < FORMAT_PAD_CHUNK ? count : FORMAT_PAD_CHUNK;
+        sink(context, pad, chunk);
+        count -= chunk;
+    }
+}
 
-    *str = 0;  /* string terminator */
+/**
+ * @brief Emit a formatted field: the padding, the sign, the leading zeros and the text
+ *
+ * @param sink          Sink
+ * @param context       Context of the sink
+ * @param spec          Format of the field
+ * @param sign          '-' or 0 without sign
+ * @param zeros         Leading zeros of the precision
+ * @param text          Chars of the value
+ * @param length        Chars of the text
+ * @param zeroPad       The 0 flag applies, numbers without precision
+ * @return int          Chars emitted
+ */
+int stdlibFormatField(stdlib::FormatSink sink, void* context, const stdlib::FormatSpec* spec, char sign, uint32_t zeros,
+                      const char* text, uint32_t length, bool zeroPad) {
+    uint32_t padding;
 
-	return written;
+    padding = (sign != 0) + zeros + length;
+    padding = spec->width > padding ? spec->width - padding : 0;
+    if (zeroPad && spec->zeroPad && !spec->leftAlign) {     // Zeros between the sign and the digits
+        zeros += padding;
+        padding = 0;
+    }
+
+    if (!spec->leftAlign) {
+        stdlibFormatPad(sink, context, stdlibSpaces, padding);
+    }
+    if (sign != 0) {
+        sink(context, &sign, 1);
+    }
+    stdlibFormatPad(sink, context, stdlibZeros, zeros);
+    sink(context, text, length);
+    if (spec->leftAlign) {
+        stdlibFormatPad(sink, context, stdlibSpaces, padding);
+    }
+    return (sign != 0) + zeros + length + padding;
+}
+
+unsigned long stdlib::ultoa(unsigned long value, unsigned char radix, char *str)  {
+    char buffer[X86_DIGITS];
+    char* digit = stdlibFormatDigits(value, radix, buffer + X86_DIGITS);
+    unsigned long written = 0;
+
+    while (digit < buffer + X86_DIGITS) {
+        str[written++] = *digit++;
+    }
+    str[written] = 0;   /* string terminator */
+
+    return written;
 }
 
 long stdlib::ltoa(long value, unsigned char radix, char* str) {
@@ -100,99 +210,130 @@ int	stdlib::atoi(char *str) {
 	return (num * neg);
 }
 
-void appendStr(char* strDest, const char* strSrc, int* size, int length, int leadCount) {
-	int j;
-	if (length <= leadCount) {
-		(*size) -= length;
-	} else {
-		(*size) -= leadCount;
-	}
-	for(j=0; j<length; j++) {
-		*(strDest + *size) = *(strSrc + j);
-		(*size)++;
-	}
+void stdlib::stringSink(void* context, const char* chunk, uint32_t length) {
+    FormatString* string = (FormatString*) context;
+    uint32_t i;
+
+    for (i = 0; i < length && string->length + 1 < string->capacity; i++) {
+        string->dest[string->length++] = chunk[i];
+    }
+    string->length += length - i;
+}
+
+int stdlib::formatInteger(FormatSink sink, void* context, const FormatSpec* spec, uint32_t value, bool negative) {
+    char number[FORMAT_NUMBER_BUFFER_SIZE];
+    char* digit;
+    char* upper;
+    uint32_t length;
+    uint32_t zeros = 0;
+    uint8_t radix;
+
+    if (spec->specifier == 'c') {
+        number[0] = (char) value;
+        return stdlibFormatField(sink, context, spec, 0, 0, number, 1, false);
+    }
+
+    radix = spec->specifier == 'b' ? 2 : (spec->specifier == 'x' || spec->specifier == 'X' ? 16 : 10);
+    digit = stdlibFormatDigits(value, radix, number + FORMAT_NUMBER_BUFFER_SIZE);
+    length = number + FORMAT_NUMBER_BUFFER_SIZE - digit;
+    if (spec->specifier == 'X') {
+        for (upper = digit; upper < number + FORMAT_NUMBER_BUFFER_SIZE; upper++) {
+            if (*upper >= 'a') {
+                *upper -= 'a' - 'A';
+            }
+        }
+    }
+    if (spec->precision >= 0 && (uint32_t) spec->precision > length) {
+        zeros = spec->precision - length;
+    }
+    return stdlibFormatField(sink, context, spec, negative ? '-' : 0, zeros, digit, length, spec->precision < 0);
+}
+
+int stdlib::formatString(FormatSink sink, void* context, const FormatSpec* spec, const char* str) {
+    uint32_t length;
+
+    str = IFNULL(str, "(null)");
+    for (length = 0; str[length] != 0 && (spec->precision < 0 || length < (uint32_t) spec->precision); length++) {
+    }
+    return stdlibFormatField(sink, context, spec, 0, 0, str, length, false);
+}
+
+int stdlib::va_formatf(FormatSink sink, void* context, const char* strFormat, va_list list) {
+    const char* literal;
+    FormatSpec spec;
+    int32_t signedValue;
+    int written = 0;
+
+    while (*strFormat != 0) {
+        // The text until the next format is emitted as it is, without a copy
+        for (literal = strFormat; *strFormat != 0 && *strFormat != '%'; strFormat++) {
+        }
+        if (strFormat > literal) {
+            sink(context, literal, strFormat - literal);
+            written += strFormat - literal;
+        }
+        if (*strFormat == 0) {
+            break;
+        }
+
+        spec = parseFormatSpec(strFormat, 0);
+        switch (spec.specifier) {
+            case 's':
+                written += formatString(sink, context, &spec, va_arg(list, const char*));
+                break;
+            case 'd':
+            case 'i':
+                signedValue = va_arg(list, int);
+                written += formatInteger(sink, context, &spec, signedValue < 0 ? -(uint32_t) signedValue : signedValue, signedValue < 0);
+                break;
+            case 'c':
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'b':
+                written += formatInteger(sink, context, &spec, va_arg(list, unsigned int), false);
+                break;
+            case 0:                                 // A % at the end of the format
+                return written;
+            default:                                // %% and the unknown specifiers print the char
+                sink(context, &strFormat[spec.end - 1], 1);
+                written++;
+                break;
+        }
+        strFormat += spec.end;
+    }
+
+    return written;
 }
 
 int stdlib::va_stringf(char *strDest, const char* strFormat, va_list list) {
-	int i;
-	int size = 0;
-	char tempstr[VA_STR_BUFFER_SIZE];
-    char *pStr;
-	char tempchar;
-	int tempint;
-	int j;
-	int leadCount = 0;
-	int strFormatLen = string::strlen(strFormat);
-
-	for(i = 0; i < strFormatLen; i++) {
-		if(*(strFormat+i) == '%') {
-			i++;
-
-			if (*(strFormat+i) == '0') { // Leading zeros format found
-				j=0; // Reset one int var to use in leadNumStr offset index
-				i++;
-				for (; i < strFormatLen && *(strFormat+i) >= '0' && *(strFormat+i) <= '9'; i++) { // While numeric chars found read them
-					if (j < VA_STR_BUFFER_SIZE - 2) {
-						*(tempstr+j) = *(strFormat+i);
-					}
-					j++;
-				}
-				tempstr[j] = '\0';
-				leadCount = atoi(tempstr);
-
-				for (j=0; j<leadCount; j++) { // Adds zeroes to the string before the format
-					*(strDest + size) = '0';
-					size++;
-					// if (j % 10 == 0) {
-					// 	*(strDest + size) = ' ';
-					// 	size++;
-					// }
-				}
-			}
-
-
-			switch(*(strFormat+i)) {
-				case 's':
-					pStr = va_arg(list, char*);
-					for(j = 0; j < string::strlen(pStr); j++) {
-						*(strDest + size) = *(pStr + j);
-						size++;
-					}
-					break;
-				case 'c':
-					tempchar = va_arg(list, int);
-					*(strDest + size) = tempchar;
-					size++;
-					break;
-				case 'd':
-					tempint = va_arg(list, int);
-					j = stdlib::itoa(tempint, 10, tempstr);
-					appendStr(strDest, tempstr, &size, j, leadCount);
-                    break;
-				case 'x':
-					tempint = va_arg(list, int);
-					j = stdlib::itoa(tempint, 16, tempstr);
-					appendStr(strDest, tempstr, &size, j, leadCount);
-                    break;
-				case 'b':
-					tempint = va_arg(list, int);
-					j = stdlib::itoa(tempint, 2, tempstr);
-					appendStr(strDest, tempstr, &size, j, leadCount);
-                    break;
-				default:
-					*(strDest + size) = *(strFormat + i);
-					size++;
-					break;
-			}
-		} else {
-			// No format found print char by char
-			*(strDest + size) = *(strFormat + i);
-			size++;
-		}
-	}
+    return va_nstringf(strDest, STRING_UNBOUNDED, strFormat, list);
+}
+
+int stdlib::va_nstringf(char* strDest, uint32_t size, const char* strFormat, va_list list) {
+    FormatString string;
+
+    string.dest = strDest;
+    string.capacity = size;
+    string.length = 0;
+    va_formatf(stringSink, &string, strFormat, list);
+    if (size > 0) {
+        strDest[string.length < size ? string.length : size - 1] = 0;   // End of string NULL CHAR
+    }
+    return string.length;
+}
+
+uint64_t stdlib::udiv64(uint64_t dividend, uint32_t divisor, uint32_t* remainder) {
+    uint32_t high = (uint32_t) (dividend >> 32);
+    uint32_t low = (uint32_t) dividend;
+    uint32_t quotientHigh = high / divisor;
+    uint32_t quotientLow;
+    uint32_t rest = high % divisor;                 // rest < divisor, so the second quotient fits in 32 bits
 
-	// End of string NULL CHAR
-    strDest[size] = 0;
+    asm volatile("divl %4" : /* output */ "=a"(quotientLow), "=d"(rest) : /* input */ "a"(low), "d"(rest), "rm"(divisor));
 
-	return size;
+    if (remainder != NULL) {
+        *remainder = rest;
+    }
+    return ((uint64_t) quotientHigh << 32) | quotientLow;
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #define _STDLIB_H_
 
 #include <stdarg.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 /**
  * @brief Null definition
@@ -22,7 +24,10 @@
  * - itoa
  * - uitoa
  * - atoi
+ * - va_formatf
  * - va_stringf
+ * - va_nstringf
+ * - udiv64
  */
 namespace stdlib {
 
@@ -73,15 +78,145 @@ namespace stdlib {
      */
     int	atoi(char *str);
 
+    /**
+     * @brief Options of a format: %[-][0][width][.precision][l]specifier
+     * 
+     */
+    typedef struct {
+        char specifier;                 // 0 when the string ends before the specifier
+        bool leftAlign;                 // - flag, padded with spaces on the right
+        bool zeroPad;                   // 0 flag, numbers padded with zeros after the sign
+        uint32_t width;                 // Minimum chars of the field
+        int32_t precision;              // Minimum digits of a number or maximum chars of a string, -1 when it's not set
+        uint32_t end;                   // Position after the specifier
+    } FormatSpec;
+
+    /**
+     * @brief Destination of stringSink
+     * 
+     */
+    typedef struct {
+        char* dest;
+        uint32_t capacity;              // Bytes of dest, the null terminator included. 0 only counts the text
+        uint32_t length;                // Chars of the formatted text, the ones that didn't fit included
+    } FormatString;
+
+    /**
+     * @brief Parse the format at a position. constexpr, the compile-time formats of format.h use it too.
+     * 
+     * @param format        Format string
+     * @param pos           Position of the %
+     * @return FormatSpec   Options of the format
+     */
+    constexpr FormatSpec parseFormatSpec(const char* format, uint32_t pos) {
+        FormatSpec spec = {0, false, false, 0, -1, 0};
+
+        for (pos++;; pos++) {
+            if (format[pos] == '-') {
+                spec.leftAlign = true;
+            } else if (format[pos] == '0') {
+                spec.zeroPad = true;
+            } else {
+                break;
+            }
+        }
+        for (; format[pos] >= '0' && format[pos] <= '9'; pos++) {
+            spec.width = spec.width * 10 + (format[pos] - '0');
+        }
+        if (format[pos] == '.') {
+            for (spec.precision = 0, pos++; format[pos] >= '0' && format[pos] <= '9'; pos++) {
+                spec.precision = spec.precision * 10 + (format[pos] - '0');
+            }
+        }
+        while (format[pos] == 'l') {    // long and int are both 32 bits
+            pos++;
+        }
+        spec.specifier = format[pos];
+        spec.end = format[pos] != 0 ? pos + 1 : pos;
+        return spec;
+    }
+
+    /**
+     * @brief Receives the formatted text of va_formatf, chunk by chunk. The chunks aren't null terminated.
+     * 
+     */
+    typedef void (*FormatSink)(void* context, const char* chunk, uint32_t length);
+
+    /**
+     * @brief Format using va_args and stream the text to a sink, without an intermediate buffer. The text between the
+     *        formats is emitted as it is, the numbers are converted two digits at a time.
+     *        Formats: %[-][0][width][.precision][l]specifier, specifiers s c d i u x X b and %%
+     * 
+     * @param sink          Sink called with each chunk of the text
+     * @param context       Passed to the sink
+     * @param strFormat     Source string to format
+     * @param list          Infinite arguments
+     * @return int          The length of the formatted text
+     */
+    int va_formatf(FormatSink sink, void* context, const char* strFormat, va_list list);
+
+    /**
+     * @brief Sink that copies the chunks in a FormatString, truncated to its capacity. The text isn't null terminated.
+     * 
+     * @param context   FormatString
+     * @param chunk     Chars
+     * @param length    Chars of the chunk
+     */
+    void stringSink(void* context, const char* chunk, uint32_t length);
+
+    /**
+     * @brief Emit a number with the options of its format
+     * 
+     * @param sink          Sink
+     * @param context       Passed to the sink
+     * @param spec          Format, specifier c d i u x X or b
+     * @param value         Absolute value
+     * @param negative      Emit a - sign
+     * @return int          Chars emitted
+     */
+    int formatInteger(FormatSink sink, void* context, const FormatSpec* spec, uint32_t value, bool negative);
+
+    /**
+     * @brief Emit a string with the options of its format
+     * 
+     * @param sink          Sink
+     * @param context       Passed to the sink
+     * @param spec          Format, specifier s
+     * @param str           String, NULL is emitted as (null)
+     * @return int          Chars emitted
+     */
+    int formatString(FormatSink sink, void* context, const FormatSpec* spec, const char* str);
+
     /**
      * @brief Format a string using va_args
      * 
-     * @param strDest       Destination string buffer to store formatted string
+     * @param strDest       Destination string buffer to store formatted string, it must fit the whole text
      * @param strFormat     Source string to format
      * @param list          Infinite arguments
      * @return int          The length of the formatted string
      */
     int va_stringf(char *strDest, const char *strFormat, va_list list);
+
+    /**
+     * @brief Format a string using va_args, truncated to the size of the destination
+     * 
+     * @param strDest       Destination string buffer, can be NULL when size is 0
+     * @param size          Bytes of the destination, the null terminator included. 0 only measures the text
+     * @param strFormat     Source string to format
+     * @param list          Infinite arguments
+     * @return int          The length of the whole formatted string, it was truncated when it's >= size
+     */
+    int va_nstringf(char* strDest, uint32_t size, const char* strFormat, va_list list);
+
+    /**
+     * @brief Divide a 64 bits number by a 32 bits number. There is no libgcc, so the 64 bits division is done with two divl.
+     * 
+     * @param dividend      Dividend
+     * @param divisor       Divisor
+     * @param remainder     Remainder of the division, can be NULL
+     * @return uint64_t     Quotient
+     */
+    uint64_t udiv64(uint64_t dividend, uint32_t divisor, uint32_t* remainder);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,255 @@
+// stdlibs
+#include "stdlib.h"
+#include "string.h"
+// sys
+#include "acpi.h"
+
+#define ACPI_EBDA_SEGMENT_PTR 0x40E             // BDA word with the real mode segment of the EBDA
+#define ACPI_EBDA_SCAN_SIZE 1024                // Only the first KiB of the EBDA is searched
+#define ACPI_BIOS_AREA_START 0xE0000            // BIOS read only memory area searched for the RSDP
+#define ACPI_BIOS_AREA_END 0x100000
+#define ACPI_RSDP_ALIGN 16                      // The RSDP is always 16 bytes aligned
+#define ACPI_RSDP_V1_SIZE 20                    // Bytes of the ACPI 1.0 RSDP covered by its checksum
+
+#define MADT_LOCAL_APIC 0                       // MADT entry types
+#define MADT_IO_APIC 1
+#define MADT_IRQ_OVERRIDE 2
+#define MADT_LOCAL_APIC_ENABLED 0x1             // Local APIC entry flags Bit 0: processor enabled
+
+bool acpiAvailable;                             // ACPI tables found
+AcpiCpu acpiCpus[ACPI_MAX_CPUS];
+uint8_t acpiCpuCount;
+AcpiIoApic acpiIoApics[ACPI_MAX_IO_APICS];
+uint8_t acpiIoApicCount;
+AcpiIrqOverride acpiOverrides[ACPI_MAX_IRQ_OVERRIDES];
+uint8_t acpiOverrideCount;
+uint32_t acpiLocalApicAddress;
+uint32_t acpiHpetAddress;
+uint16_t acpiHpetMinimumTick;
+uint16_t acpiSciInterrupt;
+uint32_t acpiPmTimerPort;
+uint8_t acpiCenturyRegister;
+uint16_t acpiBootArchitectureFlags;
+
+/**
+ * @brief Sum the given bytes. A valid ACPI structure sums 0
+ *
+ * @param data      Structure address
+ * @param length    Structure size
+ * @return uint8_t  Sum of the bytes modulo 256
+ */
+uint8_t acpiChecksum(const void* data, uint32_t length) {
+    const uint8_t* bytes = (const uint8_t*) data;
+    uint8_t sum = 0;
+
+    for (uint32_t i = 0; i < length; i++) {
+        sum += bytes[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Search the RSDP in the given memory range
+ *
+ * @param start                 First address, 16 bytes aligned
+ * @param end                   First address after the range
+ * @return const AcpiRsdp*      RSDP with a valid checksum, NULL if not found
+ */
+const AcpiRsdp* findRsdp(uint32_t start, uint32_t end) {
+    for (uint32_t addr = start; addr < end; addr += ACPI_RSDP_ALIGN) {
+        const AcpiRsdp* rsdp = (const AcpiRsdp*) addr;
+        if (string::strncmp(rsdp->signature, "RSD PTR ", 8) == 0 && acpiChecksum(rsdp, ACPI_RSDP_V1_SIZE) == 0) {
+            return rsdp;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Keep the processors, I/O APICs and interrupt overrides of the MADT
+ *
+ * @param madt MADT
+ */
+void parseMadt(const AcpiMadt* madt) {
+    const uint8_t* entry = (const uint8_t*) madt + sizeof(AcpiMadt);
+    const uint8_t* end = (const uint8_t*) madt + madt->header.length;
+
+    acpiLocalApicAddress = madt->localApicAddress;
+
+    while (entry + 2 <= end && entry[1] >= 2) {  // Entry: type, length, data
+        switch (entry[0]) {
+            case MADT_LOCAL_APIC:               // processorId, apicId, flags (4 bytes)
+                if ((entry[4] & MADT_LOCAL_APIC_ENABLED) && acpiCpuCount < ACPI_MAX_CPUS) {
+                    acpiCpus[acpiCpuCount].processorId = entry[2];
+                    acpiCpus[acpiCpuCount].apicId = entry[3];
+                    acpiCpuCount++;
+                }
+                break;
+            case MADT_IO_APIC:                  // id, reserved, address (4 bytes), gsiBase (4 bytes)
+                if (acpiIoApicCount < ACPI_MAX_IO_APICS) {
+                    acpiIoApics[acpiIoApicCount].id = entry[2];
+                    acpiIoApics[acpiIoApicCount].address = *((const uint32_t*) (entry + 4));
+                    acpiIoApics[acpiIoApicCount].gsiBase = *((const uint32_t*) (entry + 8));
+                    acpiIoApicCount++;
+                }
+                break;
+            case MADT_IRQ_OVERRIDE:             // bus, source irq, gsi (4 bytes), flags (2 bytes)
+                if (acpiOverrideCount < ACPI_MAX_IRQ_OVERRIDES) {
+                    acpiOverrides[acpiOverrideCount].irq = entry[3];
+                    acpiOverrides[acpiOverrideCount].gsi = *((const uint32_t*) (entry + 4));
+                    acpiOverrides[acpiOverrideCount].flags = *((const uint16_t*) (entry + 8));
+                    acpiOverrideCount++;
+                }
+                break;
+            default:                            // NMI sources, local APIC NMIs, x2APIC entries... not used
+                break;
+        }
+        entry += entry[1];
+    }
+}
+
+/**
+ * @brief Keep the HPET address
+ *
+ * @param hpet HPET table
+ */
+void parseHpet(const AcpiHpet* hpet) {
+    if (hpet->addressSpaceId == 0 && (hpet->address >> 32) == 0) { // System memory below 4 GiB
+        acpiHpetAddress = (uint32_t) hpet->address;
+        acpiHpetMinimumTick = hpet->minimumTick;
+    }
+}
+
+/**
+ * @brief Keep the FADT fields used by the kernel
+ *
+ * @param fadt FADT
+ */
+void parseFadt(const AcpiFadt* fadt) {
+    acpiSciInterrupt = fadt->sciInterrupt;
+    acpiPmTimerPort = fadt->pmTimerLength == 4 ? fadt->pmTimerBlock : 0;
+    acpiCenturyRegister = fadt->century;
+    if (fadt->header.revision >= 2) {           // The boot flags are reserved in ACPI 1.0
+        acpiBootArchitectureFlags = fadt->bootArchitectureFlags;
+    }
+}
+
+uint8_t acpi::install() {
+    const AcpiRsdp* rsdp;
+    const AcpiSdtHeader* rsdt;
+    const AcpiSdtHeader* table;
+    uint32_t ebda;
+    uint32_t entries;
+
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    acpiAvailable = false;
+    acpiCpuCount = 0;
+    acpiIoApicCount = 0;
+    acpiOverrideCount = 0;
+    acpiLocalApicAddress = 0;
+    acpiHpetAddress = 0;
+    acpiHpetMinimumTick = 0;
+    acpiSciInterrupt = 0;
+    acpiPmTimerPort = 0;
+    acpiCenturyRegister = 0;
+    acpiBootArchitectureFlags = 0;
+
+    ebda = (uint32_t) *((const uint16_t*) ACPI_EBDA_SEGMENT_PTR) << 4;
+    rsdp = ebda != 0 ? findRsdp(ebda, ebda + ACPI_EBDA_SCAN_SIZE) : NULL;
+    if (rsdp == NULL) {
+        rsdp = findRsdp(ACPI_BIOS_AREA_START, ACPI_BIOS_AREA_END);
+    }
+    if (rsdp == NULL) {
+        return ACPI_ERROR_RSDP_NOT_FOUND;
+    }
+
+    rsdt = (const AcpiSdtHeader*) rsdp->rsdtAddress;
+    if (string::strncmp(rsdt->signature, "RSDT", 4) != 0 || acpiChecksum(rsdt, rsdt->length) != 0) {
+        return ACPI_ERROR_BAD_CHECKSUM;
+    }
+
+    entries = (rsdt->length - sizeof(AcpiSdtHeader)) / sizeof(uint32_t);
+    for (uint32_t i = 0; i < entries; i++) {
+        table = (const AcpiSdtHeader*) ((const uint32_t*) (rsdt + 1))[i];
+        if (acpiChecksum(table, table->length) != 0) {
+            continue;                           // Broken table, keep the defaults
+        }
+        if (string::strncmp(table->signature, "APIC", 4) == 0) {
+            parseMadt((const AcpiMadt*) table);
+        } else if (string::strncmp(table->signature, "HPET", 4) == 0) {
+            parseHpet((const AcpiHpet*) table);
+        } else if (string::strncmp(table->signature, "FACP", 4) == 0) {
+            parseFadt((const AcpiFadt*) table);
+        }
+    }
+
+    acpiAvailable = true;
+    return ACPI_NO_ERROR;
+}
+
+bool acpi::isAvailable() {
+    return acpiAvailable;
+}
+
+uint8_t acpi::getCpuCount() {
+    return acpiCpuCount;
+}
+
+const AcpiCpu* acpi::getCpu(uint8_t index) {
+    return index < acpiCpuCount ? &acpiCpus[index] : NULL;
+}
+
+uint32_t acpi::getLocalApicAddress() {
+    return acpiLocalApicAddress;
+}
+
+uint8_t acpi::getIoApicCount() {
+    return acpiIoApicCount;
+}
+
+const AcpiIoApic* acpi::getIoApic(uint8_t index) {
+    return index < acpiIoApicCount ? &acpiIoApics[index] : NULL;
+}
+
+uint32_t acpi::irqToGsi(uint8_t irq, uint16_t* flags) {
+    for (uint8_t i = 0; i < acpiOverrideCount; i++) {
+        if (acpiOverrides[i].irq == irq) {
+            if (flags != NULL) {
+                *flags = acpiOverrides[i].flags;
+            }
+            return acpiOverrides[i].gsi;
+        }
+    }
+    if (flags != NULL) {
+        *flags = 0;
+    }
+    return irq;                                 // ISA IRQs are identity mapped when not overridden
+}
+
+bool acpi::hasHpet() {
+    return acpiHpetAddress != 0;
+}
+
+uint32_t acpi::getHpetAddress() {
+    return acpiHpetAddress;
+}
+
+uint16_t acpi::getHpetMinimumTick() {
+    return acpiHpetMinimumTick;
+}
+
+uint16_t acpi::getSciInterrupt() {
+    return acpiSciInterrupt;
+}
+
+uint32_t acpi::getPmTimerPort() {
+    return acpiPmTimerPort;
+}
+
+uint8_t acpi::getCenturyRegister() {
+    return acpiCenturyRegister;
+}
+
+uint16_t acpi::getBootArchitectureFlags() {
+    return acpiBootArchitectureFlags;
+}
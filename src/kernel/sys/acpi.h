@@ -0,0 +1,285 @@
+#pragma once
+#ifndef _ACPI_H_
+#define _ACPI_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ACPI_NO_ERROR 0
+#define ACPI_ERROR_RSDP_NOT_FOUND 1             // No RSDP in the EBDA or in the BIOS read only area
+#define ACPI_ERROR_BAD_CHECKSUM 2               // RSDP or RSDT checksum mismatch, the tables are ignored
+
+#define ACPI_MAX_CPUS 16                        // Enabled processors kept from the MADT
+#define ACPI_MAX_IO_APICS 4                     // I/O APICs kept from the MADT
+#define ACPI_MAX_IRQ_OVERRIDES 16               // Interrupt source overrides kept from the MADT
+
+#define ACPI_INTI_POLARITY_MASK 0x3             // MPS INTI flags Bits 1-0: 00 bus default, 01 active high, 11 active low
+#define ACPI_INTI_POLARITY_LOW 0x3
+#define ACPI_INTI_TRIGGER_MASK 0xC              // MPS INTI flags Bits 3-2: 00 bus default, 01 edge, 11 level
+#define ACPI_INTI_TRIGGER_LEVEL 0xC
+
+/**
+ * @brief Root System Description Pointer. Found by scanning the first KiB of the EBDA and the BIOS area 0xE0000 - 0xFFFFF
+ *
+ */
+typedef struct {
+    char signature[8];                          // "RSD PTR ", 16 bytes aligned
+    uint8_t checksum;                           // Sum of the first 20 bytes is 0
+    char oemId[6];
+    uint8_t revision;                           // 0 = ACPI 1.0, 2 = ACPI 2.0+ (the XSDT fields are valid)
+    uint32_t rsdtAddress;                       // Physical address of the RSDT
+    uint32_t length;                            // ACPI 2.0+ - Size of the whole structure
+    uint64_t xsdtAddress;                       // ACPI 2.0+ - Physical address of the XSDT
+    uint8_t extendedChecksum;                   // ACPI 2.0+ - Sum of the whole structure is 0
+    uint8_t reserved[3];
+} __attribute__((packed)) AcpiRsdp;
+
+/**
+ * @brief Header of every System Description Table
+ *
+ */
+typedef struct {
+    char signature[4];                          // "RSDT", "APIC" (MADT), "HPET", "FACP" (FADT) ...
+    uint32_t length;                            // Size of the table including the header
+    uint8_t revision;
+    uint8_t checksum;                           // Sum of the whole table is 0
+    char oemId[6];
+    char oemTableId[8];
+    uint32_t oemRevision;
+    uint32_t creatorId;
+    uint32_t creatorRevision;
+} __attribute__((packed)) AcpiSdtHeader;
+
+/**
+ * @brief Multiple APIC Description Table. Followed by variable length entries starting with type and length
+ *
+ */
+typedef struct {
+    AcpiSdtHeader header;
+    uint32_t localApicAddress;                  // Physical address of the local APICs registers
+    uint32_t flags;                             // Bit 0: The system also has 8259 PICs
+} __attribute__((packed)) AcpiMadt;
+
+/**
+ * @brief HPET Description Table
+ *
+ */
+typedef struct {
+    AcpiSdtHeader header;
+    uint32_t eventTimerBlockId;                 // Copy of the HPET capabilities: vendor, comparators count, counter size
+    uint8_t addressSpaceId;                     // 0 = System memory
+    uint8_t registerBitWidth;
+    uint8_t registerBitOffset;
+    uint8_t reserved;
+    uint64_t address;                           // Physical address of the HPET registers
+    uint8_t hpetNumber;                         // Sequence number of this HPET
+    uint16_t minimumTick;                       // Minimum count of a periodic comparator without losing interruptions
+    uint8_t pageProtection;
+} __attribute__((packed)) AcpiHpet;
+
+/**
+ * @brief Fixed ACPI Description Table. Only the ACPI 1.0 fields used by the kernel
+ *
+ */
+typedef struct {
+    AcpiSdtHeader header;
+    uint32_t firmwareCtrl;                      // Physical address of the FACS
+    uint32_t dsdt;                              // Physical address of the DSDT
+    uint8_t reserved1;
+    uint8_t preferredPmProfile;
+    uint16_t sciInterrupt;                      // ISA IRQ of the System Control Interrupt
+    uint32_t smiCommandPort;
+    uint8_t acpiEnable;
+    uint8_t acpiDisable;
+    uint8_t s4biosReq;
+    uint8_t pstateControl;
+    uint32_t pm1aEventBlock;
+    uint32_t pm1bEventBlock;
+    uint32_t pm1aControlBlock;
+    uint32_t pm1bControlBlock;
+    uint32_t pm2ControlBlock;
+    uint32_t pmTimerBlock;                      // I/O port of the ACPI power management timer (3.579545 MHz)
+    uint32_t gpe0Block;
+    uint32_t gpe1Block;
+    uint8_t pm1EventLength;
+    uint8_t pm1ControlLength;
+    uint8_t pm2ControlLength;
+    uint8_t pmTimerLength;                      // 4 when the PM timer is present
+    uint8_t gpe0Length;
+    uint8_t gpe1Length;
+    uint8_t gpe1Base;
+    uint8_t cstControl;
+    uint16_t worstC2Latency;
+    uint16_t worstC3Latency;
+    uint16_t flushSize;
+    uint16_t flushStride;
+    uint8_t dutyOffset;
+    uint8_t dutyWidth;
+    uint8_t dayAlarm;
+    uint8_t monthAlarm;
+    uint8_t century;                            // CMOS RTC century register, 0 if not supported
+    uint16_t bootArchitectureFlags;             // IA-PC boot flags. Bit 1: 8042 PS/2 controller present
+    uint8_t reserved2;
+    uint32_t flags;                             // Bit 8: The PM timer is 32 bits long (24 bits otherwise)
+} __attribute__((packed)) AcpiFadt;
+
+/**
+ * @brief Enabled processor reported by the MADT
+ *
+ */
+typedef struct {
+    uint8_t processorId;                        // ACPI processor id
+    uint8_t apicId;                             // Local APIC id, used as the INIT and SIPI destination
+} AcpiCpu;
+
+/**
+ * @brief I/O APIC reported by the MADT
+ *
+ */
+typedef struct {
+    uint8_t id;                                 // I/O APIC id
+    uint32_t address;                           // Physical address of its registers
+    uint32_t gsiBase;                           // First global system interrupt handled by its pins
+} AcpiIoApic;
+
+/**
+ * @brief ISA IRQ that isn't identity mapped to a global system interrupt
+ *
+ */
+typedef struct {
+    uint8_t irq;                                // ISA IRQ (source)
+    uint32_t gsi;                               // Global system interrupt
+    uint16_t flags;                             // MPS INTI flags: polarity and trigger mode
+} AcpiIrqOverride;
+
+/**
+ * @brief ACPI - Advanced Configuration and Power Interface tables
+ *
+ * DISCOVERY:
+ *    - The RSDP is searched on 16 bytes boundaries in the first KiB of the EBDA (segment at 0x40E) and in 0xE0000 - 0xFFFFF.
+ *    - The RSDP points to the RSDT, an array of 32 bits physical addresses of the other tables.
+ *    - Every table starts with a header with its signature and length, and its bytes sum 0.
+ *
+ * PARSED_TABLES:
+ *    - MADT ("APIC"): Processors, I/O APICs and the ISA interrupt overrides (E.g IRQ0 -> GSI 2).
+ *    - HPET ("HPET"): Address of the High Precision Event Timer.
+ *    - FADT ("FACP"): SCI interrupt, PM timer port, century register and boot flags.
+ *
+ * The tables are only read by acpi::install, before paging is enabled, so they are accessed at their physical address.
+ * Everything used later is copied.
+ */
+namespace acpi {
+    /**
+     * @brief Find the ACPI tables and keep the platform configuration. Must be called before paging::install.
+     *
+     * @return uint8_t Error code: ACPI_NO_ERROR, ACPI_ERROR_RSDP_NOT_FOUND or ACPI_ERROR_BAD_CHECKSUM
+     */
+    uint8_t install();
+
+    /**
+     * @brief Return whether the ACPI tables were found or not
+     *
+     * @return true  Query functions return firmware values
+     * @return false Query functions return the defaults
+     */
+    bool isAvailable();
+
+    /**
+     * @brief Get the enabled processors count
+     *
+     * @return uint8_t Processors reported by the MADT, 0 without MADT
+     */
+    uint8_t getCpuCount();
+
+    /**
+     * @brief Get an enabled processor
+     *
+     * @param index             0 to getCpuCount() - 1
+     * @return const AcpiCpu*   Processor, NULL if the index is out of range
+     */
+    const AcpiCpu* getCpu(uint8_t index);
+
+    /**
+     * @brief Get the local APIC physical address reported by the MADT
+     *
+     * @return uint32_t Address, 0 without MADT
+     */
+    uint32_t getLocalApicAddress();
+
+    /**
+     * @brief Get the I/O APICs count
+     *
+     * @return uint8_t I/O APICs reported by the MADT
+     */
+    uint8_t getIoApicCount();
+
+    /**
+     * @brief Get an I/O APIC
+     *
+     * @param index                 0 to getIoApicCount() - 1
+     * @return const AcpiIoApic*    I/O APIC, NULL if the index is out of range
+     */
+    const AcpiIoApic* getIoApic(uint8_t index);
+
+    /**
+     * @brief Get the global system interrupt of an ISA IRQ, applying the MADT interrupt source overrides
+     *
+     * @param irq           ISA IRQ
+     * @param flags         MPS INTI flags of the override, 0 (ISA default: edge, active high) when not overridden. Can be NULL
+     * @return uint32_t     Global system interrupt
+     */
+    uint32_t irqToGsi(uint8_t irq, uint16_t* flags);
+
+    /**
+     * @brief Return whether the platform has an HPET or not
+     *
+     * @return true  HPET table found
+     * @return false No HPET
+     */
+    bool hasHpet();
+
+    /**
+     * @brief Get the HPET registers physical address
+     *
+     * @return uint32_t Address, 0 without HPET
+     */
+    uint32_t getHpetAddress();
+
+    /**
+     * @brief Get the minimum count of an HPET periodic comparator
+     *
+     * @return uint16_t Minimum tick
+     */
+    uint16_t getHpetMinimumTick();
+
+    /**
+     * @brief Get the System Control Interrupt
+     *
+     * @return uint16_t ISA IRQ, 0 without FADT
+     */
+    uint16_t getSciInterrupt();
+
+    /**
+     * @brief Get the ACPI power management timer I/O port
+     *
+     * @return uint32_t Port, 0 if not present
+     */
+    uint32_t getPmTimerPort();
+
+    /**
+     * @brief Get the CMOS RTC century register
+     *
+     * @return uint8_t Register index, 0 if not supported
+     */
+    uint8_t getCenturyRegister();
+
+    /**
+     * @brief Get the IA-PC boot architecture flags of the FADT
+     *
+     * @return uint16_t Flags, 0 without FADT
+     */
+    uint16_t getBootArchitectureFlags();
+}
+
+#endif
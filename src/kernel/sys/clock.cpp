@@ -0,0 +1,83 @@
+// stdlibs
+#include "stdlib.h"
+// legacy drivers
+#include "pit.h"
+// cpu
+#include "cpuid.h"
+#include "tsc.h"
+// sys
+#include "timer.h"
+#include "clock.h"
+
+bool clockHasTsc;                                       // The monotonic time is measured with the TSC
+uint32_t clockTscKhz;                                   // Calibrated TSC frequency
+uint32_t clockMult;                                     // ns = (cycles * clockMult) >> clockShift
+uint32_t clockShift;
+uint64_t clockBootTsc;                                  // TSC value at clock::install
+
+uint8_t clock::install() {
+    uint32_t cycles;
+    uint32_t minCycles = 0xFFFFFFFF;
+
+    clockHasTsc = false;
+    clockTscKhz = 0;
+    clockMult = 0;
+    clockShift = 0;
+    clockBootTsc = 0;
+
+    if (!cpuid::hasTsc()) {
+        return CLOCK_ERROR_TSC_NOT_PRESENT;
+    }
+
+    for (int i = 0; i < CLOCK_CALIBRATE_RUNS; i++) {
+        cycles = pit::measureTsc(CLOCK_CALIBRATE_COUNT);
+        if (cycles < minCycles) {
+            minCycles = cycles;
+        }
+    }
+    clockTscKhz = (uint32_t) stdlib::udiv64((uint64_t) minCycles * PIT_CRYSTAL_FREQUENCY, CLOCK_CALIBRATE_COUNT * 1000, NULL);
+
+    // Greatest shift that keeps mult = (1000000 << shift) / khz in 32 bits
+    clockShift = 32;
+    while (clockShift > 0 && ((1000000ULL << clockShift) >> 32) >= clockTscKhz) {
+        clockShift--;
+    }
+    clockMult = (uint32_t) stdlib::udiv64(1000000ULL << clockShift, clockTscKhz, NULL);
+
+    clockHasTsc = true;
+    clockBootTsc = tsc::read();
+    return CLOCK_NO_ERROR;
+}
+
+uint32_t clock::getTscKhz() {
+    return clockTscKhz;
+}
+
+uint64_t clock::cyclesToNs(uint64_t cycles) {
+    if (!clockHasTsc) {
+        return 0;
+    }
+    // (cycles * mult) >> shift is 96 bits wide, multiply each half separately
+    uint64_t hi = (uint64_t) (uint32_t) (cycles >> 32) * clockMult;
+    uint64_t lo = (uint64_t) (uint32_t) cycles * clockMult;
+
+    return (hi << (32 - clockShift)) + (lo >> clockShift);
+}
+
+uint64_t clock::monotonicNs() {
+    if (clockHasTsc) {
+        return clock::cyclesToNs(tsc::read() - clockBootTsc);
+    }
+    return (uint64_t) timer::getTicks() * pit::getTickPeriodNs();
+}
+
+bool clock::getTime(uint32_t clockId, Timespec* ts) {
+    uint32_t nsec;
+
+    if (clockId != CLOCK_MONOTONIC) {
+        return false;
+    }
+    ts->tv_sec = (uint32_t) stdlib::udiv64(clock::monotonicNs(), 1000000000, &nsec);
+    ts->tv_nsec = nsec;
+    return true;
+}
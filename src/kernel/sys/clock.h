@@ -0,0 +1,80 @@
+#pragma once
+#ifndef _CLOCK_H_
+#define _CLOCK_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CLOCK_NO_ERROR 0
+#define CLOCK_ERROR_TSC_NOT_PRESENT 1                   // Monotonic time falls back to the timer ticks resolution
+
+#define CLOCK_CALIBRATE_COUNT 11932                     // PIT clocks measured by each calibration run (10 ms)
+#define CLOCK_CALIBRATE_RUNS 3                          // The shortest run is used, longer runs were delayed by SMIs or the emulator
+
+#define CLOCK_MONOTONIC 1                               // Clock id of clock_gettime. Time since boot, never goes backwards
+
+/**
+ * @brief Time split in seconds and nanoseconds. Same layout as the Timespec of the user library sysfuncs.h
+ * 
+ */
+typedef struct {
+    uint32_t tv_sec;                                    // Seconds
+    uint32_t tv_nsec;                                   // Nanoseconds, 0 to 999999999
+} Timespec;
+
+/**
+ * @brief CLOCK - High resolution monotonic clock
+ * 
+ * TSC_CALIBRATION:
+ *    - The TSC frequency is unknown, it's measured at boot counting the TSC cycles elapsed while the PIT channel 2 counts down 10 ms.
+ *    - The PIT crystal frequency (1193182 hz) is fixed, so the frequency is khz = cycles * 1193182 / (count * 1000).
+ * 
+ * CYCLES_TO_NANOSECONDS:
+ *    - There is no 64 bits division, cycles are converted with a multiply and a shift: ns = (cycles * mult) >> shift.
+ *    - mult = (1000000 << shift) / khz, the shift is the greatest one that keeps mult in 32 bits.
+ * 
+ * Without a TSC the time has the resolution of the timer ticks.
+ */
+namespace clock {
+    /**
+     * @brief Calibrate the TSC against the PIT and start the monotonic clock
+     * 
+     * @return uint8_t Error code: CLOCK_NO_ERROR or CLOCK_ERROR_TSC_NOT_PRESENT
+     */
+    uint8_t install();
+
+    /**
+     * @brief Get the calibrated TSC frequency
+     * 
+     * @return uint32_t TSC frequency in khz, 0 if there is no TSC
+     */
+    uint32_t getTscKhz();
+
+    /**
+     * @brief Convert TSC cycles into nanoseconds
+     * 
+     * @param cycles        TSC cycles
+     * @return uint64_t     Nanoseconds, 0 if there is no TSC
+     */
+    uint64_t cyclesToNs(uint64_t cycles);
+
+    /**
+     * @brief Get the monotonic time
+     * 
+     * @return uint64_t Nanoseconds since clock::install
+     */
+    uint64_t monotonicNs();
+
+    /**
+     * @brief Get the time of the given clock
+     * 
+     * @param clockId   Clock id, only CLOCK_MONOTONIC is supported
+     * @param ts        Filled with the time
+     * @return true     Time returned
+     * @return false    Unsupported clock id
+     */
+    bool getTime(uint32_t clockId, Timespec* ts);
+}
+
+#endif
@@ -11,12 +11,14 @@
 #include "fat.h"
 // binaries programs
 #include "../../../build/programs/user/shell/shell.bin.h"
+#include "../../../build/programs/user/spin/spin.bin.h"
 
 #include "fs.h"
 
 // ==================== VIRTUAL FILE SYSTEM =========================
 FileNode fileList[] = {
-    { "shell.exe", shell_bin_len, shell_bin }
+    { "shell.exe", shell_bin_len, shell_bin },
+    { "spin.exe", spin_bin_len, spin_bin }
 };
 
 const unsigned int filesCount = sizeof(fileList) / sizeof(FileNode);
@@ -42,5 +44,5 @@ FileNode* fs::findFile(const char* fileName) {
 // ==================== VIRTUAL FILE SYSTEM =========================
 
 void fs::test() {
-    stdio::kprintf("FS - test");
+    KPRINTF("FS - test");
 }
\ No newline at end of file
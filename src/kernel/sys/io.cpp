@@ -20,6 +20,16 @@ void io::outw(uint16_t port, uint16_t value) {
 	__asm__ __volatile__("out %%ax, %%dx" : : "a"(value), "d"(port));
 }
 
+uint32_t io::inl(uint16_t port) {
+	uint32_t value;
+	__asm__ __volatile__("in %%dx, %%eax" : "=a"(value) : "d"(port));
+	return value;
+}
+
+void io::outl(uint16_t port, uint32_t value) {
+	__asm__ __volatile__("out %%eax, %%dx" : : "a"(value), "d"(port));
+}
+
 void io::wait() {
 	outb(0x80, 0);
 }
\ No newline at end of file
@@ -45,6 +45,22 @@ namespace io {
      */
     void outw(uint16_t port, uint16_t value);
 
+    /**
+     * @brief Read double word value from given port address.
+     * 
+     * @param port Port address to read
+     * @return uint32_t Value readed
+     */
+    uint32_t inl(uint16_t port);
+
+    /**
+     * @brief Write double word value to given port address.
+     * 
+     * @param port Port address to write
+     * @param value Double word value to write
+     */
+    void outl(uint16_t port, uint32_t value);
+
     /**
      * @brief IO_WAIT Wait a very small amount of time (1 to 4 microseconds, generally). 
      * Useful for implementing a small delay for PIC remapping on old hardware or generally as a simple but imprecise wait.
@@ -0,0 +1,398 @@
+// stdlibs
+#include "stdlib.h"
+// cpu
+#include "smp.h"
+#include "tsc.h"
+// memory
+#include "memutils.h"
+// drivers
+#include "vga.h"
+// sys
+#include "clock.h"
+#include "softirq.h"
+#include "workqueue.h"
+#include "klog.h"
+
+#define KLOG_ALIGN 8                            // Record size granularity, a padding record always has room for size, state and position
+#define KLOG_STATE_RESERVED 0                   // Space reserved, the text is being written
+#define KLOG_STATE_COMMITTED 1                  // Complete record
+#define KLOG_STATE_PADDING 2                    // Unused end of the ring, skipped
+
+#define KLOG_NOT_DRAINING 0
+#define KLOG_DRAINING 1
+
+/**
+ * @brief Header of a record in the ring, followed by the text and its null terminator
+ *
+ */
+typedef struct {
+    uint16_t size;                              // Bytes of the record, header and alignment included
+    volatile uint8_t state;                     // KLOG_STATE_RESERVED, KLOG_STATE_COMMITTED or KLOG_STATE_PADDING
+    uint8_t console;                            // Console the text is written on
+    uint32_t position;                          // Offset of the record when it was reserved, identifies the lap of the ring
+    uint8_t foreColor;
+    uint8_t bgColor;
+    uint8_t cpu;                                // Cpu that wrote the record
+    uint8_t reserved;
+    uint64_t tsc;                               // TSC when the record was reserved
+} KlogRecord;
+
+uint8_t klogBuffer[KLOG_BUFFER_SIZE] __attribute__((aligned(KLOG_ALIGN)));
+volatile uint32_t klogHead;                     // Offset of the next reservation. The offsets only grow, the ring index is offset % KLOG_BUFFER_SIZE
+volatile uint32_t klogDrained;                  // Offset of the first record not written on the console yet
+volatile uint32_t klogFirst;                    // Offset of the oldest record kept in the ring
+volatile uint32_t klogDraining;                 // KLOG_DRAINING while a cpu runs klog::drain
+volatile uint32_t klogDropped;
+uint64_t klogBootTsc;                           // TSC at klog::install, the timestamps are relative to it
+Tasklet klogDrainTasklet;                       // Scheduled by the timer ticks when records are waiting
+Work klogDrainWork;                             // Drains the ring in a worker thread
+
+// ===================== PRIVATE =======================
+
+/**
+ * @brief Atomically add a value to a counter
+ *
+ * @param counter       Counter
+ * @param value         Value added
+ * @return uint32_t     Counter before the addition
+ */
+uint32_t klogFetchAdd(volatile uint32_t* counter, uint32_t value) {
+    asm volatile("lock xaddl %0, %1" : /* output */ "+r"(value), "+m"(*counter) : /* input */ : /* clobbers */ "memory");
+    return value;
+}
+
+/**
+ * @brief Atomically replace an offset if it didn't change
+ *
+ * @param offset    Offset
+ * @param expected  Offset read before
+ * @param value     New offset
+ * @return true     Replaced
+ * @return false    A nested writer or another cpu changed it meanwhile
+ */
+bool klogCompareExchange(volatile uint32_t* offset, uint32_t expected, uint32_t value) {
+    uint32_t previous;
+
+    asm volatile("lock cmpxchgl %2, %1" : /* output */ "=a"(previous), "+m"(*offset) : /* input */ "r"(value), "0"(expected) : /* clobbers */ "memory");
+    return previous == expected;
+}
+
+/**
+ * @brief Get the record at an offset
+ *
+ * @param offset        Offset of the record
+ * @return KlogRecord*  Record in the ring
+ */
+KlogRecord* klogRecordAt(uint32_t offset) {
+    return (KlogRecord*) &klogBuffer[offset % KLOG_BUFFER_SIZE];
+}
+
+/**
+ * @brief Forget the oldest records until a limit, their space is reused by a new reservation. They are already drained.
+ *
+ * @param limit Offset the oldest kept record must start at or after
+ */
+void klogForget(uint32_t limit) {
+    uint32_t first;
+
+    while ((int32_t) (limit - (first = klogFirst)) > 0) {
+        // A nested writer can forget the same record meanwhile, then the size read is stale and the exchange fails
+        klogCompareExchange(&klogFirst, first, first + klogRecordAt(first)->size);
+    }
+}
+
+/**
+ * @brief Write a number of decimal digits, with leading zeros
+ *
+ * @param dest      Destination
+ * @param value     Number
+ * @param digits    Digits written
+ * @return char*    End of the digits
+ */
+char* klogWriteDigits(char* dest, uint32_t value, uint8_t digits) {
+    uint8_t i;
+
+    for (i = digits; i > 0; i--) {
+        dest[i - 1] = '0' + value % 10;
+        value /= 10;
+    }
+    return dest + digits;
+}
+
+/**
+ * @brief Print the timestamp of a record as [seconds.microseconds]
+ *
+ * @param console   Console
+ * @param tsc       TSC of the record
+ */
+void klogPrintTimestamp(uint8_t console, uint64_t tsc) {
+    char str[32];
+    char* end;
+    uint32_t remainder;
+    uint32_t seconds;
+
+    seconds = (uint32_t) stdlib::udiv64(clock::cyclesToNs(tsc - klogBootTsc), 1000000000, &remainder);
+    str[0] = '[';
+    stdlib::uitoa(seconds, 10, str + 1);
+    for (end = str + 1; *end != 0; end++) {
+    }
+    *end++ = '.';
+    end = klogWriteDigits(end, remainder / 1000, 6);
+    *end++ = ']';
+    *end++ = ' ';
+    *end = 0;
+    vga::printStr(console, VGA_DEF_FORECOLOR, VGA_DEF_BGCOLOR, str);
+}
+
+/**
+ * @brief Print a piece of the text of a record, with the timestamp of the record before each line
+ *
+ * @param console   Console
+ * @param header    Copy of the record header
+ * @param text      Piece of the text followed by a null terminator, changed while it's printed
+ * @param count     Bytes of the piece
+ * @param lineStart The last text printed ended a line, updated
+ * @return true     The piece holds the null terminator of the text
+ * @return false    The text goes on in the next piece
+ */
+bool klogPrintText(uint8_t console, KlogRecord* header, char* text, uint32_t count, bool* lineStart) {
+    char* start = text;
+    char* line = text;
+    char next;
+
+    for (; *text != 0; text++) {
+        if (*text != '\n') {
+            continue;
+        }
+        if (*lineStart) {
+            klogPrintTimestamp(console, header->tsc);
+        }
+        next = text[1];
+        text[1] = 0;
+        vga::printStr(console, header->foreColor, header->bgColor, line);
+        text[1] = next;
+        line = text + 1;
+        *lineStart = true;
+    }
+    if (*line != 0) {
+        if (*lineStart) {
+            klogPrintTimestamp(console, header->tsc);
+        }
+        vga::printStr(console, header->foreColor, header->bgColor, line);
+        *lineStart = false;
+    }
+    return (uint32_t) (text - start) < count;
+}
+
+/**
+ * @brief Tasklet scheduled by the timer ticks. Queue the drain work, the tasklet can't write the records itself.
+ *
+ * @param data Unused
+ */
+void klogDrainTaskletFunc(void*) {
+    workqueue::queue(&klogDrainWork);
+}
+
+/**
+ * @brief Work item. Drain the ring with the interruptions enabled.
+ *
+ * @param data Unused
+ */
+void klogDrainWorkFunc(void*) {
+    klog::drain();
+}
+
+// ====================== PUBLIC =======================
+
+void klog::install() {
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    klogHead = 0;
+    klogDrained = 0;
+    klogFirst = 0;
+    klogDraining = KLOG_NOT_DRAINING;
+    klogDropped = 0;
+    klogBootTsc = tsc::read();
+    memutils::memset(klogBuffer, 0, KLOG_BUFFER_SIZE);   // No header left in memory matches a position of the first lap
+    softirq::initTasklet(&klogDrainTasklet, klogDrainTaskletFunc, NULL);
+    workqueue::initWork(&klogDrainWork, klogDrainWorkFunc, NULL);
+}
+
+char* klog::reserve(uint8_t console, int foreColor, int bgColor, uint32_t length) {
+    KlogRecord* record;
+    uint32_t size;
+    uint32_t head;
+    uint32_t pad;
+    uint32_t end;
+
+    if (length > KLOG_MAX_TEXT) {
+        length = KLOG_MAX_TEXT;
+    }
+    size = (sizeof(KlogRecord) + length + 1 + KLOG_ALIGN - 1) & ~(KLOG_ALIGN - 1);
+
+    // Reserve: a single compare-exchange moves the head past the record, and the padding at the end of the ring
+    do {
+        head = klogHead;
+        pad = (head % KLOG_BUFFER_SIZE) + size > KLOG_BUFFER_SIZE ? KLOG_BUFFER_SIZE - head % KLOG_BUFFER_SIZE : 0;
+        end = head + pad + size;
+        if (end - klogDrained > KLOG_BUFFER_SIZE) {     // Would overwrite records not written on the console yet
+            klogFetchAdd(&klogDropped, 1);
+            return NULL;
+        }
+    } while (!klogCompareExchange(&klogHead, head, end));
+    klogForget(end - KLOG_BUFFER_SIZE);
+
+    // The state is set first, a drain that finds the new position always finds a valid state
+    if (pad > 0) {
+        record = klogRecordAt(head);
+        record->state = KLOG_STATE_RESERVED;
+        asm volatile("" : /* output */ : /* input */ : /* clobbers */ "memory");
+        record->position = head;
+        record->size = pad;
+        asm volatile("" : /* output */ : /* input */ : /* clobbers */ "memory");
+        record->state = KLOG_STATE_PADDING;
+        head += pad;
+    }
+
+    record = klogRecordAt(head);
+    record->state = KLOG_STATE_RESERVED;
+    asm volatile("" : /* output */ : /* input */ : /* clobbers */ "memory");
+    record->position = head;
+    record->size = size;
+    record->console = console;
+    record->foreColor = foreColor;
+    record->bgColor = bgColor;
+    record->cpu = smp::getCpuIndex();
+    record->tsc = tsc::read();
+    ((char*) record)[sizeof(KlogRecord) + length] = 0;
+    return (char*) record + sizeof(KlogRecord);
+}
+
+void klog::commit(char* text) {
+    KlogRecord* record = (KlogRecord*) (text - sizeof(KlogRecord));
+
+    asm volatile("" : /* output */ : /* input */ : /* clobbers */ "memory");
+    record->state = KLOG_STATE_COMMITTED;
+
+    if (!softirq::inInterrupt()) {
+        drain();
+    }
+}
+
+bool klog::write(uint8_t console, int foreColor, int bgColor, const char* text) {
+    char* record;
+    uint32_t length;
+
+    for (length = 0; length < KLOG_MAX_TEXT && text[length] != 0; length++) {
+    }
+    record = reserve(console, foreColor, bgColor, length);
+    if (record == NULL) {
+        return false;
+    }
+    memutils::memcpy(record, text, length);
+    commit(record);
+    return true;
+}
+
+bool klog::vwrite(uint8_t console, int foreColor, int bgColor, const char* format, va_list list) {
+    char* record;
+    va_list measure;
+    uint32_t length;
+
+    // Measured first, then formatted straight in the reserved record
+    __va_copy(measure, list);                   // va_copy isn't defined in strict c++14
+    length = stdlib::va_nstringf(NULL, 0, format, measure);
+    va_end(measure);
+    if (length > KLOG_MAX_TEXT) {
+        length = KLOG_MAX_TEXT;
+    }
+    record = reserve(console, foreColor, bgColor, length);
+    if (record == NULL) {
+        return false;
+    }
+    stdlib::va_nstringf(record, length + 1, format, list);
+    commit(record);
+    return true;
+}
+
+void klog::drain() {
+    KlogRecord* record;
+    uint32_t offset;
+
+    if (!klogCompareExchange(&klogDraining, KLOG_NOT_DRAINING, KLOG_DRAINING)) {
+        return;                                 // The running drain writes the new records too
+    }
+
+    offset = klogDrained;
+    while (offset != klogHead) {
+        record = klogRecordAt(offset);
+        if (record->position != offset || record->state == KLOG_STATE_RESERVED) {
+            break;                              // Still being written, by an interrupted writer
+        }
+        if (record->state == KLOG_STATE_COMMITTED) {
+            // The writers don't overwrite the records not drained, the text can be printed from the ring
+            vga::printStr(record->console, record->foreColor, record->bgColor, (char*) record + sizeof(KlogRecord));
+        }
+        offset += record->size;
+        klogDrained = offset;
+    }
+
+    klogDraining = KLOG_NOT_DRAINING;
+}
+
+void klog::scheduleDrain() {
+    if (klogDrained != klogHead) {
+        softirq::schedule(&klogDrainTasklet);
+    }
+}
+
+void klog::print() {
+    KlogRecord* record;
+    KlogRecord header;
+    char chunk[KLOG_READ_CHUNK + 1];
+    char dropped[16];
+    uint8_t console = vga::getOutputConsole();
+    uint32_t offset;
+    uint32_t length;
+    uint32_t copied;
+    uint32_t count;
+    bool lineStart = true;
+
+    offset = klogFirst;
+    while (offset != klogDrained) {
+        // A nested writer can forget the record while it's copied, a copy is only printed when the record is still kept
+        record = klogRecordAt(offset);
+        memutils::memcpy(&header, record, sizeof(KlogRecord));
+        if ((int32_t) (offset - klogFirst) < 0 || header.position != offset) {
+            offset = klogFirst;                 // Overwritten, start again from the oldest record
+            lineStart = true;
+            continue;
+        }
+
+        if (header.state == KLOG_STATE_COMMITTED) {
+            length = header.size - sizeof(KlogRecord);
+            for (copied = 0; copied < length; copied += count) {
+                count = length - copied < KLOG_READ_CHUNK ? length - copied : KLOG_READ_CHUNK;
+                memutils::memcpy(chunk, (char*) record + sizeof(KlogRecord) + copied, count);
+                chunk[count] = 0;
+                if ((int32_t) (offset - klogFirst) < 0) {
+                    break;                      // The rest of the text is lost, the next record is checked as well
+                }
+                if (klogPrintText(console, &header, chunk, count, &lineStart)) {
+                    break;                      // Null terminator found, the rest is alignment
+                }
+            }
+        }
+        offset += header.size;
+    }
+
+    if (klogDropped > 0) {
+        stdlib::uitoa(klogDropped, 10, dropped);
+        vga::printStr(console, VGA_LIGHT_RED, VGA_DEF_BGCOLOR, "klog: ");
+        vga::printStr(console, VGA_LIGHT_RED, VGA_DEF_BGCOLOR, dropped);
+        vga::printStr(console, VGA_LIGHT_RED, VGA_DEF_BGCOLOR, " records dropped, the ring was full\n");
+    }
+}
+
+uint32_t klog::getDroppedRecords() {
+    return klogDropped;
+}
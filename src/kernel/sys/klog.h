@@ -0,0 +1,117 @@
+#pragma once
+#ifndef _KLOG_H_
+#define _KLOG_H_
+
+// libc
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define KLOG_BUFFER_SIZE 65536                  // Bytes of the ring, a power of 2 so the offsets wrap around with the uint32_t
+#define KLOG_MAX_TEXT 1024                      // Longer texts are truncated
+#define KLOG_READ_CHUNK 128                     // Bytes copied out of the ring and checked at a time by klog::print
+
+/**
+ * @brief KLOG - Kernel log ring buffer
+ *
+ *    - stdio::kprintf doesn't write on the screen: each call adds a record to the ring, with the TSC timestamp, the cpu,
+ *      the console and the colors of the text. The text is formatted straight in the record, there's no stack buffer.
+ *    - A record is added with a single reserve and commit: a compare-exchange on the head offset reserves the space, the
+ *      text is copied and the record is marked committed. No lock is taken, so it can be called from any context,
+ *      interruption handlers included. A record never wraps around the end of the ring, a padding record fills the end.
+ *    - The records are written on their console (and on COM1 for the kernel console) by klog::drain, in order. It stops
+ *      at the first record still being written.
+ *    - Outside of the interruption handlers and tasklets kprintf drains the ring itself, so the syscall output stays
+ *      in order with the process output. In an interruption the record is only added: the next timer tick schedules
+ *      a tasklet that queues a work item, a worker thread drains the ring with the interruptions enabled.
+ *    - The records not drained yet are never overwritten, a record that doesn't fit is dropped and counted. The drained
+ *      ones are kept as history until the ring wraps around, and printed again by the DMESG syscall (shell "dmesg").
+ *
+ * The big kernel lock serializes the cpus, two writers only race when an interruption nests in a writer of the same
+ * cpu. The nested writer reserves after the outer one and commits first, the drain waits for the outer record.
+ *
+ * RECORD:
+ *  __________________________________________________________________
+ * | size | state | console | color | cpu | position | tsc | text\0 ...|
+ *  ‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾‾
+ *    position is the offset where the record was reserved, a header left by a previous lap of the ring doesn't match it.
+ */
+namespace klog {
+    /**
+     * @brief Initialize the ring and its drain work. Must be called before any kprintf.
+     *
+     */
+    void install();
+
+    /**
+     * @brief Reserve a record for a text of a known length. The text is written in the record, then klog::commit is
+     *        called. Used by the writers that format the text themselves, E.g KPRINTF.
+     *
+     * @param console   Console the text is written on
+     * @param foreColor Text color
+     * @param bgColor   Background color
+     * @param length    Chars of the text, truncated to KLOG_MAX_TEXT
+     * @return char*    Text of the record with room for length chars, already null terminated. NULL when it's dropped
+     */
+    char* reserve(uint8_t console, int foreColor, int bgColor, uint32_t length);
+
+    /**
+     * @brief Commit a reserved record. Drains the ring when it isn't called by an interruption handler or a tasklet.
+     *
+     * @param text Text returned by klog::reserve
+     */
+    void commit(char* text);
+
+    /**
+     * @brief Add a record to the ring. Drains the ring when it isn't called by an interruption handler or a tasklet.
+     *
+     * @param console   Console the text is written on
+     * @param foreColor Text color
+     * @param bgColor   Background color
+     * @param text      Text, truncated to KLOG_MAX_TEXT bytes
+     * @return true     Added
+     * @return false    Dropped, the ring is full of records not drained yet
+     */
+    bool write(uint8_t console, int foreColor, int bgColor, const char* text);
+
+    /**
+     * @brief Format a text in a new record, without an intermediate buffer: the text is measured, then formatted in the
+     *        reserved record. Called by stdio::kprintf.
+     *
+     * @param console   Console the text is written on
+     * @param foreColor Text color
+     * @param bgColor   Background color
+     * @param format    Format of stdlib::va_formatf, the text is truncated to KLOG_MAX_TEXT bytes
+     * @param list      Arguments
+     * @return true     Added
+     * @return false    Dropped, the ring is full of records not drained yet
+     */
+    bool vwrite(uint8_t console, int foreColor, int bgColor, const char* format, va_list list);
+
+    /**
+     * @brief Write the committed records on their console, in order. Does nothing when another drain is running.
+     *
+     */
+    void drain();
+
+    /**
+     * @brief Schedule a drain by a worker thread when records are waiting. Called by the timer ticks.
+     *
+     */
+    void scheduleDrain();
+
+    /**
+     * @brief Print the records kept in the ring on the console of the caller, each line with its timestamp
+     *
+     */
+    void print();
+
+    /**
+     * @brief Get the records dropped because the ring was full
+     *
+     * @return uint32_t Dropped records since klog::install
+     */
+    uint32_t getDroppedRecords();
+}
+
+#endif
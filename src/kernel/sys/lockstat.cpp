@@ -0,0 +1,35 @@
+// stdlibs
+#include "stdlib.h"
+#include "stdio.h"
+// sys
+#include "lockstat.h"
+
+LockStats* namedLocks[LOCKSTAT_MAX_LOCKS];
+uint32_t namedLocksCount;
+
+void lockstat::install() {
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    namedLocksCount = 0;
+}
+
+void lockstat::init(LockStats* stats, const char* name) {
+    stats->name = name;
+    stats->acquisitions = 0;
+    stats->contentions = 0;
+    stats->waits = 0;
+    if (name != NULL && namedLocksCount < LOCKSTAT_MAX_LOCKS) {
+        namedLocks[namedLocksCount++] = stats;
+    }
+}
+
+void lockstat::print() {
+    uint32_t i;
+    LockStats* stats;
+
+    KPRINTF("------------ Locks -----------\n");
+    for (i = 0; i < namedLocksCount; i++) {
+        stats = namedLocks[i];
+        KPRINTF("%s: acquired %d, contended %d, waits %d\n", stats->name, stats->acquisitions, stats->contentions, stats->waits);
+    }
+    KPRINTF("-----------------------------");
+}
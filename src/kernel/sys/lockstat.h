@@ -0,0 +1,50 @@
+#pragma once
+#ifndef _LOCKSTAT_H_
+#define _LOCKSTAT_H_
+
+// libc
+#include <stdint.h>
+
+#define LOCKSTAT_MAX_LOCKS 32                   // Named locks listed by lockstat::print, the others are still counted
+
+/**
+ * @brief Contention counters embedded in every kernel lock. Updated by the lock owner, so no atomic operation is needed.
+ *
+ */
+typedef struct {
+    const char* name;                           // Name shown by lockstat::print, NULL when the lock isn't listed
+    uint32_t acquisitions;                      // Times the lock was taken
+    uint32_t contentions;                       // Acquisitions that found the lock held and had to wait
+    uint32_t waits;                             // PAUSE iterations of the spinning locks, sleeps of the sleeping locks
+} LockStats;
+
+/**
+ * @brief LOCKSTAT - Lock contention statistics
+ *
+ *    - Each spinlock, reader-writer lock and semaphore counts its acquisitions and the ones that had to wait.
+ *    - A lock initialized with a name is added to a list printed by the LOCK_STATS syscall (shell "locks" command), so the hot
+ *      locks can be found. A high contentions / acquisitions ratio means the lock serializes the cpus.
+ */
+namespace lockstat {
+    /**
+     * @brief Initialize the list of named locks. Must be called before any lock is initialized.
+     *
+     */
+    void install();
+
+    /**
+     * @brief Reset the counters of a lock and list it if it has a name
+     *
+     * @param stats Counters of the lock
+     * @param name  Lock name, NULL to not list it
+     */
+    void init(LockStats* stats, const char* name);
+
+    /**
+     * @brief Print the counters of the named locks
+     *
+     */
+    void print();
+}
+
+#endif
@@ -0,0 +1,33 @@
+// stdlibs
+#include "stdlib.h"
+// process
+#include "scheduler.h"
+// sys
+#include "mutex.h"
+
+void mutex::init(Mutex* mutex, const char* name) {
+    semaphore::init(&mutex->sem, 1, name);
+    mutex->owner = NULL;
+}
+
+void mutex::lock(Mutex* mutex) {
+    semaphore::down(&mutex->sem);
+    mutex->owner = scheduler::getRunningProcess();
+}
+
+bool mutex::tryLock(Mutex* mutex) {
+    if (!semaphore::tryDown(&mutex->sem)) {
+        return false;
+    }
+    mutex->owner = scheduler::getRunningProcess();
+    return true;
+}
+
+void mutex::unlock(Mutex* mutex) {
+    mutex->owner = NULL;
+    semaphore::up(&mutex->sem);
+}
+
+PID mutex::getOwner(Mutex* mutex) {
+    return mutex->owner;
+}
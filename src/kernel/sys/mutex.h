@@ -0,0 +1,70 @@
+#pragma once
+#ifndef _MUTEX_H_
+#define _MUTEX_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+// process
+#include "scheduler.h"
+// sys
+#include "semaphore.h"
+
+/**
+ * @brief Sleeping mutual exclusion lock
+ *
+ */
+typedef struct {
+    Semaphore sem;                              // Binary semaphore, 1 when the mutex is free
+    PID owner;                                  // Process holding the mutex, NULL when free
+} Mutex;
+
+/**
+ * @brief MUTEX - Sleeping lock owned by a process
+ *
+ *    - Built on a binary semaphore. A process that finds the mutex held is blocked until the owner releases it.
+ *    - Can be held while the owner blocks (E.g waiting for the keyboard), a spinlock can't.
+ *    - Only called from a syscall, never from an interruption handler.
+ */
+namespace mutex {
+    /**
+     * @brief Initialize a free mutex
+     *
+     * @param mutex Mutex
+     * @param name  Name listed in the contention statistics, NULL to not list it
+     */
+    void init(Mutex* mutex, const char* name = NULL);
+
+    /**
+     * @brief Take the mutex, blocking the running process while another one holds it
+     *
+     * @param mutex Mutex
+     */
+    void lock(Mutex* mutex);
+
+    /**
+     * @brief Take the mutex if it's free, never blocks
+     *
+     * @param mutex     Mutex
+     * @return true     Taken
+     * @return false    Held by another process
+     */
+    bool tryLock(Mutex* mutex);
+
+    /**
+     * @brief Release the mutex and wake up the first waiting process
+     *
+     * @param mutex Mutex held by the running process
+     */
+    void unlock(Mutex* mutex);
+
+    /**
+     * @brief Get the process holding the mutex
+     *
+     * @param mutex     Mutex
+     * @return PID      Owner, NULL when free
+     */
+    PID getOwner(Mutex* mutex);
+}
+
+#endif
@@ -0,0 +1,82 @@
+// stdlibs
+#include "stdlib.h"
+// sys
+#include "rwlock.h"
+
+void rwlock::init(RwLock* lock, const char* name) {
+    spinlock::init(&lock->lock);
+    lock->readers = 0;
+    lock->writer = false;
+    lock->writersWaiting = 0;
+    lockstat::init(&lock->stats, name);
+}
+
+void rwlock::readLock(RwLock* lock) {
+    uint32_t waits = 0;
+
+    while (true) {
+        spinlock::acquire(&lock->lock);
+        if (!lock->writer && lock->writersWaiting == 0) {
+            lock->readers++;
+            break;
+        }
+        spinlock::release(&lock->lock);
+
+        while (lock->writer || lock->writersWaiting > 0) {    // Read only until the writers leave
+            asm volatile("pause");
+            waits++;
+        }
+    }
+
+    lock->stats.acquisitions++;
+    if (waits > 0) {
+        lock->stats.contentions++;
+        lock->stats.waits += waits;
+    }
+    spinlock::release(&lock->lock);
+}
+
+void rwlock::readUnlock(RwLock* lock) {
+    spinlock::acquire(&lock->lock);
+    lock->readers--;
+    spinlock::release(&lock->lock);
+}
+
+void rwlock::writeLock(RwLock* lock) {
+    uint32_t waits = 0;
+    bool waiting = false;
+
+    while (true) {
+        spinlock::acquire(&lock->lock);
+        if (!lock->writer && lock->readers == 0) {
+            lock->writer = true;
+            if (waiting) {
+                lock->writersWaiting--;
+            }
+            break;
+        }
+        if (!waiting) {
+            lock->writersWaiting++;                         // Stop the new readers
+            waiting = true;
+        }
+        spinlock::release(&lock->lock);
+
+        while (lock->writer || lock->readers > 0) {
+            asm volatile("pause");
+            waits++;
+        }
+    }
+
+    lock->stats.acquisitions++;
+    if (waits > 0) {
+        lock->stats.contentions++;
+        lock->stats.waits += waits;
+    }
+    spinlock::release(&lock->lock);
+}
+
+void rwlock::writeUnlock(RwLock* lock) {
+    spinlock::acquire(&lock->lock);
+    lock->writer = false;
+    spinlock::release(&lock->lock);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef _RWLOCK_H_
+#define _RWLOCK_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+// sys
+#include "spinlock.h"
+#include "lockstat.h"
+
+/**
+ * @brief Reader-writer busy waiting lock
+ *
+ */
+typedef struct {
+    Spinlock lock;                              // Protects the fields below, held only while they are changed
+    volatile uint32_t readers;                  // Readers holding the lock
+    volatile bool writer;                       // A writer holds the lock
+    volatile uint32_t writersWaiting;           // Writers waiting, new readers wait for them so the writers don't starve
+    LockStats stats;                            // Contention counters of the readers and the writers
+} RwLock;
+
+/**
+ * @brief RWLOCK - Reader-writer lock
+ *
+ *    - Many readers, or a single writer, hold the lock at the same time. Used for data read much more often than changed.
+ *    - A waiting writer stops the new readers, the writer enters when the current readers leave.
+ *    - Like the spinlocks the waiting cpus spin, the lock must not be held while the process blocks.
+ *      The interruptions aren't disabled, a lock used by an interruption handler must be taken with them disabled.
+ */
+namespace rwlock {
+    /**
+     * @brief Initialize a free lock
+     *
+     * @param lock Lock
+     * @param name Name listed in the contention statistics, NULL to not list it
+     */
+    void init(RwLock* lock, const char* name = NULL);
+
+    /**
+     * @brief Take the lock for reading, spinning while a writer holds it or waits for it
+     *
+     * @param lock Lock
+     */
+    void readLock(RwLock* lock);
+
+    /**
+     * @brief Release the lock taken for reading
+     *
+     * @param lock Lock
+     */
+    void readUnlock(RwLock* lock);
+
+    /**
+     * @brief Take the lock for writing, spinning until the readers and the writer leave
+     *
+     * @param lock Lock
+     */
+    void writeLock(RwLock* lock);
+
+    /**
+     * @brief Release the lock taken for writing
+     *
+     * @param lock Lock
+     */
+    void writeUnlock(RwLock* lock);
+}
+
+#endif
@@ -0,0 +1,52 @@
+// stdlibs
+#include "stdlib.h"
+// process
+#include "scheduler.h"
+// sys
+#include "semaphore.h"
+
+void semaphore::init(Semaphore* sem, uint32_t count, const char* name) {
+    spinlock::init(&sem->lock);
+    sem->count = count;
+    queue::init(&sem->waiters);
+    lockstat::init(&sem->stats, name);
+}
+
+void semaphore::down(Semaphore* sem) {
+    uint32_t flags = spinlock::acquireIrqSave(&sem->lock);
+    bool waited = false;
+
+    while (sem->count == 0) {
+        sem->stats.waits++;
+        waited = true;
+        scheduler::block(&sem->waiters, PROC_STATE_WAITING, &sem->lock);  // The lock is released once the process is in the wait queue
+        spinlock::acquire(&sem->lock);                                      // Woken up, other process may have taken the unit first
+    }
+    sem->count--;
+
+    sem->stats.acquisitions++;
+    if (waited) {
+        sem->stats.contentions++;
+    }
+    spinlock::releaseIrqRestore(&sem->lock, flags);
+}
+
+bool semaphore::tryDown(Semaphore* sem) {
+    uint32_t flags = spinlock::acquireIrqSave(&sem->lock);
+    bool taken = sem->count > 0;
+
+    if (taken) {
+        sem->count--;
+        sem->stats.acquisitions++;
+    }
+    spinlock::releaseIrqRestore(&sem->lock, flags);
+    return taken;
+}
+
+void semaphore::up(Semaphore* sem) {
+    uint32_t flags = spinlock::acquireIrqSave(&sem->lock);
+
+    sem->count++;
+    scheduler::wakeUpOne(&sem->waiters);
+    spinlock::releaseIrqRestore(&sem->lock, flags);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef _SEMAPHORE_H_
+#define _SEMAPHORE_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+// process
+#include "queue.h"
+// sys
+#include "spinlock.h"
+#include "lockstat.h"
+
+/**
+ * @brief Counting semaphore
+ *
+ */
+typedef struct {
+    Spinlock lock;                              // Protects count and waiters
+    volatile uint32_t count;                    // Units available
+    Queue waiters;                              // Processes blocked in semaphore::down
+    LockStats stats;                            // Downs, downs that slept and sleeps
+} Semaphore;
+
+/**
+ * @brief SEMAPHORE - Sleeping counting semaphore
+ *
+ *    - semaphore::down takes one unit. When none is available the running process is blocked on the semaphore wait queue and
+ *      other processes are executed meanwhile, unlike a spinlock the cpu isn't wasted.
+ *    - semaphore::up returns one unit and wakes up the first waiting process, which takes it again when it's scheduled.
+ *    - semaphore::down can block, it's only called from a syscall. semaphore::up can be called from an interruption handler.
+ */
+namespace semaphore {
+    /**
+     * @brief Initialize a semaphore
+     *
+     * @param sem   Semaphore
+     * @param count Units initially available
+     * @param name  Name listed in the contention statistics, NULL to not list it
+     */
+    void init(Semaphore* sem, uint32_t count, const char* name = NULL);
+
+    /**
+     * @brief Take one unit, blocking the running process until one is available
+     *
+     * @param sem Semaphore
+     */
+    void down(Semaphore* sem);
+
+    /**
+     * @brief Take one unit if available, never blocks
+     *
+     * @param sem       Semaphore
+     * @return true     Unit taken
+     * @return false    No unit available
+     */
+    bool tryDown(Semaphore* sem);
+
+    /**
+     * @brief Return one unit and wake up the first waiting process
+     *
+     * @param sem Semaphore
+     */
+    void up(Semaphore* sem);
+}
+
+#endif
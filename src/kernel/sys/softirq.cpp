@@ -0,0 +1,94 @@
+// stdlibs
+#include "stdlib.h"
+// cpu
+#include "smp.h"
+// sys
+#include "softirq.h"
+
+Tasklet* pendingTaskletsHead[SMP_MAX_CPUS];     // Tasklets waiting to run on each cpu, in schedule order
+Tasklet* pendingTaskletsTail[SMP_MAX_CPUS];
+bool taskletsRunning[SMP_MAX_CPUS];             // The cpu is running its pending list, nested interruptions don't run it
+uint32_t taskletRuns[SMP_MAX_CPUS];
+uint8_t irqDepth[SMP_MAX_CPUS];                 // Nested irq_handler calls running on each cpu
+
+void softirq::install() {
+    int i;
+
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    for (i = 0; i < SMP_MAX_CPUS; i++) {
+        pendingTaskletsHead[i] = NULL;
+        pendingTaskletsTail[i] = NULL;
+        taskletsRunning[i] = false;
+        taskletRuns[i] = 0;
+        irqDepth[i] = 0;
+    }
+}
+
+void softirq::initTasklet(Tasklet* tasklet, tasklet_t func, void* data) {
+    tasklet->func = func;
+    tasklet->data = data;
+    tasklet->scheduled = false;
+    tasklet->next = NULL;
+}
+
+void softirq::schedule(Tasklet* tasklet) {
+    uint32_t flags;
+    uint8_t cpu;
+
+    // The pending list is only changed by its own cpu, disabling the interruptions is enough
+    asm volatile("pushf; pop %0; cli" : /* output */ "=r"(flags) : /* input */ : /* clobbers */ "memory");
+    if (!tasklet->scheduled) {
+        cpu = smp::getCpuIndex();
+        tasklet->scheduled = true;
+        tasklet->next = NULL;
+        if (pendingTaskletsTail[cpu] == NULL) {
+            pendingTaskletsHead[cpu] = tasklet;
+        } else {
+            pendingTaskletsTail[cpu]->next = tasklet;
+        }
+        pendingTaskletsTail[cpu] = tasklet;
+    }
+    asm volatile("push %0; popf" : /* output */ : /* input */ "r"(flags) : /* clobbers */ "memory", "cc");
+}
+
+void softirq::run() {
+    uint8_t cpu = smp::getCpuIndex();
+    Tasklet* tasklet;
+
+    if (taskletsRunning[cpu]) {                 // Interruption received while the tasklets run, the outer call runs the new ones
+        return;
+    }
+    taskletsRunning[cpu] = true;
+
+    while ((tasklet = pendingTaskletsHead[cpu]) != NULL) {
+        pendingTaskletsHead[cpu] = tasklet->next;
+        if (pendingTaskletsHead[cpu] == NULL) {
+            pendingTaskletsTail[cpu] = NULL;
+        }
+        tasklet->next = NULL;
+        tasklet->scheduled = false;             // Can be scheduled again while it runs
+
+        asm volatile("sti" : /* output */ : /* input */ : /* clobbers */ "memory");
+        tasklet->func(tasklet->data);
+        asm volatile("cli" : /* output */ : /* input */ : /* clobbers */ "memory");
+        taskletRuns[cpu]++;
+    }
+
+    taskletsRunning[cpu] = false;
+}
+
+uint32_t softirq::getTaskletRuns(uint8_t cpu) {
+    return taskletRuns[cpu];
+}
+
+void softirq::irqEnter() {
+    irqDepth[smp::getCpuIndex()]++;             // Only changed by its own cpu with the interruptions disabled
+}
+
+void softirq::irqExit() {
+    irqDepth[smp::getCpuIndex()]--;
+}
+
+bool softirq::inInterrupt() {
+    return irqDepth[smp::getCpuIndex()] > 0;    // The tasklets are run by irq_handler, between irqEnter and irqExit
+}
@@ -0,0 +1,103 @@
+#pragma once
+#ifndef _SOFTIRQ_H_
+#define _SOFTIRQ_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Function of a tasklet
+ *
+ */
+typedef void (*tasklet_t)(void* data);
+
+/**
+ * @brief Deferred work scheduled by an interruption handler
+ *
+ */
+typedef struct Tasklet {
+    tasklet_t func;                             // Called with the interruptions enabled
+    void* data;                                 // Argument of func
+    volatile bool scheduled;                    // In a pending list, scheduling it again does nothing
+    struct Tasklet* next;                       // Next tasklet in the pending list of the cpu
+} Tasklet;
+
+/**
+ * @brief SOFTIRQ - Bottom halves run after the interruption handlers
+ *
+ * TOP_HALF:
+ *    - The interruption handler (top half) runs with the interruptions disabled. It only reads the device, stores the data and
+ *      schedules a tasklet, so the other interruptions aren't delayed by the slow part of the work.
+ *
+ * TASKLETS:
+ *    - A scheduled tasklet is added to the pending list of the running cpu. The list is run by irq_handler after the EOI,
+ *      with the interruptions enabled, before returning to the interrupted code.
+ *    - An interruption received while the tasklets run doesn't run them again, the outer irq_handler runs the new ones.
+ *    - The tasklets run with the kernel lock held, so a tasklet never runs on two cpus at the same time.
+ *    - A tasklet can't block, it runs on the stack of the interrupted context. Work that blocks or is slow goes to the
+ *      worker threads (workqueue.h).
+ *    - softirq::inInterrupt tells the top halves and the tasklets apart from the process context, E.g klog.h only
+ *      drains the kernel log outside of them.
+ */
+namespace softirq {
+    /**
+     * @brief Initialize the pending lists of the cpus. Must be called before the interruptions are enabled.
+     *
+     */
+    void install();
+
+    /**
+     * @brief Initialize a tasklet
+     *
+     * @param tasklet   Tasklet
+     * @param func      Function called when the tasklet runs
+     * @param data      Argument of func
+     */
+    void initTasklet(Tasklet* tasklet, tasklet_t func, void* data);
+
+    /**
+     * @brief Add a tasklet to the pending list of the running cpu, unless it's already scheduled.
+     *        Usually called by an interruption handler.
+     *
+     * @param tasklet Tasklet
+     */
+    void schedule(Tasklet* tasklet);
+
+    /**
+     * @brief Run the pending tasklets of the running cpu with the interruptions enabled. Called by irq_handler with the
+     *        interruptions disabled, they are disabled again on return.
+     *
+     */
+    void run();
+
+    /**
+     * @brief Get the tasklets run by a cpu
+     *
+     * @param cpu           Cpu index
+     * @return uint32_t     Tasklets run since softirq::install
+     */
+    uint32_t getTaskletRuns(uint8_t cpu);
+
+    /**
+     * @brief Mark the running cpu as serving an interruption. Called by irq_handler after taking the kernel lock.
+     *
+     */
+    void irqEnter();
+
+    /**
+     * @brief Mark the end of the interruption, after its tasklets. Called by irq_handler before returning.
+     *
+     */
+    void irqExit();
+
+    /**
+     * @brief Check if the running cpu is in an interruption handler or a tasklet
+     *
+     * @return true     Interruption context, the code can't block nor do slow work
+     * @return false    Process, kernel thread or boot context
+     */
+    bool inInterrupt();
+}
+
+#endif
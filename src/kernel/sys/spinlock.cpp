@@ -0,0 +1,92 @@
+// stdlibs
+#include "stdlib.h"
+// sys
+#include "spinlock.h"
+
+/**
+ * @brief Atomically add a value to the lock tickets
+ *
+ * @param lock          Lock
+ * @param value         Value added
+ * @return uint32_t     Tickets before the addition
+ */
+uint32_t spinlockFetchAdd(Spinlock* lock, uint32_t value) {
+    asm volatile("lock xaddl %0, %1" : /* output */ "+r"(value), "+m"(lock->tickets) : /* input */ : /* clobbers */ "memory");
+    return value;
+}
+
+/**
+ * @brief Atomically replace the lock tickets if they didn't change
+ *
+ * @param lock      Lock
+ * @param expected  Tickets read before
+ * @param value     New tickets
+ * @return true     Replaced
+ * @return false    Another cpu changed the tickets meanwhile
+ */
+bool spinlockCompareExchange(Spinlock* lock, uint32_t expected, uint32_t value) {
+    uint32_t previous;
+
+    asm volatile("lock cmpxchgl %2, %1" : /* output */ "=a"(previous), "+m"(lock->tickets) : /* input */ "r"(value), "0"(expected) : /* clobbers */ "memory");
+    return previous == expected;
+}
+
+void spinlock::init(Spinlock* lock, const char* name) {
+    lock->tickets = 0;
+    lockstat::init(&lock->stats, name);
+}
+
+void spinlock::acquire(Spinlock* lock) {
+    uint16_t ticket = spinlockFetchAdd(lock, SPINLOCK_TICKET_NEXT) >> 16;
+    uint32_t waits = 0;
+
+    while ((uint16_t) lock->tickets != ticket) {   // Read only while the other cpus are served
+        asm volatile("pause");
+        waits++;
+    }
+
+    // Counters are updated by the owner
+    lock->stats.acquisitions++;
+    if (waits > 0) {
+        lock->stats.contentions++;
+        lock->stats.waits += waits;
+    }
+}
+
+bool spinlock::tryAcquire(Spinlock* lock) {
+    uint32_t tickets = lock->tickets;
+
+    if ((uint16_t) tickets != (tickets >> 16)) {    // Held, or cpus waiting for it
+        return false;
+    }
+    if (!spinlockCompareExchange(lock, tickets, tickets + SPINLOCK_TICKET_NEXT)) {
+        return false;
+    }
+    lock->stats.acquisitions++;
+    return true;
+}
+
+void spinlock::release(Spinlock* lock) {
+    // Only the owner ticket (low 16 bits) is incremented, the next ticket is still taken by the other cpus meanwhile
+    asm volatile("lock incw %0" : /* output */ "+m"(lock->tickets) : /* input */ : /* clobbers */ "memory");
+}
+
+uint32_t spinlock::acquireIrqSave(Spinlock* lock) {
+    uint32_t flags;
+
+    asm volatile("pushf; pop %0; cli" : /* output */ "=r"(flags) : /* input */ : /* clobbers */ "memory");
+    acquire(lock);
+    return flags;
+}
+
+void spinlock::releaseIrqRestore(Spinlock* lock, uint32_t flags) {
+    release(lock);
+    if (flags & SPINLOCK_EFLAGS_IF) {
+        asm volatile("sti" : /* output */ : /* input */ : /* clobbers */ "memory");
+    }
+}
+
+bool spinlock::isLocked(Spinlock* lock) {
+    uint32_t tickets = lock->tickets;
+    return (uint16_t) tickets != (tickets >> 16);
+}
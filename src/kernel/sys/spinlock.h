@@ -0,0 +1,99 @@
+#pragma once
+#ifndef _SPINLOCK_H_
+#define _SPINLOCK_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+// stdlibs
+#include "stdlib.h"
+// sys
+#include "lockstat.h"
+
+#define SPINLOCK_TICKET_NEXT 0x10000            // Added to tickets to take the next ticket (high 16 bits)
+#define SPINLOCK_EFLAGS_IF 0x200                // Interrupt flag of the EFLAGS saved by spinlock::acquireIrqSave
+
+/**
+ * @brief Busy waiting lock
+ *
+ */
+typedef struct {
+    volatile uint32_t tickets;                  // Low 16 bits: ticket being served (owner), high 16 bits: next ticket
+    LockStats stats;                            // Contention counters
+} Spinlock;
+
+/**
+ * @brief SPINLOCK - Mutual exclusion between cpus
+ *
+ * TICKET_LOCK:
+ *    - A cpu takes a ticket incrementing the next ticket with an atomic XADD, then waits until the owner ticket is its own.
+ *      The release increments the owner ticket, so the cpus take the lock in the order they asked for it (FIFO) and none starves.
+ *    - The waiting cpus spin reading the lock, with PAUSE, so the cache line isn't written while the lock is held.
+ *
+ * INTERRUPTIONS:
+ *    - spinlock::acquire doesn't disable the interruptions. A lock taken by an interruption handler must be taken with the
+ *      interruptions disabled everywhere else, otherwise the handler spins forever on a lock held by the code it interrupted.
+ *    - spinlock::acquireIrqSave disables the interruptions and returns the previous EFLAGS, spinlock::releaseIrqRestore restores them.
+ *      So the same code can be called with the interruptions enabled or disabled.
+ *
+ * A spinlock must not be held while the process blocks, use a mutex or a semaphore.
+ */
+namespace spinlock {
+    /**
+     * @brief Initialize a free lock
+     *
+     * @param lock Lock
+     * @param name Name listed in the contention statistics, NULL to not list it
+     */
+    void init(Spinlock* lock, const char* name = NULL);
+
+    /**
+     * @brief Take the lock, spinning until it's free
+     *
+     * @param lock Lock
+     */
+    void acquire(Spinlock* lock);
+
+    /**
+     * @brief Take the lock if it's free
+     *
+     * @param lock      Lock
+     * @return true     The lock is taken
+     * @return false    The lock is held by another cpu
+     */
+    bool tryAcquire(Spinlock* lock);
+
+    /**
+     * @brief Release the lock
+     *
+     * @param lock Lock
+     */
+    void release(Spinlock* lock);
+
+    /**
+     * @brief Disable the interruptions and take the lock
+     *
+     * @param lock          Lock
+     * @return uint32_t     EFLAGS before the interruptions were disabled, passed to spinlock::releaseIrqRestore
+     */
+    uint32_t acquireIrqSave(Spinlock* lock);
+
+    /**
+     * @brief Release the lock and restore the interruption flag saved by spinlock::acquireIrqSave
+     *
+     * @param lock  Lock
+     * @param flags EFLAGS returned by spinlock::acquireIrqSave
+     */
+    void releaseIrqRestore(Spinlock* lock, uint32_t flags);
+
+    /**
+     * @brief Return whether the lock is held by some cpu
+     *
+     * @param lock      Lock
+     * @return true     Held
+     * @return false    Free
+     */
+    bool isLocked(Spinlock* lock);
+}
+
+#endif
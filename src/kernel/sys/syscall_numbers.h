@@ -0,0 +1,21 @@
+#pragma once
+#ifndef _SYSCALL_NUMBERS_H_
+#define _SYSCALL_NUMBERS_H_
+
+/**
+ * @brief Syscall numbers SYSCALL_<NAME> generated from syscalls.def. Shared by the kernel and the user libraries.
+ * 
+ */
+enum SyscallNumber {
+#define SYSCALL0(NUMBER, NAME, RET, FUNC) SYSCALL_##NAME = NUMBER,
+#define SYSCALL1(NUMBER, NAME, RET, FUNC, R1, T1, A1) SYSCALL_##NAME = NUMBER,
+#define SYSCALL2(NUMBER, NAME, RET, FUNC, R1, T1, A1, R2, T2, A2) SYSCALL_##NAME = NUMBER,
+#define SYSCALL3(NUMBER, NAME, RET, FUNC, R1, T1, A1, R2, T2, A2, R3, T3, A3) SYSCALL_##NAME = NUMBER,
+#include "syscalls.def"
+#undef SYSCALL0
+#undef SYSCALL1
+#undef SYSCALL2
+#undef SYSCALL3
+};
+
+#endif
@@ -2,67 +2,218 @@
 #include <stdbool.h>
 // legacy drivers
 #include "vga.h"
+#include "keyboard.h"
+#include "pit.h"
+// sys
+#include "clock.h"
+#include "lockstat.h"
+#include "klog.h"
 // stdlibs
 #include "stdio.h"
 #include "stdlib.h"
+// cpu
+#include "cpuid.h"
+#include "msr.h"
+#include "gdt.h"
+#include "paging.h"
 #include "syscalls.h"
 #include "scheduler.h"
 
-void syscalls::syscallHandler(IntRegisters* r) {
-    // Get current running process and save his context
-    PID runPid = scheduler::getRunningProcess();
-    scheduler::processSaveContext(runPid, r);
-    bool resumeProcess = true;
+/**
+ * @brief Syscall handler. Arguments are read from the user registers saved on the running process kernel stack.
+ *        The value returned to the process is written in its saved EAX.
+ * 
+ * @return true     Process can continue its execution
+ * @return false    Process was terminated or is waiting for a resource
+ */
+typedef bool (*SyscallHandler)(PID runPid);
+
+/**
+ * @brief Syscall dispatch table indexed by the syscall number. Built from syscalls.def by syscalls::install
+ * 
+ */
+SyscallHandler syscallTable[SYSCALL_TABLE_SIZE];
+
+namespace handlers {
+    // Declare the handlers with its typed arguments and generate the entries that read them from the registers defined in syscalls.def
+    #define SYSCALL0(NUMBER, NAME, RET, FUNC) \
+        bool FUNC(PID runPid); \
+        bool FUNC##Entry(PID runPid) { return FUNC(runPid); }
+    #define SYSCALL1(NUMBER, NAME, RET, FUNC, R1, T1, A1) \
+        bool FUNC(PID runPid, T1 A1); \
+        bool FUNC##Entry(PID runPid) { return FUNC(runPid, (T1) runPid->registers->R1); }
+    #define SYSCALL2(NUMBER, NAME, RET, FUNC, R1, T1, A1, R2, T2, A2) \
+        bool FUNC(PID runPid, T1 A1, T2 A2); \
+        bool FUNC##Entry(PID runPid) { return FUNC(runPid, (T1) runPid->registers->R1, (T2) runPid->registers->R2); }
+    #define SYSCALL3(NUMBER, NAME, RET, FUNC, R1, T1, A1, R2, T2, A2, R3, T3, A3) \
+        bool FUNC(PID runPid, T1 A1, T2 A2, T3 A3); \
+        bool FUNC##Entry(PID runPid) { return FUNC(runPid, (T1) runPid->registers->R1, (T2) runPid->registers->R2, (T3) runPid->registers->R3); }
+    #include "syscalls.def"
+    #undef SYSCALL0
+    #undef SYSCALL1
+    #undef SYSCALL2
+    #undef SYSCALL3
+
+    bool print(PID runPid, const char* str) {                           // SYSCALL - Print a raw text on the console of the process
+        vga::printStr(runPid->console, VGA_DEF_FORECOLOR, VGA_DEF_BGCOLOR, str);
+        return true;
+    }
+
+    bool exit(PID runPid, int code) {                                   // SYSCALL - Proccess finished it's execution
+        if (code != 0) { // Process finished with error code
+            KPRINTF("\n%s (0x%x) - Finished with code %d\n", runPid->processName, runPid->pid, code);
+        }
+        // Terminate this process
+        scheduler::processTerminate(runPid);
+        return false;                                                   // Process is being terminated so we can't resume its execution.
+    }
+
+    bool readln(PID runPid, char* dest) {                               // SYSCALL - Process wants to receive one input line from keyboad.
+        kbd::readLine(runPid->console, dest);                           // Blocks until a line is typed, other processes are executed meanwhile.
+        return true;
+    }
 
-    // stdio::kprintf("ISR(48 - 0x30) - (EAX=0x%x) - (EBX=0x%x) - (ECX=0x%x) - (EDX=0x%x)\n", r->eax, r->ebx, r->ecx, r->edx);
-    // stdio::kprintf("                 (ESP=0x%x) - (EIP=0x%x) - (ESI=0x%x) - (EDI=0x%x)\n", r->esp, r->eip, r->esi, r->edi);
-    if (r->eax == SYSCALL_PRINT) {              // SYSCALL - Print a raw text on screen 
+    bool malloc(PID runPid, unsigned int size) {                        // SYSCALL - Dynamic allocate memory in process heap space.
+        runPid->registers->eax = (unsigned int) heap::malloc(&runPid->processHeap, size);
+        return true;
+    }
 
-        // stdio::kprintf("%s (0x%x) - %s", runPid->processName, runPid->runPid, (char*) runPid->registers.ESI);
-        vga::printStr((char*) runPid->registers.ESI);
+    bool free(PID runPid, void* ptr) {                                  // SYSCALL - Dynamic free memory in process heap space.
+        heap::free(&runPid->processHeap, ptr);
+        return true;
+    }
 
-    } else if (r->eax == SYSCALL_PROC_EXIT) {   // SYSCALL - Proccess finished it's execution
+    bool printProcessList(PID) {                                        // SYSCALL - Print process list in terminal.
+        scheduler::printProcessList();
+        return true;
+    }
 
-        if (r->ebx > 0) { // Process finished with error code
-            stdio::kprintf("\n%s (0x%x) - Finished with code %d\n", runPid->processName, runPid->pid, runPid->registers.EBX);
+    bool execv(PID runPid, const char* path, int, char**) {             // SYSCALL - Execute a new program. Arguments are not passed to the program yet.
+        PID pid = scheduler::createProcess(path);
+        if (pid != NULL) {                                              // Program found and process control block created successfully.
+            scheduler::resumeProcess(pid);
         }
-        // Terminate this process
-        scheduler::processTerminate(runPid);
-        resumeProcess = false;                      // Process is being terminated so we can't resume its execution.
+        runPid->registers->eax = (unsigned int) pid;                     // Save process id in the eax to be returned in the function call.
+        return true;
+    }
+
+    bool clearScreen(PID) {                                             // SYSCALL - Clear vga screen and set cursor at col:0, row:0.
+        vga::clearScreen();
+        return true;
+    }
 
-    } else if (r->eax == SYSCALL_READLN) {          // SYSCALL - Process wants to receive one input line from keyboad.
+    bool nullSyscall(PID runPid) {                                      // SYSCALL - Do nothing, only the syscall entry and exit cost is measured.
+        runPid->registers->eax = 0;
+        return true;
+    }
 
-        scheduler::kbdAskResource(runPid);
-        resumeProcess = false;                      // Process is waiting for keyboard resource to resume its execution.
+    bool sleep(PID, unsigned int millis) {                              // SYSCALL - Block the process for the given milliseconds.
+        pit::sleep(millis);
+        return true;
+    }
 
-    } else if (r->eax == SYSCALL_MALLOC) {          // SYSCALL - Dynamic allocate memory in process heap space.
+    bool clockGettime(PID runPid, unsigned int clockId, Timespec* ts) { // SYSCALL - Get the time of the given clock, -1 if the clock is not supported or ts isn't in the process memory.
+        if (!scheduler::isUserMemory(runPid, ts, sizeof(Timespec))) {
+            runPid->registers->eax = (unsigned int) -1;
+            return true;
+        }
+        runPid->registers->eax = clock::getTime(clockId, ts) ? 0 : (unsigned int) -1;
+        return true;
+    }
 
-        runPid->registers.EAX = (unsigned int) heap::malloc(&runPid->processHeap, runPid->registers.EBX);
+    bool printLockStats(PID) {                                          // SYSCALL - Print the contention counters of the kernel locks.
+        lockstat::print();
+        return true;
+    }
 
-    } else if (r->eax == SYSCALL_FREE) {            // SYSCALL - Dynamic free memory in process heap space.
+    bool printIrqStats(PID) {                                           // SYSCALL - Print the counters, handler cycles and spurious interruptions of each IRQ.
+        isr::printIrqStats();
+        return true;
+    }
 
-        heap::free(&runPid->processHeap, (void*) runPid->registers.EBX);
+    bool printKernelLog(PID) {                                          // SYSCALL - Print the kernel log records kept in the ring, with their timestamps.
+        klog::print();
+        return true;
+    }
 
-    } else if (r->eax == SYSCALL_PSLIST) {          // SYSCALL -  Print process list in terminal.
+    bool write(PID runPid, int fd, const char* buf, unsigned int length) { // SYSCALL - Write a buffer of the given length on the console of the process.
+        if ((fd != STDOUT_FILENO && fd != STDERR_FILENO) || !scheduler::isUserMemory(runPid, buf, length)) {
+            runPid->registers->eax = (unsigned int) -1;
+            return true;
+        }
+        vga::write(runPid->console, VGA_DEF_FORECOLOR, VGA_DEF_BGCOLOR, buf, length);
+        runPid->registers->eax = length;
+        return true;
+    }
+}
 
-        scheduler::printProcessList();
-    
-    } else if (r->eax == SYSCALL_EXEC_PROGRAM) {    // SYSCALL -  Execute a new program.
+uint8_t syscalls::install() {
+    int i;
 
-        runPid->registers.EAX = (unsigned int) scheduler::createProcess((char*) runPid->registers.ESI); // Save process id in the eax to be returned in the function call.
-        if (runPid->registers.EAX != NULL) {                                                            // Program found and process control block created successfully.
-            scheduler::resumeProcess((PID) runPid->registers.EAX);
-        }  
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    for (i = 0; i < SYSCALL_TABLE_SIZE; i++) {
+        syscallTable[i] = NULL;
+    }
 
-    } else if (r->eax == SYSCALL_CLEAR_SCREEN) { // SYSCALL -  Clear vga screen and set cursor at col:0, row:0.
-        
-        vga::clearScreen();
+    // Fill the dispatch table with the entries defined in syscalls.def
+    #define SYSCALL_TABLE_SET(NUMBER, FUNC) \
+        static_assert(NUMBER > 0 && NUMBER < SYSCALL_TABLE_SIZE, "Syscall number out of the dispatch table"); \
+        syscallTable[NUMBER] = handlers::FUNC##Entry;
+    #define SYSCALL0(NUMBER, NAME, RET, FUNC) SYSCALL_TABLE_SET(NUMBER, FUNC)
+    #define SYSCALL1(NUMBER, NAME, RET, FUNC, R1, T1, A1) SYSCALL_TABLE_SET(NUMBER, FUNC)
+    #define SYSCALL2(NUMBER, NAME, RET, FUNC, R1, T1, A1, R2, T2, A2) SYSCALL_TABLE_SET(NUMBER, FUNC)
+    #define SYSCALL3(NUMBER, NAME, RET, FUNC, R1, T1, A1, R2, T2, A2, R3, T3, A3) SYSCALL_TABLE_SET(NUMBER, FUNC)
+    #include "syscalls.def"
+    #undef SYSCALL0
+    #undef SYSCALL1
+    #undef SYSCALL2
+    #undef SYSCALL3
+    #undef SYSCALL_TABLE_SET
+
+    return syscalls::installCpu(0);
+}
+
+uint8_t syscalls::installCpu(uint8_t cpu) {
+    if (!cpuid::hasSep()) {
+        return SYSCALLS_ERROR_SEP_NOT_PRESENT;
     }
 
-    if (resumeProcess) {
-        // Add this process to the ready queue again to continue its execution.
-        scheduler::resumeProcess(runPid);
+    msr::write(MSR_IA32_SYSENTER_CS, GDT_KERNEL_CODE_SEL);          // Kernel CS=0x08, SS=0x10, user CS=0x1B, user SS=0x23
+    msr::write(MSR_IA32_SYSENTER_ESP, (uint32_t) gdt::getTss(cpu)); // Not a stack, sysenter_entry loads the process kernel stack from this cpu TSS
+    msr::write(MSR_IA32_SYSENTER_EIP, (uint32_t) sysenter_entry);
+
+    return SYSCALLS_NO_ERROR;
+}
+
+/**
+ * @brief Execute the system call requested by the running process in its saved EAX.
+ * 
+ * @param runPid    Running process
+ * @return true     Process can continue its execution
+ * @return false    Process was terminated or is waiting for a resource
+ */
+bool syscallDispatch(PID runPid) {
+    unsigned int syscall = runPid->registers->eax;
+
+    if (syscall >= SYSCALL_TABLE_SIZE || syscallTable[syscall] == NULL) { // Unknown syscall number
+        runPid->registers->eax = SYSCALL_ERROR_INVALID;
+        return true;
     }
 
-    scheduler::start();
+    return syscallTable[syscall](runPid);
+}
+
+void syscalls::syscallHandler(IntRegisters* r) {
+    // Get current running process, its user registers are saved on its kernel stack
+    PID runPid = scheduler::getRunningProcess();
+    runPid->registers = r;
+
+    // KPRINTF("ISR(48 - 0x30) - (EAX=0x%x) - (EBX=0x%x) - (ECX=0x%x) - (EDX=0x%x)\n", r->eax, r->ebx, r->ecx, r->edx);
+    // KPRINTF("                 (ESP=0x%x) - (EIP=0x%x) - (ESI=0x%x) - (EDI=0x%x)\n", r->esp, r->eip, r->esi, r->edi);
+    if (!syscallDispatch(runPid)) {
+        scheduler::schedule();                  // Process was terminated or is waiting for a resource, execute the next one
+    } else if (scheduler::hasReadyProcesses()) {
+        scheduler::yield();                     // Give the cpu to the other ready processes before continue
+    }
+    // Fast path when no other process is ready: return directly to the caller
 }
\ No newline at end of file
@@ -3,24 +3,51 @@
 #define _SYSCALLS_H_
 
 #include "isr.h"
+#include "syscall_numbers.h"
 
 
-#define SYSCALL_PRINT             1    // Print text on screen equivalent to vga::printStr("text\n");
-#define SYSCALL_PROC_EXIT         2    // Called when a proccess finish it's execution. Remove from queue and move to the next proccess;
-#define SYSCALL_READLN            3    // Read line from console
-#define SYSCALL_MALLOC            4    // Dynamic allocate memory in process heap.
-#define SYSCALL_FREE              5    // Dynamic free memory in process heap.
-#define SYSCALL_PSLIST            6    // Print process list in terminal.
-#define SYSCALL_EXEC_PROGRAM      7    // Executes a program
-#define SYSCALL_TERMINATE_PROCESS 8    // Executes a program
-#define SYSCALL_CLEAR_SCREEN      9    // Clears the text on screen equivalent to vga::clearScreen();
+#define SYSCALL_TABLE_SIZE 64           // Max syscall number + 1. Syscall numbers are defined in syscalls.def
+#define SYSCALL_ERROR_INVALID 0xFFFFFFFF // EAX returned when the syscall number has no handler
 
-// #define SYSCALL_EXEC_PROGRAM 105 //execute program
-// #define SYSCALL_TERMINATE_PROCESS 106 //terminate running process
-// #define SYSCALL_PRINT_PROCESSES 107
+#define SYSCALLS_NO_ERROR 0                 // No error happend. Same as Success
+#define SYSCALLS_ERROR_SEP_NOT_PRESENT 1    // Cpu don't support SYSENTER/SYSEXIT, only int 0x30 can be used
+
+#define STDOUT_FILENO 1                     // File descriptors accepted by SYSCALL_WRITE, both are the console of the process
+#define STDERR_FILENO 2
+
+/**
+ * @brief Sysenter entry point imported from isr_int.asm
+ * 
+ */
+extern "C" void sysenter_entry();
 
 namespace syscalls {
+    /**
+     * @brief Build the syscall dispatch table from syscalls.def.
+     *        Then configure the SYSENTER MSRs to enter the kernel at sysenter_entry using the kernel stack.
+     *        The int 0x30 gate is always available as fallback.
+     * 
+     * @return uint8_t 0=SYSCALLS_NO_ERROR, 1=SYSCALLS_ERROR_SEP_NOT_PRESENT
+     */
+    uint8_t install();
+
+    /**
+     * @brief Configure the SYSENTER MSRs of a cpu. Called by syscalls::install for the bootstrap processor and by each
+     *        application processor. The MSRs are per cpu, each one points to the TSS of its cpu.
+     * 
+     * @param cpu       Cpu index
+     * @return uint8_t  0=SYSCALLS_NO_ERROR, 1=SYSCALLS_ERROR_SEP_NOT_PRESENT
+     */
+    uint8_t installCpu(uint8_t cpu);
+
+    /**
+     * @brief Handle a system call requested through int 0x30 or SYSENTER.
+     *        Returns when the caller can continue its execution, then isr_stub_48 or sysenter_entry returns to ring 3.
+     *        Meanwhile the scheduler may execute other processes.
+     * 
+     * @param r Registers pushed by isr_stub_48 or sysenter_entry on the process kernel stack. EAX receives the syscall return value.
+     */
     void syscallHandler(IntRegisters* r);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,197 @@
+// stdlibs
+#include "stdlib.h"
+// sys
+#include "timer.h"
+
+Timer* rootWheel[TIMER_ROOT_SIZE];                      // Timers of the next 256 ticks
+Timer* levelWheels[TIMER_LEVELS][TIMER_LEVEL_SIZE];     // Timers of the farther ticks, cascaded when the wheel below wraps around
+uint32_t timerTicks;                                    // Next tick to be processed
+
+/**
+ * @brief Link the timer at the front of the given slot
+ * 
+ * @param slot  Wheel slot
+ * @param t     Timer
+ */
+void slotAdd(Timer** slot, Timer* t) {
+    t->slot = slot;
+    t->prev = NULL;
+    t->next = *slot;
+    if (*slot != NULL) {
+        (*slot)->prev = t;
+    }
+    *slot = t;
+}
+
+/**
+ * @brief Unlink the timer from its slot
+ * 
+ * @param t     Timer
+ */
+void slotRemove(Timer* t) {
+    if (t->prev != NULL) {
+        t->prev->next = t->next;
+    } else {
+        *t->slot = t->next;
+    }
+    if (t->next != NULL) {
+        t->next->prev = t->prev;
+    }
+    t->slot = NULL;
+    t->next = NULL;
+    t->prev = NULL;
+}
+
+/**
+ * @brief Link the timer in the slot of the wheel that covers the distance between its expire tick and the current tick
+ * 
+ * @param t     Timer
+ */
+void wheelAdd(Timer* t) {
+    uint32_t expires = t->expires;
+    uint32_t distance = expires - timerTicks;
+    Timer** slot;
+
+    if (distance < TIMER_ROOT_SIZE) {
+        slot = &rootWheel[expires & TIMER_ROOT_MASK];
+    } else if (distance < 1u << (TIMER_ROOT_BITS + TIMER_LEVEL_BITS)) {
+        slot = &levelWheels[0][(expires >> TIMER_ROOT_BITS) & TIMER_LEVEL_MASK];
+    } else if (distance < 1u << (TIMER_ROOT_BITS + 2 * TIMER_LEVEL_BITS)) {
+        slot = &levelWheels[1][(expires >> (TIMER_ROOT_BITS + TIMER_LEVEL_BITS)) & TIMER_LEVEL_MASK];
+    } else if (distance < 1u << (TIMER_ROOT_BITS + 3 * TIMER_LEVEL_BITS)) {
+        slot = &levelWheels[2][(expires >> (TIMER_ROOT_BITS + 2 * TIMER_LEVEL_BITS)) & TIMER_LEVEL_MASK];
+    } else if ((int32_t) distance < 0) {                // Already expired, run it on the next tick
+        slot = &rootWheel[timerTicks & TIMER_ROOT_MASK];
+    } else {
+        slot = &levelWheels[3][(expires >> (TIMER_ROOT_BITS + 3 * TIMER_LEVEL_BITS)) & TIMER_LEVEL_MASK];
+    }
+
+    slotAdd(slot, t);
+}
+
+/**
+ * @brief Move the timers of the given upper wheel slot to the lower wheels
+ * 
+ * @param level         Upper wheel
+ * @param index         Slot index
+ * @return uint32_t     The slot index. 0 means the wheel wrapped around and the next upper wheel must be cascaded too.
+ */
+uint32_t cascade(int level, uint32_t index) {
+    Timer* t = levelWheels[level][index];
+    Timer* next;
+
+    levelWheels[level][index] = NULL;
+    while (t != NULL) {
+        next = t->next;
+        wheelAdd(t);
+        t = next;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Slot of the given upper wheel that contains the current tick
+ * 
+ * @param level         Upper wheel
+ * @return uint32_t     Slot index
+ */
+uint32_t levelIndex(int level) {
+    return (timerTicks >> (TIMER_ROOT_BITS + level * TIMER_LEVEL_BITS)) & TIMER_LEVEL_MASK;
+}
+
+void timer::install() {
+    int i;
+    int j;
+
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    for (i = 0; i < TIMER_ROOT_SIZE; i++) {
+        rootWheel[i] = NULL;
+    }
+    for (i = 0; i < TIMER_LEVELS; i++) {
+        for (j = 0; j < TIMER_LEVEL_SIZE; j++) {
+            levelWheels[i][j] = NULL;
+        }
+    }
+    timerTicks = 0;
+}
+
+void timer::init(Timer* t, TimerCallback callback, void* data) {
+    t->next = NULL;
+    t->prev = NULL;
+    t->slot = NULL;
+    t->expires = 0;
+    t->callback = callback;
+    t->data = data;
+}
+
+void timer::add(Timer* t, uint32_t expires) {
+    if (t->slot != NULL) {
+        slotRemove(t);
+    }
+    t->expires = expires;
+    wheelAdd(t);
+}
+
+bool timer::cancel(Timer* t) {
+    if (t->slot == NULL) {
+        return false;
+    }
+    slotRemove(t);
+    return true;
+}
+
+bool timer::pending(Timer* t) {
+    return t->slot != NULL;
+}
+
+void timer::tick() {
+    uint32_t index = timerTicks & TIMER_ROOT_MASK;
+    Timer* expired;
+    Timer* t;
+
+    // Root wheel wrapped around, cascade the upper wheels
+    if (index == 0 && cascade(0, levelIndex(0)) == 0 && cascade(1, levelIndex(1)) == 0 && cascade(2, levelIndex(2)) == 0) {
+        cascade(3, levelIndex(3));
+    }
+
+    timerTicks++;
+
+    // Detach the timers of this tick, so a callback that adds a timer 256 ticks ahead can't link it in the slot being run.
+    expired = rootWheel[index];
+    rootWheel[index] = NULL;
+    for (t = expired; t != NULL; t = t->next) {
+        t->slot = &expired;
+    }
+
+    // Run the expired timers. Callbacks may add or cancel any timer, including the other expired ones.
+    while ((t = expired) != NULL) {
+        slotRemove(t);
+        t->callback(t->data);
+    }
+}
+
+uint32_t timer::ticksToNextTimer(uint32_t max) {
+    uint32_t i;
+    uint32_t tick;
+    uint32_t index;
+
+    for (i = 0; i < max; i++) {
+        tick = timerTicks + i;
+        if ((tick & TIMER_ROOT_MASK) == 0) { // Root wheel wraps around on this tick
+            index = (tick >> TIMER_ROOT_BITS) & TIMER_LEVEL_MASK;
+            if (index == 0 || levelWheels[0][index] != NULL) { // Timers to cascade
+                return i + 1;
+            }
+        }
+        if (rootWheel[tick & TIMER_ROOT_MASK] != NULL) {
+            return i + 1;
+        }
+    }
+
+    return max;
+}
+
+uint32_t timer::getTicks() {
+    return timerTicks;
+}
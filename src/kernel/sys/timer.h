@@ -0,0 +1,115 @@
+#pragma once
+#ifndef _TIMER_H_
+#define _TIMER_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TIMER_ROOT_BITS 8                               // Bits of the expire tick indexed by the root wheel
+#define TIMER_LEVEL_BITS 6                              // Bits of the expire tick indexed by each upper wheel
+#define TIMER_LEVELS 4                                  // Upper wheels. 8 + 4 * 6 = 32 bits, the whole tick range
+#define TIMER_ROOT_SIZE (1 << TIMER_ROOT_BITS)          // 256 slots, one per tick
+#define TIMER_LEVEL_SIZE (1 << TIMER_LEVEL_BITS)        // 64 slots per upper wheel
+#define TIMER_ROOT_MASK (TIMER_ROOT_SIZE - 1)
+#define TIMER_LEVEL_MASK (TIMER_LEVEL_SIZE - 1)
+
+/**
+ * @brief Function called from the timer interruption when the timer expires
+ * 
+ */
+typedef void (*TimerCallback)(void* data);
+
+/**
+ * @brief Kernel timer. Allocated by its owner (E.g inside the PCB), the wheel only links it.
+ * 
+ */
+typedef struct Timer {
+    struct Timer* next;                                 // Next timer in the same wheel slot
+    struct Timer* prev;                                 // Previous timer in the same wheel slot
+    struct Timer** slot;                                // Wheel slot where the timer is linked, NULL when not pending
+    uint32_t expires;                                   // Tick when the timer expires
+    TimerCallback callback;                             // Called when the timer expires
+    void* data;                                         // Argument passed to the callback
+} Timer;
+
+/**
+ * @brief TIMER - Kernel timers driven by the timer interruption (IRQ0)
+ * 
+ * HIERARCHICAL_TIMER_WHEEL:
+ *    - The root wheel has 256 slots, one for each of the next 256 ticks.
+ *    - Each upper wheel has 64 slots, each slot covers 64 times the range of a slot of the wheel below.
+ *    - A timer is linked in the slot of the expire tick bits of the wheel that covers its distance to the current tick. Insert and cancel are O(1).
+ *    - When the root wheel wraps around, the next slot of the first upper wheel is cascaded: its timers are linked again in lower wheels.
+ *      The same happens with the upper wheels when the wheel below wraps around.
+ *    - Each tick only runs the timers of one root slot, so thousands of pending timers don't slow down the interruption.
+ */
+namespace timer {
+    /**
+     * @brief Initialize the timer wheels. Must be called before the timer interruption is enabled.
+     * 
+     */
+    void install();
+
+    /**
+     * @brief Initialize a timer. It's not pending until timer::add is called.
+     * 
+     * @param t         Timer
+     * @param callback  Function called when the timer expires
+     * @param data      Argument passed to the callback
+     */
+    void init(Timer* t, TimerCallback callback, void* data);
+
+    /**
+     * @brief Start the timer. If it's already pending it's restarted with the new expire tick.
+     * 
+     * @param t         Timer initialized by timer::init
+     * @param expires   Tick when the timer expires. Ticks already passed expire on the next tick.
+     */
+    void add(Timer* t, uint32_t expires);
+
+    /**
+     * @brief Stop the timer if it's pending
+     * 
+     * @param t         Timer
+     * @return true     Timer was pending and was cancelled
+     * @return false    Timer wasn't pending
+     */
+    bool cancel(Timer* t);
+
+    /**
+     * @brief Check if the timer is waiting to expire
+     * 
+     * @param t         Timer
+     * @return true     Timer is pending
+     * @return false    Timer expired, was cancelled or was never added
+     */
+    bool pending(Timer* t);
+
+    /**
+     * @brief Advance one tick and run the expired timers. Called by the timer interruption handler.
+     * 
+     */
+    void tick();
+
+    /**
+     * @brief Get how many ticks can elapse before a timer must run. Used to program the timer in one-shot mode while idle.
+     * 
+     *  The scan can go past one lap of the root wheel (E.g TICKLESS_MAX_TICKS_HPET = 2048 ticks): the root slots of the
+     *  next laps are the same slots already found empty, and each root wrap around checks the level 0 slot that would be
+     *  cascaded on it, so a timer linked in an upper wheel is never skipped. The scan is O(max).
+     * 
+     * @param max       Max ticks returned
+     * @return uint32_t Calls to timer::tick until the next timer runs or an upper wheel must be cascaded, or max
+     */
+    uint32_t ticksToNextTimer(uint32_t max);
+
+    /**
+     * @brief Get the ticks elapsed since install
+     * 
+     * @return uint32_t Current tick
+     */
+    uint32_t getTicks();
+}
+
+#endif
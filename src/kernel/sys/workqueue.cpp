@@ -0,0 +1,116 @@
+// stdlibs
+#include "stdlib.h"
+#include "string.h"
+// cpu
+#include "smp.h"
+// process
+#include "queue.h"
+#include "scheduler.h"
+// sys
+#include "spinlock.h"
+#include "workqueue.h"
+
+Work* workHead;                 // Work list, run in queue order
+Work* workTail;
+Spinlock workLock;              // Protects the work list, taken by the tasklets with the interruptions enabled
+Queue workerWaitQueue;          // Workers blocked on an empty work list
+bool workersStarted;            // The scheduler is ready, queued work wakes up a worker
+uint32_t workRuns;
+
+/**
+ * @brief Entry point of the worker threads. Runs the work list forever, blocking when it's empty.
+ *
+ */
+void workqueueWorker() {
+    Work* work;
+    uint32_t flags;
+
+    while (true) {
+        flags = spinlock::acquireIrqSave(&workLock);
+        work = workHead;
+        if (work == NULL) {
+            scheduler::block(&workerWaitQueue, PROC_STATE_WAITING, &workLock);  // Woken up by workqueue::queue
+            continue;
+        }
+        workHead = work->next;
+        if (workHead == NULL) {
+            workTail = NULL;
+        }
+        work->next = NULL;
+        work->pending = false;                  // Can be queued again while it runs
+        spinlock::releaseIrqRestore(&workLock, flags);
+
+        asm volatile("sti" : /* output */ : /* input */ : /* clobbers */ "memory");
+        work->func(work->data);
+        asm volatile("cli" : /* output */ : /* input */ : /* clobbers */ "memory");
+        workRuns++;
+
+        if (scheduler::hasReadyProcesses()) {   // Kernel threads aren't preempted
+            scheduler::yield();
+        }
+    }
+}
+
+void workqueue::install() {
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    workHead = NULL;
+    workTail = NULL;
+    spinlock::init(&workLock, "workqueue");
+    queue::init(&workerWaitQueue);
+    workersStarted = false;
+    workRuns = 0;
+}
+
+void workqueue::startWorkers() {
+    uint8_t i;
+    char name[16];
+    PID pid;
+
+    for (i = 0; i < smp::getCpuCount(); i++) {
+        string::strcpy(name, WORKQUEUE_NAME "/");
+        stdlib::uitoa(i, 10, name + string::strlen(name));
+        pid = scheduler::createKernelThread(name, workqueueWorker);
+        if (pid == NULL) {
+            break;
+        }
+        pid->cpu = i;                           // Each worker starts on its own cpu
+        scheduler::resumeProcess(pid);
+    }
+    workersStarted = true;                      // The workers find the work queued before they started
+}
+
+void workqueue::initWork(Work* work, work_t func, void* data) {
+    work->func = func;
+    work->data = data;
+    work->pending = false;
+    work->next = NULL;
+}
+
+bool workqueue::queue(Work* work) {
+    uint32_t flags;
+
+    flags = spinlock::acquireIrqSave(&workLock);
+    if (work->pending) {
+        spinlock::releaseIrqRestore(&workLock, flags);
+        return false;
+    }
+    work->pending = true;
+    work->next = NULL;
+    if (workTail == NULL) {
+        workHead = work;
+    } else {
+        workTail->next = work;
+    }
+    workTail = work;
+    spinlock::releaseIrqRestore(&workLock, flags);
+
+    // A worker that found the list empty is already in the wait queue, block adds it before releasing workLock
+    if (workersStarted) {
+        scheduler::wakeUpOne(&workerWaitQueue);
+    }
+    return true;
+}
+
+uint32_t workqueue::getWorkRuns() {
+    return workRuns;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#ifndef _WORKQUEUE_H_
+#define _WORKQUEUE_H_
+
+// libc
+#include <stdint.h>
+#include <stdbool.h>
+
+#define WORKQUEUE_NAME "kworker"                // Worker threads are listed as kworker/<cpu>
+
+/**
+ * @brief Function of a work item
+ *
+ */
+typedef void (*work_t)(void* data);
+
+/**
+ * @brief Deferred work run by a worker thread
+ *
+ */
+typedef struct Work {
+    work_t func;                                // Called by a worker thread with the interruptions enabled
+    void* data;                                 // Argument of func
+    volatile bool pending;                      // In the work list, queueing it again does nothing
+    struct Work* next;                          // Next work in the work list
+} Work;
+
+/**
+ * @brief WORKQUEUE - Kernel worker threads
+ *
+ *    - One worker thread per cpu, created by workqueue::startWorkers. A worker is a kernel thread: it has a PCB and a kernel
+ *      stack, but no user memory, and it runs in ring 0 with the kernel lock held.
+ *    - The work items are queued in a single list, by the tasklets or the syscalls. The first blocked worker is woken up and
+ *      runs the items in order, with the interruptions enabled.
+ *    - Kernel threads aren't preempted by the timer, a worker yields after each item when other processes are ready.
+ *    - Unlike a tasklet a work item can block, E.g on a mutex.
+ */
+namespace workqueue {
+    /**
+     * @brief Initialize the work list. Must be called before the interruptions are enabled, work queued before the
+     *        workers are started runs once they are.
+     *
+     */
+    void install();
+
+    /**
+     * @brief Create the worker threads, one per online cpu. Requires the kernel heap and the scheduler.
+     *
+     */
+    void startWorkers();
+
+    /**
+     * @brief Initialize a work item
+     *
+     * @param work  Work item
+     * @param func  Function called when the work runs
+     * @param data  Argument of func
+     */
+    void initWork(Work* work, work_t func, void* data);
+
+    /**
+     * @brief Add a work item at the end of the work list and wake up a worker, unless it's already pending.
+     *        Can be called from a tasklet or a syscall.
+     *
+     * @param work      Work item
+     * @return true     Queued
+     * @return false    Already pending
+     */
+    bool queue(Work* work);
+
+    /**
+     * @brief Get the work items run by the workers
+     *
+     * @return uint32_t Work items run since workqueue::startWorkers
+     */
+    uint32_t getWorkRuns();
+}
+
+#endif
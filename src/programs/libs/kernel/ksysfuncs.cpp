@@ -7,15 +7,19 @@
 // sys
 #include "ksysfuncs.h"
 
-// -------------- SYSCALLS ARE DEFINED IN ./src/kernel/sys/syscalls.h ------------------
-#define SYSCALL_PRINT       1         // Print text on screen vga print("myText\n");
-#define SYSCALL_PROC_EXIT   2         // Called when a proccess finish it's execution. Remove from queue and move to the next proccess;
-#define SYSCALL_READLN      3         // Process wait until one line from console terminal is returned;
-#define SYSCALL_MALLOC      4         // Dynamic allocate memory in process heap.
-#define SYSCALL_FREE        5         // Dynamic free memory in process heap.
-#define SYSCALL_PSLIST      6         // Print process list in terminal.
+// -------------- SYSCALLS ARE DEFINED IN ./src/kernel/sys/syscalls.def ------------------
+#include "syscall_numbers.h"
 
-#define PRINTF_STR_BUFFER_SIZE 1024
+#define PRINTF_CHUNK_SIZE 128          // The formatted text is printed in pieces of this size, it's never truncated
+
+/**
+ * @brief Piece of the printf text waiting to be printed
+ *
+ */
+typedef struct {
+    char text[PRINTF_CHUNK_SIZE];
+    unsigned int length;
+} PrintfChunk;
 
 /**
  * @brief Access the main function of the executable process
@@ -31,76 +35,93 @@ void __attribute__((section("._start"))) _start() {
     ksysfuncs::exit(main());
 }
 
-void ksysfuncs::print(const char* str) { // Executes the interruption INT=(0x30=48) with EAX=(0x01=1=SYSCALL_PRINT) with ESI=(const char*=text_to_print)
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "mov %1, %%esi;"
-        "int $0x30;" 
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_PRINT), "r"(str)
-        : /* clobbers */ "eax", "esi"
-    );
-}
+/**
+ * @brief Enter the kernel with the interruption INT=(0x30=48) with EAX=(syscall number), EBX, ESI and EDI arguments.
+ * 
+ * @return unsigned int EAX returned by the kernel
+ */
+unsigned int syscall(unsigned int number, unsigned int ebx, unsigned int esi, unsigned int edi) {
+    unsigned int ret;
 
-void ksysfuncs::exit(int code) { // Executes the interruption INT=(0x30=48) with EAX=(0x02=2=SYSCALL_PROC_EXIT) and EBX=(code={0=SUCCESS or ERROR_CODE}) - Remove proccess from queue get the return code and move to the next proccess
     __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "mov %1, %%ebx;"
-        "int $0x30;" 
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_PROC_EXIT), "r"(code)
-        : /* clobbers */ "eax", "ebx"
+        "int $0x30;"
+        : /* output */ "=a"(ret)
+        : /* input */ "a"(number), "b"(ebx), "S"(esi), "D"(edi)
+        : /* clobbers */ "memory"
     );
+    return ret;
 }
 
-void ksysfuncs::printf(const char* str, ...) { // Format the string and redirects to print func
-    char fStr[PRINTF_STR_BUFFER_SIZE];
-    va_list list;
-    va_start(list, str);
-    stdlib::va_stringf(fStr, str, list);
-    va_end(list);
-    print(fStr);
-}
+/**
+ * @brief Registers that hold the syscall arguments
+ * 
+ */
+typedef struct {
+    unsigned int ebx, esi, edi;
+} SyscallArgs;
 
-void ksysfuncs::readln(char* dest) { // Executes the interruption INT=(0x30=48) with EAX=(0x03=3=SYSCALL_READLN) with no parameters(E.g The process scheduler already knows wich process is running)
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "mov %1, %%edi;"
-        "int $0x30;" 
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_READLN), "r"(dest)
-        : /* clobbers */ "eax", "edi"
-    );
-}
+// Generate the ksysfuncs functions defined in syscalls.def. Each argument is marshalled into the register defined for it.
+#define SYSCALL0(NUMBER, NAME, RET, FUNC) \
+    RET ksysfuncs::FUNC() { \
+        return (RET) syscall(NUMBER, 0, 0, 0); \
+    }
+#define SYSCALL1(NUMBER, NAME, RET, FUNC, R1, T1, A1) \
+    RET ksysfuncs::FUNC(T1 A1) { \
+        SyscallArgs args = {0, 0, 0}; \
+        args.R1 = (unsigned int) A1; \
+        return (RET) syscall(NUMBER, args.ebx, args.esi, args.edi); \
+    }
+#define SYSCALL2(NUMBER, NAME, RET, FUNC, R1, T1, A1, R2, T2, A2) \
+    RET ksysfuncs::FUNC(T1 A1, T2 A2) { \
+        SyscallArgs args = {0, 0, 0}; \
+        args.R1 = (unsigned int) A1; \
+        args.R2 = (unsigned int) A2; \
+        return (RET) syscall(NUMBER, args.ebx, args.esi, args.edi); \
+    }
+#define SYSCALL3(NUMBER, NAME, RET, FUNC, R1, T1, A1, R2, T2, A2, R3, T3, A3) \
+    RET ksysfuncs::FUNC(T1 A1, T2 A2, T3 A3) { \
+        SyscallArgs args = {0, 0, 0}; \
+        args.R1 = (unsigned int) A1; \
+        args.R2 = (unsigned int) A2; \
+        args.R3 = (unsigned int) A3; \
+        return (RET) syscall(NUMBER, args.ebx, args.esi, args.edi); \
+    }
+#include "syscalls.def"
+#undef SYSCALL0
+#undef SYSCALL1
+#undef SYSCALL2
+#undef SYSCALL3
 
-unsigned int ksysfuncs::malloc(unsigned int size) { // Executes the interruption INT=(0x30=48) with EAX=(0x04=4=SYSCALL_MALLOC) with EBX=(unsigned int = sizeOf memory being allocated) returns EAX=(Start address of the allocated memory block or 0 if fails)
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "mov %1, %%ebx;"
-        "int $0x30;"
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_MALLOC), "r"(size)
-        : /* clobbers */ "eax", "ebx"
-    );
-}
+/**
+ * @brief Sink of printf. Collects the formatted text and prints it each time the chunk is full.
+ *
+ * @param context   PrintfChunk
+ * @param text      Piece of the formatted text
+ * @param length    Chars of the piece
+ */
+void printfSink(void* context, const char* text, uint32_t length) {
+    PrintfChunk* chunk = (PrintfChunk*) context;
+    uint32_t i;
 
-void ksysfuncs::free(void* ptr) { // // Executes the interruption INT=(0x30=48) with EAX=(0x05=5=SYSCALL_FREE) with EBX=(unsigned int = ptr address of the heap dynamic memory block to be free)
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "mov %1, %%ebx;"
-        "int $0x30;"
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_FREE), "r"(ptr)
-        : /* clobbers */ "eax", "ebx"
-    );
+    for (i = 0; i < length; i++) {
+        if (chunk->length == PRINTF_CHUNK_SIZE - 1) {
+            chunk->text[chunk->length] = 0;
+            ksysfuncs::print(chunk->text);
+            chunk->length = 0;
+        }
+        chunk->text[chunk->length++] = text[i];
+    }
 }
 
-void ksysfuncs::printProcessList() { // Executes the interruption INT=(0x30=48) with EAX=(0x02=2=SYSCALL_PROC_EXIT)
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "int $0x30;" 
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_PSLIST)
-        : /* clobbers */ "eax"
-    );
-}
\ No newline at end of file
+void ksysfuncs::printf(const char* str, ...) { // Format the string, the sink prints it a chunk at a time
+    PrintfChunk chunk;
+    va_list list;
+    chunk.length = 0;
+    va_start(list, str);
+    stdlib::va_formatf(printfSink, &chunk, str, list);
+    va_end(list);
+    if (chunk.length > 0) {
+        chunk.text[chunk.length] = 0;
+        print(chunk.text);
+    }
+}
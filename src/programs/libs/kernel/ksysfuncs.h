@@ -2,6 +2,25 @@
 #ifndef _KSYSFUNCS_H_
 #define _KSYSFUNCS_H_
 
+#define CLOCK_MONOTONIC       1     // Time since boot, never goes backwards
+
+#define STDOUT_FILENO         1     // File descriptors of write, both are the console of the process. Same as src/kernel/sys/syscalls.h
+#define STDERR_FILENO         2
+
+/**
+ * @brief Time split in seconds and nanoseconds. Same layout as the kernel Timespec (src/kernel/sys/clock.h)
+ * 
+ */
+typedef struct {
+    unsigned int tv_sec;            // Seconds
+    unsigned int tv_nsec;           // Nanoseconds, 0 to 999999999
+} Timespec;
+
+/**
+ * @brief Functions of the kernel programs. The system calls are generated from src/kernel/sys/syscalls.def,
+ *        they always enter the kernel with the interruption INT=(0x30=48).
+ * 
+ */
 namespace ksysfuncs {
     /**
      * @brief Prints a raw string text with only the Escape Sequences
@@ -10,8 +29,9 @@ namespace ksysfuncs {
      * 
      *  ESCAPE_SEQUENCES: 
      *    - \n Line feed or new line
+     *    - ESC[ (\033[) ANSI CSI sequences, see src/kernel/drivers/legacy/vga.h
      * 
-     *  MAX_TEXT_SIZE: 1024 chars long
+     *  The text is read by the kernel until its null char, it has no maximum size.
      * 
      */
     void print(const char *str);
@@ -76,6 +96,75 @@ namespace ksysfuncs {
      * 
      */
     void printProcessList();
+
+    /**
+     * @brief Execute a program
+     * 
+     * @param path  Program path.
+     * @param argc  Arguments count to be passed to program.
+     * @param argv  Arguments to be passed to program.
+     * @return 0=Program not found or not created, or PCB id.
+     */
+    int execv(const char* path, int argc, char* argv[]);
+
+    /**
+     * @brief Clear the vga screen
+     * 
+     */
+    void clearScreen();
+
+    /**
+     * @brief System call that does nothing. Used to measure the cost of entering and leaving the kernel.
+     * 
+     */
+    void nullSyscall();
+
+    /**
+     * @brief Block this process for the given time. Other processes are executed meanwhile.
+     * 
+     * @param millis Milliseconds to sleep
+     */
+    void sleep(unsigned int millis);
+
+    /**
+     * @brief Get the time of a clock with nanoseconds resolution. The kernel measures it with the TSC calibrated against the PIT.
+     * 
+     * @param clockId   CLOCK_MONOTONIC
+     * @param ts        Filled with the time
+     * @return int      0 on success, -1 if the clock is not supported or ts isn't in the process memory
+     */
+    int clockGettime(unsigned int clockId, Timespec* ts);
+
+    /**
+     * @brief Print the contention counters of the kernel locks: acquisitions, acquisitions that had to wait and waits
+     * 
+     */
+    void printLockStats();
+
+    /**
+     * @brief Print the counters of each IRQ: interruptions, the ones since the last call, spurious IRQ7/IRQ15,
+     *        handler cycles with their histogram, and the longest interruptions-off time of each cpu
+     * 
+     */
+    void printIrqStats();
+
+    /**
+     * @brief Print the kernel log kept in the ring buffer, each line with its time since boot [seconds.microseconds]
+     * 
+     */
+    void printKernelLog();
+
+    /**
+     * @brief Write a buffer to a file descriptor, the null chars are written too
+     * 
+     * Executes the interruption INT=(0x30=48) with EAX=(0x10=16=SYSCALL_WRITE) with EBX=(fd), ESI=(buf) and EDI=(length)
+     * 
+     * @param fd        STDOUT_FILENO or STDERR_FILENO
+     * @param buf       Bytes to write
+     * @param length    Bytes of the buffer
+     * @return int      Bytes written, -1 if the file descriptor is not supported or buf isn't in the process memory
+     */
+    int write(int fd, const char* buf, unsigned int length);
 }
 
 #endif
\ No newline at end of file
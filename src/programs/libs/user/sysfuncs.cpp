@@ -1,5 +1,6 @@
 // libc ---------------------------------------
 #include <stdarg.h>
+#include <stdbool.h>
 // kernel libs --------------------------------
 // stdlib
 #include "stdlib.h"
@@ -7,18 +8,32 @@
 // sys
 #include "sysfuncs.h"
 
-// -------------- SYSCALLS ARE DEFINED IN ./src/kernel/sys/syscalls.h ------------------
-#define SYSCALL_PRINT             1         // Print text on screen vga print("myText\n");
-#define SYSCALL_PROC_EXIT         2         // Called when a proccess finish it's execution. Remove from queue and move to the next proccess;
-#define SYSCALL_READLN            3         // Process wait until one line from console terminal is returned;
-#define SYSCALL_MALLOC            4         // Dynamic allocate memory in process heap.
-#define SYSCALL_FREE              5         // Dynamic free memory in process heap.
-#define SYSCALL_PSLIST            6         // Print process list in terminal.
-#define SYSCALL_EXEC_PROGRAM      7         // Executes a program
-#define SYSCALL_TERMINATE_PROCESS 8         // Executes a program
-#define SYSCALL_CLEAR_SCREEN      9         // Clears the text on screen equivalent to vga::clearScreen();
+// -------------- SYSCALLS ARE DEFINED IN ./src/kernel/sys/syscalls.def ------------------
+#include "syscall_numbers.h"
 
-#define PRINTF_STR_BUFFER_SIZE 1024
+/**
+ * @brief Text of printf waiting to be written to stdout
+ *
+ */
+typedef struct {
+    char* text;                         // STDOUT_BUFFER_SIZE chars in the process heap. The flat binary has no room for a
+                                        // big .bss, only the end of its last page is mapped
+    unsigned int size;                  // 0 when the buffer couldn't be allocated, printf writes each piece
+    unsigned int length;
+    bool newline;                       // A line was completed since the last flush
+} StdoutBuffer;
+
+/**
+ * @brief Instruction used to enter the kernel. Initialized by _start
+ * 
+ */
+unsigned int syscallMode;
+
+/**
+ * @brief Stdout buffer of printf. Initialized by _start
+ * 
+ */
+StdoutBuffer sysfuncsStdout;
 
 /**
  * @brief Access the main function of the executable process
@@ -31,94 +46,152 @@ extern "C" int main(int argc, char** argv);
  * 
  */
 extern "C" void _start() {
+    // Global vars are located in .bss section unitialized data. Must be initialized.
+    sysfuncsStdout.length = 0;
+    sysfuncsStdout.newline = false;
+    sysfuncs::setSyscallMode(sysfuncs::hasSysenter() ? SYSCALL_MODE_SYSENTER : SYSCALL_MODE_INT);
+    sysfuncsStdout.text = (char*) sysfuncs::malloc(STDOUT_BUFFER_SIZE);
+    sysfuncsStdout.size = sysfuncsStdout.text != NULL ? STDOUT_BUFFER_SIZE : 0;
     sysfuncs::exit(main(0, 0));
 }
 
-void sysfuncs::print(const char* str) { // Executes the interruption INT=(0x30=48) with EAX=(0x01=1=SYSCALL_PRINT) with ESI=(const char*=text_to_print)
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "mov %1, %%esi;"
-        "int $0x30;" 
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_PRINT), "r"(str)
-        : /* clobbers */ "eax", "esi"
-    );
-}
+/**
+ * @brief Enter the kernel with EAX=(syscall number), EBX, ESI and EDI arguments using the current syscall mode.
+ * 
+ *  SYSCALL_MODE_SYSENTER: The kernel resumes the process at the return address in EDX with the stack in ECX.
+ *  SYSCALL_MODE_INT:      Executes the interruption INT=(0x30=48).
+ * 
+ *  The stdout buffer is written before any other system call, so the text printed by the kernel or read by readln
+ *  comes after the text of printf, and nothing is lost on exit.
+ * 
+ * @return unsigned int EAX returned by the kernel
+ */
+unsigned int syscall(unsigned int number, unsigned int ebx, unsigned int esi, unsigned int edi) {
+    unsigned int ret;
+
+    if (number != SYSCALL_WRITE && sysfuncsStdout.length > 0) {
+        sysfuncs::flush();
+    }
 
-void sysfuncs::exit(int code) { // Executes the interruption INT=(0x30=48) with EAX=(0x02=2=SYSCALL_PROC_EXIT) and EBX=(code={0=SUCCESS or ERROR_CODE}) - Remove proccess from queue get the return code and move to the next proccess
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "mov %1, %%ebx;"
-        "int $0x30;" 
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_PROC_EXIT), "r"(code)
-        : /* clobbers */ "eax", "ebx"
-    );
+    if (syscallMode == SYSCALL_MODE_SYSENTER) {
+        __asm__ __volatile__ (
+            "mov %%esp, %%ecx;"
+            "movl $1f, %%edx;"
+            "sysenter;"
+            "1:"
+            : /* output */ "=a"(ret)
+            : /* input */ "a"(number), "b"(ebx), "S"(esi), "D"(edi)
+            : /* clobbers */ "ecx", "edx", "memory"
+        );
+    } else {
+        __asm__ __volatile__ (
+            "int $0x30;"
+            : /* output */ "=a"(ret)
+            : /* input */ "a"(number), "b"(ebx), "S"(esi), "D"(edi)
+            : /* clobbers */ "memory"
+        );
+    }
+    return ret;
 }
 
-void sysfuncs::printf(const char* str, ...) { // Format the string and redirects to print func
-    char fStr[PRINTF_STR_BUFFER_SIZE];
-    va_list list;
-    va_start(list, str);
-    stdlib::va_stringf(fStr, str, list);
-    va_end(list);
-    print(fStr);
+/**
+ * @brief Registers that hold the syscall arguments
+ * 
+ */
+typedef struct {
+    unsigned int ebx, esi, edi;
+} SyscallArgs;
+
+// Generate the sysfuncs functions defined in syscalls.def. Each argument is marshalled into the register defined for it.
+#define SYSCALL0(NUMBER, NAME, RET, FUNC) \
+    RET sysfuncs::FUNC() { \
+        return (RET) syscall(NUMBER, 0, 0, 0); \
+    }
+#define SYSCALL1(NUMBER, NAME, RET, FUNC, R1, T1, A1) \
+    RET sysfuncs::FUNC(T1 A1) { \
+        SyscallArgs args = {0, 0, 0}; \
+        args.R1 = (unsigned int) A1; \
+        return (RET) syscall(NUMBER, args.ebx, args.esi, args.edi); \
+    }
+#define SYSCALL2(NUMBER, NAME, RET, FUNC, R1, T1, A1, R2, T2, A2) \
+    RET sysfuncs::FUNC(T1 A1, T2 A2) { \
+        SyscallArgs args = {0, 0, 0}; \
+        args.R1 = (unsigned int) A1; \
+        args.R2 = (unsigned int) A2; \
+        return (RET) syscall(NUMBER, args.ebx, args.esi, args.edi); \
+    }
+#define SYSCALL3(NUMBER, NAME, RET, FUNC, R1, T1, A1, R2, T2, A2, R3, T3, A3) \
+    RET sysfuncs::FUNC(T1 A1, T2 A2, T3 A3) { \
+        SyscallArgs args = {0, 0, 0}; \
+        args.R1 = (unsigned int) A1; \
+        args.R2 = (unsigned int) A2; \
+        args.R3 = (unsigned int) A3; \
+        return (RET) syscall(NUMBER, args.ebx, args.esi, args.edi); \
+    }
+#include "syscalls.def"
+#undef SYSCALL0
+#undef SYSCALL1
+#undef SYSCALL2
+#undef SYSCALL3
+
+bool sysfuncs::hasSysenter() { // CPUID EAX=1 - EDX Bit 11 = SEP
+    unsigned int eax, ebx, ecx, edx;
+    __asm__ __volatile__ ("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(1));
+
+    if (((edx >> 11) & 0x1) == 0) {
+        return false;
+    }
+
+    // Pentium Pro processors (Family 6, Model < 3, Stepping < 3) report SEP but don't support the instructions
+    return !(((eax >> 8) & 0xF) == 6 && ((eax >> 4) & 0xF) < 3 && (eax & 0xF) < 3);
 }
 
-void sysfuncs::readln(char* dest) { // Executes the interruption INT=(0x30=48) with EAX=(0x03=3=SYSCALL_READLN) with no parameters(E.g The process scheduler already knows wich process is running)
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "mov %1, %%edi;"
-        "int $0x30;" 
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_READLN), "r"(dest)
-        : /* clobbers */ "eax", "edi"
-    );
+void sysfuncs::setSyscallMode(unsigned int mode) {
+    syscallMode = mode;
 }
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wreturn-type" // (-Wreturn-type) Disable no return type warning
-
-unsigned int sysfuncs::malloc(unsigned int size) { // Executes the interruption INT=(0x30=48) with EAX=(0x04=4=SYSCALL_MALLOC) with EBX=(unsigned int = sizeOf memory being allocated) returns EAX=(Start address of the allocated memory block or 0 if fails)
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "mov %1, %%ebx;"
-        "int $0x30;"
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_MALLOC), "r"(size)
-        : /* clobbers */ "eax", "ebx"
-    );
+unsigned int sysfuncs::getSyscallMode() {
+    return syscallMode;
 }
 
-#pragma GCC diagnostic pop // (-Wreturn-type) Enable no return type warning
-
-void sysfuncs::free(void* ptr) { // Executes the interruption INT=(0x30=48) with EAX=(0x05=5=SYSCALL_FREE) with EBX=(unsigned int = ptr address of the heap dynamic memory block to be free)
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "mov %1, %%ebx;"
-        "int $0x30;"
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_FREE), "r"(ptr)
-        : /* clobbers */ "eax", "ebx"
-    );
+void sysfuncs::flush() {
+    if (sysfuncsStdout.length > 0) {
+        write(STDOUT_FILENO, sysfuncsStdout.text, sysfuncsStdout.length);
+        sysfuncsStdout.length = 0;
+    }
+    sysfuncsStdout.newline = false;
 }
 
-void sysfuncs::printProcessList() { // Executes the interruption INT=(0x30=48) with EAX=(0x02=2=SYSCALL_PROC_EXIT)
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "int $0x30;" 
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_PSLIST)
-        : /* clobbers */ "eax"
-    );
+/**
+ * @brief Sink of printf. Appends the formatted text to the stdout buffer and writes it each time the buffer is full.
+ *
+ * @param context   StdoutBuffer
+ * @param text      Piece of the formatted text
+ * @param length    Chars of the piece
+ */
+void printfSink(void* context, const char* text, uint32_t length) {
+    StdoutBuffer* out = (StdoutBuffer*) context;
+    uint32_t i;
+
+    if (out->size == 0) {               // No buffer
+        sysfuncs::write(STDOUT_FILENO, text, length);
+        return;
+    }
+    for (i = 0; i < length; i++) {
+        if (out->length == out->size) {
+            sysfuncs::flush();
+        }
+        out->text[out->length++] = text[i];
+        out->newline = out->newline || text[i] == '\n';
+    }
 }
 
-void sysfuncs::clearScreen() {
-    __asm__ __volatile__ (
-        "mov %0, %%eax;"
-        "int $0x30;" 
-        : /* output */ 
-        : /* input */ "r"(SYSCALL_CLEAR_SCREEN)
-        : /* clobbers */ "eax"
-    );
-}
\ No newline at end of file
+void sysfuncs::printf(const char* str, ...) { // Format the string in the stdout buffer, line buffered
+    va_list list;
+    va_start(list, str);
+    stdlib::va_formatf(printfSink, &sysfuncsStdout, str, list);
+    va_end(list);
+    if (sysfuncsStdout.newline) {
+        flush();
+    }
+}
@@ -2,6 +2,27 @@
 #ifndef _SYSFUNCS_H_
 #define _SYSFUNCS_H_
 
+// libc
+#include <stdbool.h>
+
+#define SYSCALL_MODE_INT      0     // Enter the kernel with the interruption INT=(0x30=48)
+#define SYSCALL_MODE_SYSENTER 1     // Enter the kernel with the SYSENTER fast system call instruction
+
+#define CLOCK_MONOTONIC       1     // Time since boot, never goes backwards
+
+#define STDOUT_FILENO         1     // File descriptors of write, both are the console of the process. Same as src/kernel/sys/syscalls.h
+#define STDERR_FILENO         2
+#define STDOUT_BUFFER_SIZE    1024  // Text kept by printf before it's written with a single system call
+
+/**
+ * @brief Time split in seconds and nanoseconds. Same layout as the kernel Timespec (src/kernel/sys/clock.h)
+ * 
+ */
+typedef struct {
+    unsigned int tv_sec;            // Seconds
+    unsigned int tv_nsec;           // Nanoseconds, 0 to 999999999
+} Timespec;
+
 extern "C" void __attribute__((section("._start"))) _start();
 
 namespace sysfuncs {
@@ -12,8 +33,9 @@ namespace sysfuncs {
      * 
      *  ESCAPE_SEQUENCES: 
      *    - \n Line feed or new line
+     *    - ESC[ (\033[) ANSI CSI sequences, see src/kernel/drivers/legacy/vga.h
      * 
-     *  MAX_TEXT_SIZE: 1024 chars long
+     *  The text is read by the kernel until its null char, it has no maximum size.
      * 
      */
     void print(const char *str);
@@ -30,7 +52,8 @@ namespace sysfuncs {
     /**
      * @brief Prints a formatted string text with unlimited arguments
      * 
-     * Executes the interruption INT=(0x30=48) with EAX=(0x01=1=SYSCALL_PRINT) with ESI=(const char*=text_to_print)
+     * The text is kept in the stdout buffer and written with SYSCALL_WRITE when a line is complete, when the buffer is
+     * full, before any other system call (so the output keeps its order, E.g before readln) and on exit.
      * 
      *  FORMATS_SUPPORTED:
      *    - %s  -> Put the char* text from a argument variable in formatted string.
@@ -94,6 +117,88 @@ namespace sysfuncs {
      * 
      */
     void clearScreen();
+
+    /**
+     * @brief System call that does nothing. Used to measure the cost of entering and leaving the kernel.
+     * 
+     */
+    void nullSyscall();
+
+    /**
+     * @brief Block this process for the given time. Other processes are executed meanwhile.
+     * 
+     * @param millis Milliseconds to sleep
+     */
+    void sleep(unsigned int millis);
+
+    /**
+     * @brief Get the time of a clock with nanoseconds resolution. The kernel measures it with the TSC calibrated against the PIT.
+     * 
+     * @param clockId   CLOCK_MONOTONIC
+     * @param ts        Filled with the time
+     * @return int      0 on success, -1 if the clock is not supported or ts isn't in the process memory
+     */
+    int clockGettime(unsigned int clockId, Timespec* ts);
+
+    /**
+     * @brief Print the contention counters of the kernel locks: acquisitions, acquisitions that had to wait and waits
+     * 
+     */
+    void printLockStats();
+
+    /**
+     * @brief Print the counters of each IRQ: interruptions, the ones since the last call, spurious IRQ7/IRQ15,
+     *        handler cycles with their histogram, and the longest interruptions-off time of each cpu
+     * 
+     */
+    void printIrqStats();
+
+    /**
+     * @brief Print the kernel log kept in the ring buffer, each line with its time since boot [seconds.microseconds]
+     * 
+     */
+    void printKernelLog();
+
+    /**
+     * @brief Return whether the cpu supports the SYSENTER and SYSEXIT instructions or not
+     * 
+     * @return true  SYSENTER can be used
+     * @return false Only INT=(0x30=48) can be used
+     */
+    bool hasSysenter();
+
+    /**
+     * @brief Change the instruction used by the next system calls.
+     *        The process starts with SYSCALL_MODE_SYSENTER when supported.
+     * 
+     * @param mode SYSCALL_MODE_INT or SYSCALL_MODE_SYSENTER
+     */
+    void setSyscallMode(unsigned int mode);
+
+    /**
+     * @brief Get the instruction used by the system calls
+     * 
+     * @return unsigned int SYSCALL_MODE_INT or SYSCALL_MODE_SYSENTER
+     */
+    unsigned int getSyscallMode();
+
+    /**
+     * @brief Write a buffer to a file descriptor, the null chars are written too. Not buffered, see flush.
+     * 
+     * Executes the system call EAX=(0x10=16=SYSCALL_WRITE) with EBX=(fd), ESI=(buf) and EDI=(length)
+     * 
+     * @param fd        STDOUT_FILENO or STDERR_FILENO
+     * @param buf       Bytes to write
+     * @param length    Bytes of the buffer
+     * @return int      Bytes written, -1 if the file descriptor is not supported or buf isn't in the process memory
+     */
+    int write(int fd, const char* buf, unsigned int length);
+
+    /**
+     * @brief Write the text kept in the stdout buffer by printf
+     * 
+     */
+    void flush();
 }
 
 #endif
\ No newline at end of file
@@ -1,9 +1,57 @@
 #include <stdbool.h>
+#include <stdint.h>
 #include "sysfuncs.h"
 #include "string.h"
+#include "stdlib.h"
 
 using namespace sysfuncs;
 
+#define BENCH_SYSCALL_ITERATIONS 10000 // Null syscalls executed by each bench round
+#define BENCH_SYSCALL_ROUNDS 8          // Rounds of each bench measurement, the fastest one is kept
+#define SMPBENCH_DEFAULT_WORKERS 4      // spin.exe copies started by smpbench without argument
+
+/**
+ * @brief Read the cpu time stamp counter
+ * 
+ * @return uint64_t Cycles counter
+ */
+uint64_t readTsc() {
+    unsigned int low, high;
+    __asm__ __volatile__ ("rdtsc" : "=a"(low), "=d"(high));
+    return ((uint64_t) high << 32) | low;
+}
+
+/**
+ * @brief Measure the average cost in cycles of a null syscall using the given kernel entry instruction.
+ *        Both instructions reach the same handler, which returns directly to the caller when no other process is ready,
+ *        so only the entry and exit cost differs. The fastest round is kept, the others were slowed down by the timer
+ *        interruptions or by the other ready processes.
+ * 
+ * @param mode SYSCALL_MODE_INT or SYSCALL_MODE_SYSENTER
+ * @return unsigned int Cycles per syscall
+ */
+unsigned int benchNullSyscall(unsigned int mode) {
+    unsigned int i;
+    unsigned int round;
+    uint64_t start;
+    uint64_t cycles;
+    uint64_t best = 0;
+
+    setSyscallMode(mode);
+    nullSyscall();                      // Flush the stdout buffer and warm up the entry path before the measurement
+    for (round = 0; round < BENCH_SYSCALL_ROUNDS; round++) {
+        start = readTsc();
+        for (i = 0; i < BENCH_SYSCALL_ITERATIONS; i++) {
+            nullSyscall();
+        }
+        cycles = readTsc() - start;
+        if (round == 0 || cycles < best) {
+            best = cycles;
+        }
+    }
+    return (unsigned int) stdlib::udiv64(best, BENCH_SYSCALL_ITERATIONS, NULL);
+}
+
 int main() {
     char* cmd = (char*) malloc(256);    // Max keyboard.h buffer is 256 so we set buffer to its max value.
     char* cmdArg = (char*) malloc(256); 
@@ -16,8 +64,8 @@ int main() {
     while(true) {
         argOffset = 0;
         eocLineBreak = true;
-        // Move this process to waiting keyboard queue and wait until a keyboard ENTER key is pressed
-        // then move this process to the ready queue and wait until it is executed again.
+        // This process is blocked inside the kernel until a keyboard ENTER key is pressed,
+        // then the line is copied to cmd and this process continues its execution.
         readln(cmd);
 
         // Get first argument from command
@@ -31,14 +79,58 @@ int main() {
                 continue;
             }
         } if (string::strcmp(cmdArg, "clear") == 0) {       // VGA - Clear screen content
-            clearScreen();
+            printf("\033[2J\033[H");                        // Erase the screen, cursor at the top left corner
+            eocLineBreak = false;
+        } else if (string::strcmp(cmdArg, "bench") == 0) {  // BENCH - Null syscall cost of each kernel entry instruction
+            unsigned int syscallMode = getSyscallMode();
+            printf("null syscall - int 0x30: %d cycles\n", benchNullSyscall(SYSCALL_MODE_INT));
+            if (hasSysenter()) {
+                printf("null syscall - sysenter: %d cycles", benchNullSyscall(SYSCALL_MODE_SYSENTER));
+            } else {
+                printf("null syscall - sysenter: not supported");
+            }
+            setSyscallMode(syscallMode);
+        } else if (string::strcmp(cmdArg, "sleep") == 0) {  // SLEEP - Block this process for the given milliseconds
+            string::readNextArg(cmd, argOffset, cmdArg, &argOffset);
+            sleep(stdlib::atoi(cmdArg));
             eocLineBreak = false;
+        } else if (string::strcmp(cmdArg, "uptime") == 0) { // UPTIME - Time since boot from the monotonic clock
+            Timespec ts;
+            clockGettime(CLOCK_MONOTONIC, &ts);
+            printf("uptime: %d s %d us", ts.tv_sec, ts.tv_nsec / 1000);
+        } else if (string::strcmp(cmdArg, "locks") == 0) {  // LOCKS - Contention counters of the kernel locks
+            printLockStats();
+        } else if (string::strcmp(cmdArg, "irqs") == 0) {   // IRQS - Interruption counters and handler cycles
+            printIrqStats();
+        } else if (string::strcmp(cmdArg, "dmesg") == 0) {  // DMESG - Kernel log with the timestamps
+            printKernelLog();
+        } else if (string::strcmp(cmdArg, "smpbench") == 0) {   // SMPBENCH - Run CPU bound workers at the same time
+            Timespec ts;
+            int workers;
+            int i;
+            string::readNextArg(cmd, argOffset, cmdArg, &argOffset);
+            workers = cmdArg[0] != '\0' ? stdlib::atoi(cmdArg) : SMPBENCH_DEFAULT_WORKERS;
+            clockGettime(CLOCK_MONOTONIC, &ts);
+            printf("smpbench: %d workers started at %d ms", workers, ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+            for (i = 0; i < workers; i++) {
+                if (execv("spin.exe", 0, 0) == 0) {
+                    printf("\nsmpbench: spin.exe not started");
+                    break;
+                }
+            }
         } else if (string::strcmp(cmdArg, "help") == 0) {   // HELP - Show all available commands
             printf("----------- COMMANDS -----------\n");
             printf("help  - Show information about the available commands;\n");
             printf("ps    - Process Commands;\n");
             printf("   list - List all processes running;");
-            printf("clear - Wipe text on the screen, also reset the cursor position;");
+            printf("clear - Wipe text on the screen, also reset the cursor position;\n");
+            printf("bench - Measure the null system call cost of int 0x30 and sysenter;\n");
+            printf("sleep - Sleep the given milliseconds. E.g: sleep 1000;\n");
+            printf("uptime - Show the time since boot;\n");
+            printf("smpbench - Run CPU bound workers on all cpus. E.g: smpbench 4;\n");
+            printf("locks - Show the contention counters of the kernel locks;\n");
+            printf("irqs  - Show the counters, handler cycles and spurious interruptions of each IRQ;\n");
+            printf("dmesg - Show the kernel log with the time of each message;");
         } else {
             printf("\"%s\" command not found.", cmd);
         }
@@ -53,42 +145,3 @@ int main() {
 
     return 1;
 }
-
-/*
- *   - \033 - (ESC) Escape Sequences:
- *         - [0 - Clear vga screen and set cursor to position col:0, row:0;
- *         - [1 - Set cursor position (E.q: setCursorPosition(col, row));
- *             - [00[00 - 1º Column, 2º Row
- */
-/*
-if (*str == '\033') { // Terminal Escape sequence
-    str++;
-    if (*str == '[') { // Indicates that now a scape function will begin
-        str++;
-        if (*str == '0') { // CLEAR_SCREEN(0) - Escape function number
-            str++;
-            clearScreen(foreColor, bgColor, false);
-            // Reset vga memory offset
-            cursorOffset = 0;
-            video = (volatile uint16_t*) vgaAddress + cursorOffset;
-        } else if (*str == '1') { // SET_CURSOR_POSITION(1) - Escape function number
-            str++;
-            int col = 0;
-            int row = 0;
-            for (i=0; i<2 && str[0] != '\0' && str[1] >= '0' && str[1] <= '9' && str[2] >= '0' && str[2] <= '9'; i++) {
-                if (*str++ == '[') {
-                    tmpBuff[0] = *str++;
-                    tmpBuff[1] = *str++;
-                    tmpBuff[2] = '\0';
-                    (i == 0 ? col : row) = stdlib::atoi(tmpBuff);
-                }
-            }
-            // Set cursor position
-            setCursorPosition(col, row);
-            // Reset vga memory offset
-            cursorOffset = GET_SCREEN_OFFSET_POS(col, row);
-            video = (volatile uint16_t*) vgaAddress + cursorOffset;
-        }
-    }
-}
-*/
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "sysfuncs.h"
+
+using namespace sysfuncs;
+
+#define SPIN_ITERATIONS 50000000 // Fixed amount of work, the same on every run
+
+/**
+ * @brief Read the monotonic clock
+ * 
+ * @return unsigned int Milliseconds since boot
+ */
+unsigned int nowMs() {
+    Timespec ts;
+    clockGettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief CPU bound benchmark worker. Started by the shell smpbench command, several copies run at the same time.
+ *        With N workers and N cpus the elapsed time of each worker is about the time of a single worker,
+ *        with one cpu the workers share it and each one takes about N times longer.
+ * 
+ */
+int main() {
+    unsigned int i;
+    unsigned int x = 2463534242u;  // xorshift state, the result is printed so the loop isn't removed by the compiler
+    unsigned int start = nowMs();
+
+    for (i = 0; i < SPIN_ITERATIONS; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+
+    unsigned int end = nowMs();
+    printf("spin: start %d ms, end %d ms, elapsed %d ms (%x)\n", start, end, end - start, x);
+    return 0;
+}